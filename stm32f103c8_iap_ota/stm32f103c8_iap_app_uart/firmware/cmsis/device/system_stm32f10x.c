@@ -125,7 +125,7 @@
 /*!< Uncomment the following line if you need to relocate your vector Table in
      Internal SRAM. */ 
 /* #define VECT_TAB_SRAM */
-#define VECT_TAB_OFFSET  0x6000 /*!< Vector Table base offset field. 
+#define VECT_TAB_OFFSET  0x8000 /*!< Vector Table base offset field. 
                                   This value must be a multiple of 0x200. */
 
 
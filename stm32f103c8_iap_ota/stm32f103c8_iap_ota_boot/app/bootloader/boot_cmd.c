@@ -4,7 +4,10 @@
 #include "boot_core.h"
 #include "boot_flash.h"
 #include "boot_xmodem.h"
+#include "boot_ymodem.h"
+#include "boot_stream.h"
 #include "boot_store.h"
+#include "boot_baud.h"
 #include "log.h"
 
 /**
@@ -23,7 +26,6 @@ static int boot_cmd_erase_app(void)
 static int boot_cmd_start_iap_download(void)
 {
     log_info("IAP download firmware to Flash.");
-    boot_flash_erase_app();
     log_info("Use Xmodem to download a BIN file to Flash.");
 
     boot_set_flag(BOOT_FLAG_IAP_XMODEM_SEND_C);
@@ -46,6 +48,79 @@ static int boot_cmd_start_iap_download_ext(void)
     return 0;
 }
 
+/**
+ * @brief   IAP 开始使用 Ymodem 下载程序到内部 Flash
+ * @return	0 表示成功，其他值表示失败
+ */
+static int boot_cmd_start_iap_download_ymodem(void)
+{
+    log_info("IAP download firmware to Flash.");
+    log_info("Use Ymodem to download a BIN file to Flash.");
+
+    boot_set_flag(BOOT_FLAG_IAP_YMODEM_SEND_C);
+    boot_set_flag(BOOT_FLAG_IAP_YMODEM_RECV_DATA);
+
+    boot_ymodem_init();
+    return 0;
+}
+
+/**
+ * @brief   IAP 开始使用 Ymodem 下载程序到外部 Flash，支持一次传输多个文件到连续槽位
+ * @return	0 表示成功，其他值表示失败
+ */
+static int boot_cmd_start_iap_download_ext_ymodem(void)
+{
+    log_info("IAP download firmware to External Flash, please enter the first firmware location (1-%d).", 
+             BOOT_EXT_FLASH_APP_SLOT_COUNT - 1);
+
+    boot_set_flag(BOOT_FLAG_EXT_DOWNLOAD_REQUEST);
+    boot_set_flag(BOOT_FLAG_EXT_DOWNLOAD_YMODEM);
+    return 0;
+}
+
+/**
+ * @brief   IAP 开始使用流式传输协议下载程序到内部 Flash
+ * @return	0 表示成功，其他值表示失败
+ */
+static int boot_cmd_start_iap_download_stream(void)
+{
+    log_info("IAP download firmware to Flash.");
+    log_info("Use stream protocol to download a BIN file to Flash (window=%d).", BOOT_STREAM_WINDOW);
+
+    boot_set_flag(BOOT_FLAG_IAP_STREAM_RECV_DATA);
+
+    boot_stream_init();
+    return 0;
+}
+
+/**
+ * @brief   IAP 开始使用流式传输协议下载程序到外部 Flash
+ * @return	0 表示成功，其他值表示失败
+ */
+static int boot_cmd_start_iap_download_ext_stream(void)
+{
+    log_info("IAP download firmware to External Flash, please enter the firmware location (1-%d).", 
+             BOOT_EXT_FLASH_APP_SLOT_COUNT - 1);
+
+    boot_set_flag(BOOT_FLAG_EXT_DOWNLOAD_REQUEST);
+    boot_set_flag(BOOT_FLAG_EXT_DOWNLOAD_STREAM);
+    return 0;
+}
+
+/**
+ * @brief   切换串口波特率，用于加快之后的下载
+ * @details 下载会话结束后自动恢复默认波特率
+ * @return	0 表示成功，其他值表示失败
+ */
+static int boot_cmd_switch_baudrate(void)
+{
+    log_info("Switch baud rate for the next download, please enter the baud rate (max %d).",
+             BOOT_BAUD_MAX);
+
+    boot_set_flag(BOOT_FLAG_BAUD_REQUEST);
+    return 0;
+}
+
 /**
  * @brief   从外部 Flash 加载固件
  * @return	0 表示成功，其他值表示失败
@@ -106,15 +181,33 @@ static int boot_cmd_system_reset(void)
 }
 
 static const boot_menu_item_t menu_items[] = {
-    { "Erase APP partition"                     , boot_cmd_erase_app              },
-    { "IAP: Download firmware to Internal Flash", boot_cmd_start_iap_download     },
-    { "IAP: Download firmware to External Flash", boot_cmd_start_iap_download_ext },
-    { "Load firmware from External Flash"       , boot_cmd_load_from_ext          },
-    { "Init OTA version"                        , boot_cmd_ota_version_init       },
-    { "Check OTA version"                       , boot_cmd_check_ota_version      },
-    { "System restart"                          , boot_cmd_system_reset           }
+    { "Erase APP partition"                     , boot_cmd_erase_app                     },
+    { "IAP: Download firmware to Internal Flash", boot_cmd_start_iap_download            },
+    { "IAP: Download firmware to External Flash", boot_cmd_start_iap_download_ext        },
+    { "Load firmware from External Flash"       , boot_cmd_load_from_ext                 },
+    { "Init OTA version"                        , boot_cmd_ota_version_init              },
+    { "Check OTA version"                       , boot_cmd_check_ota_version             },
+    { "System restart"                          , boot_cmd_system_reset                  },
+    /* 新增的菜单项只追加在末尾，不改变已有命令的编号 */
+    { "IAP: Ymodem download to Internal Flash"  , boot_cmd_start_iap_download_ymodem     },
+    { "IAP: Ymodem download to External Flash"  , boot_cmd_start_iap_download_ext_ymodem },
+    { "IAP: Stream download to Internal Flash"  , boot_cmd_start_iap_download_stream     },
+    { "IAP: Stream download to External Flash"  , boot_cmd_start_iap_download_ext_stream },
+    { "Switch baud rate for download"           , boot_cmd_switch_baudrate               }
 };
 
+/**
+ * @brief   菜单项对应的按键
+ * @details 前 9 项用数字 1-9，之后的菜单项用字母 a、b、c...，每个命令都是单个按键，
+ *          逐个发送按键的终端不会在输入第二位数字前误执行第 1 项
+ * @param[in] idx 菜单项索引
+ * @return  按键字符
+ */
+static char boot_cmd_key(uint32_t idx)
+{
+    return idx < 9 ? '1' + idx : 'a' + (idx - 9);
+}
+
 /**
  * @brief   BootLoader 打印菜单信息
  */
@@ -125,7 +218,7 @@ void boot_cmd_print_menu(void)
     log_info("================================================");
 
     for (uint8_t i = 0; i < sizeof(menu_items) / sizeof(menu_items[0]); i++)
-        log_info("[%d] %-30s", i + 1, menu_items[i].desc);
+        log_info("[%c] %-30s", boot_cmd_key(i), menu_items[i].desc);
 
     log_info("================================================");
 }
@@ -138,13 +231,23 @@ void boot_cmd_print_menu(void)
 void boot_handle_cmd(uint8_t *data, uint32_t len)
 {
     int ret;
+    uint8_t cmd;
 
     if (len != 1) {
         log_warn("Invalid input length: %d", len);
         return;
     }
 
-    uint8_t cmd = data[0] - '1'; // 输入 '1' -> 索引 0
+    /* 输入 '1' -> 索引 0，输入 'a'（或 'A'）-> 索引 9 */
+    if (data[0] >= '1' && data[0] <= '9')
+        cmd = data[0] - '1';
+    else if (data[0] >= 'a' && data[0] <= 'z')
+        cmd = data[0] - 'a' + 9;
+    else if (data[0] >= 'A' && data[0] <= 'Z')
+        cmd = data[0] - 'A' + 9;
+    else
+        cmd = 0xFF;
+
     if (cmd >= sizeof(menu_items)/sizeof(menu_items[0])) {
         log_warn("Invalid command: %c", data[0]);
         return;
@@ -153,8 +256,8 @@ void boot_handle_cmd(uint8_t *data, uint32_t len)
     if (menu_items[cmd].handler) {
         ret = menu_items[cmd].handler();
         if (ret != 0)
-            log_error("Command [%c] execute failed (err=%d)", data[0], ret);
+            log_error("Command [%c] execute failed (err=%d)", boot_cmd_key(cmd), ret);
     } else {
-        log_error("Command [%c] has no handler", data[0]);
+        log_error("Command [%c] has no handler", boot_cmd_key(cmd));
     }
 }
@@ -3,8 +3,12 @@
 #include "boot_comm.h"
 #include "boot_cmd.h"
 #include "boot_xmodem.h"
+#include "boot_ymodem.h"
+#include "boot_stream.h"
 #include "boot_ext_flash.h"
+#include "boot_update.h"
 #include "boot_ota.h"
+#include "boot_baud.h"
 #include "log.h"
 
 #ifndef ARRAY_SIZE
@@ -19,12 +23,17 @@ typedef struct boot_event_handler {
 
 /* 事件处理表 */
 static const boot_event_handler_t boot_handlers[] = {
-    { BOOT_FLAG_IAP_XMODEM_SEND_C,    boot_xmodem_send_c,  NULL                            },
-    { BOOT_FLAG_EXT_LOAD,             boot_ext_flash_load, NULL                            },
-    { BOOT_FLAG_IAP_XMODEM_RECV_DATA, NULL,                boot_xmodem_recv_data           },
-    { BOOT_FLAG_EXT_DOWNLOAD_REQUEST, NULL,                boot_ext_flash_download_request },
-    { BOOT_FLAG_EXT_LOAD_REQUEST,     NULL,                boot_ext_flash_load_request     },
-    { BOOT_FLAG_OTA_VERSION_INIT,     NULL,                boot_ota_version_init           }
+    { BOOT_FLAG_IAP_XMODEM_SEND_C,    boot_xmodem_send_c,     NULL                            },
+    { BOOT_FLAG_IAP_YMODEM_SEND_C,    boot_ymodem_send_c,     NULL                            },
+    { BOOT_FLAG_EXT_LOAD,             boot_ext_flash_load,    NULL                            },
+    { BOOT_FLAG_IAP_XMODEM_RECV_DATA, boot_update_poll,       boot_xmodem_recv_data           },
+    { BOOT_FLAG_IAP_YMODEM_RECV_DATA, boot_update_poll,       boot_ymodem_recv_data           },
+    { BOOT_FLAG_IAP_STREAM_RECV_DATA, boot_update_poll,       boot_stream_recv_data           },
+    { BOOT_FLAG_EXT_DOWNLOAD_REQUEST, NULL,                   boot_ext_flash_download_request },
+    { BOOT_FLAG_EXT_LOAD_REQUEST,     NULL,                   boot_ext_flash_load_request     },
+    { BOOT_FLAG_OTA_VERSION_INIT,     NULL,                   boot_ota_version_init           },
+    { BOOT_FLAG_BAUD_REQUEST,         NULL,                   boot_baud_request               },
+    { BOOT_FLAG_BAUD_CONFIRM,         boot_baud_confirm_poll, boot_baud_confirm               }
 };
 
 /**
@@ -4,6 +4,26 @@
 #include <stdint.h>
 #include "bsp_flash.h"
 
+#ifndef EIO
+#define EIO 8
+#endif
+
+#ifndef EINVAL
+#define EINVAL 22
+#endif
+
+/**
+ * @brief   读取 Flash 容量和页大小，建立运行时几何信息，启动时调用一次
+ * @return	0 表示成功，其他值表示失败（保留编译时的缺省器件）
+ */
+int boot_flash_geometry_init(void);
+
+/**
+ * @brief   获取 A 区字节数（按实际器件容量）
+ * @return  A 区字节数
+ */
+uint32_t boot_flash_get_app_size(void);
+
 /**
  * @brief   擦除 Flash APP 程序
  * @return	0 表示成功，其他值表示失败
@@ -18,4 +38,55 @@ int boot_flash_erase_app(void);
  */
 int boot_flash_write_chunk(bsp_flash_t *flash, uint32_t chunk_idx);
 
+/**
+ * @brief   获取地址所在的页/扇区编号，编号相同的地址在同一次擦除中一起擦除
+ * @param[in] addr Flash 地址
+ * @return  页/扇区编号
+ */
+uint16_t boot_flash_get_unit_index(uint32_t addr);
+
+/**
+ * @brief   开始按需擦除 APP 区，之后由 boot_flash_program 在写入前擦除数据所在的页/扇区
+ */
+void boot_flash_erase_begin(void);
+
+/**
+ * @brief   从断点继续下载：APP 区前 size 字节已经写入，覆盖它们的页/扇区不再擦除
+ * @param[in] size 已写入的字节数
+ */
+void boot_flash_resume(uint32_t size);
+
+/**
+ * @brief   按固件大小规划擦除，只处理覆盖 APP 区前 size 字节的页/扇区，日志中给出预计擦除时间
+ * @details F4 在此一次擦除需要的扇区，F1/GD32 仍在写入时按页擦除
+ * @param[in] flash 指向内部 Flash BSP 对象的指针
+ * @param[in] size  固件字节数
+ * @return	0 表示成功，其他值表示失败
+ */
+int boot_flash_erase_plan(bsp_flash_t *flash, uint32_t size);
+
+/**
+ * @brief   将数据写入 APP 区，写入前按需擦除，内容与 Flash 现有数据相同时跳过
+ * @param[in] flash 指向内部 Flash BSP 对象的指针
+ * @param[in] addr  写入起始地址（4 字节对齐）
+ * @param[in] len   写入字节数（4 的倍数）
+ * @param[in] data  要写入的数据
+ * @return	0 表示成功，其他值表示失败
+ */
+int boot_flash_program(bsp_flash_t *flash, uint32_t addr, uint32_t len, const uint8_t *data);
+
+/**
+ * @brief   获取本次下载中与 Flash 内容相同、跳过写入的数据块数
+ * @return  跳过的数据块数
+ */
+uint32_t boot_flash_get_skipped(void);
+
+/**
+ * @brief   用硬件 CRC 校验 APP 区中的整个固件，与数据来源给出的整个固件的 CRC 比较
+ * @param[in] size 固件字节数
+ * @param[in] crc  整个固件的 CRC32，按 boot_crc32_word 的方式计算（尾部补 0xFF 到 4 字节）
+ * @return	0 表示成功，-EIO 表示 Flash 内容与固件不一致
+ */
+int boot_flash_verify(uint32_t size, uint32_t crc);
+
 #endif
@@ -0,0 +1,552 @@
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include "bsp_flash.h"
+#include "bsp_ext_flash.h"
+#include "boot_config.h"
+#include "boot_core.h"
+#include "boot_flash.h"
+#include "boot_ext_flash.h"
+#include "boot_crc.h"
+#include "boot_store.h"
+#include "boot_update.h"
+#include "log.h"
+
+/* update_chunk 缓冲区中已填满、尚未写入 Flash 的数据块 */
+typedef struct {
+    bool     pending;               // 是否等待写入 Flash
+    uint32_t chunk_idx;             // 数据块索引
+    uint32_t len;                   // 数据块有效字节数
+} boot_update_slot_t;
+
+typedef struct {
+    boot_update_target_t target;    // 写入目标
+    uint32_t recv_bytes;            // 已接收的字节数（按块写入时为已写入的最大偏移）
+    uint32_t tail_len;              // 顺序写入时，最后一个未填满的数据块内的字节数
+    boot_update_slot_t slot[BOOT_APP_UPDATE_CHUNK_NUM];    // 每个 update_chunk 缓冲区中待写入的数据块
+    bool     chunk_writing;         // writing_slot 中的数据块正在后台写入外部 Flash
+    uint8_t  writing_slot;          // 正在后台写入外部 Flash 的缓冲区
+    int      err;                   // 第一次写 Flash 失败的错误码
+    uint8_t  slot_idx;              // 写入外部 Flash 时的槽位
+    uint32_t file_size;             // 固件字节数，0 表示不记录断点
+    uint32_t image_size;            // 开始时给出的固件字节数，0 表示未知，用于最后校验
+    bool     chunk_at;              // 本次数据流按块索引写入
+    uint32_t committed;             // 从头开始连续写入 Flash 的完整数据块数
+    uint32_t ahead;                 // bit i 表示块 committed + i 已写入 Flash（乱序写入时）
+    uint32_t saved_cnt;             // 断点记录中的数据块数
+    uint32_t saved_crc;             // 断点记录中前 saved_cnt 个数据块的 CRC32
+    uint32_t data_crc;              // 顺序写入时，收到的数据拷贝进 update_chunk 之前累计的 CRC（boot_crc32_word）
+    uint8_t  crc_carry[4];          // 累计 CRC 时不足一个字、留到下次的字节
+    uint8_t  crc_carry_len;         // crc_carry 中的字节数
+    bool     image_crc_set;         // 数据来源给出了整个固件的 CRC
+    uint32_t image_crc;             // 数据来源给出的整个固件的 CRC（boot_crc32_word）
+} boot_update_ctx_t;
+
+static boot_update_ctx_t boot_update_ctx;
+
+/**
+ * @brief   将 update_chunk 写入内/外部 Flash
+ * @param[in] chunk_idx update_chunk 的块索引（从 0 开始）
+ * @param[in] len       chunk 内的有效字节数
+ * @return  0 表示成功，其他值表示失败
+ */
+static int boot_update_write_chunk(uint32_t chunk_idx, uint32_t len)
+{
+    bsp_flash_t *flash = bsp_flash_get();
+    bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
+    uint8_t *update_chunk = boot_get_update_chunk(chunk_idx);
+    uint32_t addr;
+
+    if (boot_update_ctx.target == BOOT_UPDATE_TARGET_EXT_FLASH)
+        return boot_ext_flash_write_chunk(ext_flash, chunk_idx, len);
+
+    if (len == BOOT_APP_UPDATE_CHUNK_SIZE)
+        return boot_flash_write_chunk(flash, chunk_idx);
+
+    /* 内部 Flash 只写有效字节，按字写入，不足 4 字节的尾部补 0xFF（与擦除值一致） */
+    while (len % 4 != 0)
+        update_chunk[len++] = 0xFF;
+
+    addr = BOOT_FLASH_APP_START_ADDR + chunk_idx * BOOT_APP_UPDATE_CHUNK_SIZE;
+    return boot_flash_program(flash, addr, len, update_chunk);
+}
+
+/**
+ * @brief   计算写入目标中一段已写入数据的 CRC32/MPEG-2
+ * @param[in] offset 相对 APP 起始地址（或槽位起始地址）的偏移
+ * @param[in] len    字节数
+ * @param[in] crc    CRC 初值（续算时传入上一段的结果）
+ * @return  CRC32 值
+ */
+static uint32_t boot_update_calc_crc(uint32_t offset, uint32_t len, uint32_t crc)
+{
+    if (boot_update_ctx.target == BOOT_UPDATE_TARGET_EXT_FLASH)
+        return boot_ext_flash_calc_crc(boot_update_ctx.slot_idx, offset, len, crc);
+
+    return boot_crc32(crc, (const uint8_t *)(BOOT_FLASH_APP_START_ADDR + offset), len);
+}
+
+/**
+ * @brief   记录一个完整数据块已写入 Flash，连续写入的块数每增加 BOOT_UPDATE_RESUME_INTERVAL 保存一次断点
+ * @details 断点的 CRC 从 Flash 中回读计算，记录的是 Flash 里实际的内容。
+ *          块可能乱序写入，只跟踪 committed 之后 32 个块内的乱序，超出范围的块不计入断点（断点保守地停在前面）。
+ * @param[in] chunk_idx 数据块索引
+ */
+static void boot_update_commit(uint32_t chunk_idx)
+{
+    boot_resume_info_t info;
+    uint32_t bit;
+
+    if (!boot_update_ctx.file_size || BOOT_UPDATE_RESUME_INTERVAL == 0 || chunk_idx < boot_update_ctx.committed)
+        return;
+
+    bit = chunk_idx - boot_update_ctx.committed;
+    if (bit >= 32)
+        return;
+
+    boot_update_ctx.ahead |= 1UL << bit;
+    while (boot_update_ctx.ahead & 1) {
+        boot_update_ctx.ahead >>= 1;
+        boot_update_ctx.committed++;
+    }
+
+    if (boot_update_ctx.committed - boot_update_ctx.saved_cnt < BOOT_UPDATE_RESUME_INTERVAL)
+        return;
+
+    boot_update_ctx.saved_crc = boot_update_calc_crc(boot_update_ctx.saved_cnt * BOOT_APP_UPDATE_CHUNK_SIZE,
+                                                     (boot_update_ctx.committed - boot_update_ctx.saved_cnt) *
+                                                     BOOT_APP_UPDATE_CHUNK_SIZE,
+                                                     boot_update_ctx.saved_crc);
+    boot_update_ctx.saved_cnt = boot_update_ctx.committed;
+
+    info.target    = boot_update_ctx.target;
+    info.slot_idx  = boot_update_ctx.slot_idx;
+    info.reserved  = 0;
+    info.file_size = boot_update_ctx.file_size;
+    info.chunk_cnt = boot_update_ctx.saved_cnt;
+    info.data_crc  = boot_update_ctx.saved_crc;
+    if (boot_resume_info_save(&info) != 0)
+        boot_update_ctx.file_size = 0;  // EEPROM 写失败，本次下载不再记录断点
+}
+
+/**
+ * @brief   清空所有缓冲区的待写入状态
+ */
+static void boot_update_slot_reset(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < BOOT_APP_UPDATE_CHUNK_NUM; i++)
+        boot_update_ctx.slot[i].pending = false;
+    boot_update_ctx.chunk_writing = false;
+}
+
+/**
+ * @brief   开始一次 APP 更新数据流
+ * @details 写入内部 Flash 且已知固件大小时，按大小规划擦除，规划中擦除失败的错误码由后续写入返回；
+ *          写入外部 Flash 时槽位按需擦除，已知固件大小时只擦除固件覆盖的范围。
+ *          之前的断点记录对应的数据即将被覆盖，先清除；本次是否保存断点由 boot_update_set_resumable 决定。
+ * @param[in] target 写入目标
+ * @param[in] size   固件字节数，0 表示未知（如 Xmodem）
+ */
+void boot_update_begin(boot_update_target_t target, uint32_t size)
+{
+    boot_update_ctx.target = target;
+    boot_update_ctx.recv_bytes = 0;
+    boot_update_ctx.tail_len = 0;
+    boot_update_slot_reset();
+    boot_update_ctx.err = 0;
+    boot_update_ctx.slot_idx = (target == BOOT_UPDATE_TARGET_EXT_FLASH) ? boot_ext_flash_get_cur_slot_idx() : 0;
+    boot_update_ctx.file_size = 0;
+    boot_update_ctx.image_size = size;
+    boot_update_ctx.chunk_at = false;
+    boot_update_ctx.committed = 0;
+    boot_update_ctx.ahead = 0;
+    boot_update_ctx.saved_cnt = 0;
+    boot_update_ctx.saved_crc = 0xFFFFFFFF;
+    boot_update_ctx.data_crc = 0xFFFFFFFF;
+    boot_update_ctx.crc_carry_len = 0;
+    boot_update_ctx.image_crc_set = false;
+    boot_resume_info_clear();
+
+    if (target == BOOT_UPDATE_TARGET_FLASH) {
+        boot_flash_erase_begin();
+        if (size)
+            boot_update_ctx.err = boot_flash_erase_plan(bsp_flash_get(), size);
+    } else {
+        boot_ext_flash_erase_begin(size);
+    }
+}
+
+/**
+ * @brief   本次 APP 更新数据流在下载过程中向 EEPROM 保存断点
+ * @details 在 boot_update_begin 之后调用，只有能发起续传的协议（流式传输的 RESUME）才需要断点，
+ *          Ymodem 等协议没有续传的入口，不调用，不占用 EEPROM 写入。固件大小未知时不保存。
+ */
+void boot_update_set_resumable(void)
+{
+    boot_update_ctx.file_size = boot_update_ctx.image_size;
+}
+
+/**
+ * @brief   设置数据来源给出的整个固件的 CRC，boot_update_finish 用它校验 Flash
+ * @details 在 boot_update_begin / boot_update_resume 之后调用。按块索引写入（乱序到达、增量更新）时
+ *          无法顺序累计 CRC，必须由数据来源给出。增量更新不按固件大小擦除（begin 时大小为 0），
+ *          在这里给出大小，校验范围覆盖整个新固件，而不只是写入过的块
+ * @param[in] size 整个固件的字节数
+ * @param[in] crc  整个固件的 CRC32，按 boot_crc32_word 的方式计算
+ */
+void boot_update_set_image_crc(uint32_t size, uint32_t crc)
+{
+    boot_update_ctx.image_size = size;
+    boot_update_ctx.image_crc = crc;
+    boot_update_ctx.image_crc_set = true;
+}
+
+/**
+ * @brief   累计顺序写入的数据的 CRC
+ * @details 在数据拷贝进 update_chunk 之前，直接对协议层校验过的数据计算，不依赖中转的副本。
+ *          按字计算，不足一个字的字节留到下次，最后不足一个字的尾部由 boot_update_finish 补 0xFF 计算
+ * @param[in] data 数据首地址
+ * @param[in] len  数据长度
+ */
+static void boot_update_feed_crc(const uint8_t *data, uint32_t len)
+{
+    uint32_t words;
+
+    while (boot_update_ctx.crc_carry_len && len) {
+        boot_update_ctx.crc_carry[boot_update_ctx.crc_carry_len++] = *data++;
+        len--;
+        if (boot_update_ctx.crc_carry_len == 4) {
+            boot_update_ctx.data_crc = boot_crc32_word(boot_update_ctx.data_crc, boot_update_ctx.crc_carry, 4);
+            boot_update_ctx.crc_carry_len = 0;
+        }
+    }
+
+    words = len & ~3UL;
+    boot_update_ctx.data_crc = boot_crc32_word(boot_update_ctx.data_crc, data, words);
+    memcpy(&boot_update_ctx.crc_carry[boot_update_ctx.crc_carry_len], &data[words], len - words);
+    boot_update_ctx.crc_carry_len += len - words;
+}
+
+/**
+ * @brief   查找块索引最小的待写入缓冲区，按顺序写入使断点尽早推进
+ * @return  缓冲区编号，-1 表示没有待写入的数据块
+ */
+static int boot_update_oldest_slot(void)
+{
+    int oldest = -1;
+    uint8_t i;
+
+    for (i = 0; i < BOOT_APP_UPDATE_CHUNK_NUM; i++) {
+        if (boot_update_ctx.slot[i].pending &&
+            (oldest < 0 || boot_update_ctx.slot[i].chunk_idx < boot_update_ctx.slot[oldest].chunk_idx))
+            oldest = i;
+    }
+    return oldest;
+}
+
+/**
+ * @brief   写入一个缓冲区中待写入的数据块
+ * @details 写入外部 Flash 时由 boot_ext_flash_write_poll 在后台逐页擦除/写入，同一时刻只有一个数据块在写，
+ *          另一个缓冲区正在后台写入时先把它写完。不等待时每次只推进一步。
+ *          写 Flash 失败时记录错误码，由后续 boot_update_write / boot_update_finish 返回。
+ * @param[in] slot 缓冲区编号
+ * @param[in] wait true 表示等待数据块写入完成后返回
+ */
+static void boot_update_write_slot(uint8_t slot, bool wait)
+{
+    bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
+    boot_update_slot_t *s = &boot_update_ctx.slot[slot];
+    int ret = 0;
+
+    if (boot_update_ctx.chunk_writing && boot_update_ctx.writing_slot != slot) {
+        boot_update_write_slot(boot_update_ctx.writing_slot, wait);
+        if (boot_update_ctx.chunk_writing)
+            return;
+    }
+
+    if (!s->pending)
+        return;
+
+    if (boot_update_ctx.target == BOOT_UPDATE_TARGET_EXT_FLASH) {
+        if (!boot_update_ctx.chunk_writing) {
+            ret = boot_ext_flash_write_chunk_start(ext_flash, s->chunk_idx, s->len);
+            boot_update_ctx.chunk_writing = (ret == 0);
+            boot_update_ctx.writing_slot = slot;
+        }
+        while (boot_update_ctx.chunk_writing) {
+            ret = boot_ext_flash_write_poll(ext_flash);
+            if (ret != -EBUSY)
+                boot_update_ctx.chunk_writing = false;
+            else if (!wait)
+                return;
+        }
+    } else {
+        ret = boot_update_write_chunk(s->chunk_idx, s->len);
+    }
+
+    s->pending = false;
+    if (ret && !boot_update_ctx.err)
+        boot_update_ctx.err = ret;
+    else if (!ret && s->len == BOOT_APP_UPDATE_CHUNK_SIZE)
+        boot_update_commit(s->chunk_idx);
+}
+
+/**
+ * @brief   写入所有待写入的数据块，返回前全部写完
+ */
+static void boot_update_write_all(void)
+{
+    int slot;
+
+    while ((slot = boot_update_oldest_slot()) >= 0)
+        boot_update_write_slot(slot, true);
+}
+
+/**
+ * @brief   将待写入的数据块写入 Flash
+ * @details 在主循环空闲（无串口数据）时调用。此时发送端已收到 ACK 并在发送下一包，
+ *          串口 DMA 在后台接收，写 Flash 的时间与数据包传输时间重叠。
+ *          写入内部 Flash 时每次调用写完一个数据块；写入外部 Flash 时每次调用只在外部 Flash 空闲时发出一条
+ *          擦除/页编程指令后立即返回，64KB 块擦除期间也能继续处理收到的数据包。
+ */
+void boot_update_poll(void)
+{
+    int slot = boot_update_ctx.chunk_writing ? boot_update_ctx.writing_slot : boot_update_oldest_slot();
+
+    if (slot >= 0)
+        boot_update_write_slot(slot, false);
+}
+
+/**
+ * @brief   chunk_idx 要使用的缓冲区中还有待写入的数据块时，先把它写入 Flash
+ * @param[in] chunk_idx 即将使用的数据块索引
+ */
+static void boot_update_release_chunk(uint32_t chunk_idx)
+{
+    uint8_t slot = chunk_idx % BOOT_APP_UPDATE_CHUNK_NUM;
+
+    if (boot_update_ctx.slot[slot].pending)
+        boot_update_write_slot(slot, true);
+}
+
+/**
+ * @brief   标记数据块待写入，由 boot_update_poll 在空闲时写入，或在缓冲区被再次使用前写入
+ * @param[in] chunk_idx 数据块索引
+ * @param[in] len       数据块有效字节数
+ */
+static void boot_update_mark_pending(uint32_t chunk_idx, uint32_t len)
+{
+    boot_update_slot_t *s = &boot_update_ctx.slot[chunk_idx % BOOT_APP_UPDATE_CHUNK_NUM];
+
+    s->pending = true;
+    s->chunk_idx = chunk_idx;
+    s->len = len;
+}
+
+/**
+ * @brief   向 APP 更新数据流追加数据
+ * @details 数据按顺序拷贝到 update_chunk，每填满一个 chunk 标记为待写入，
+ *          由 boot_update_poll 在空闲时写入内/外部 Flash，下一个 chunk 使用另一个缓冲区继续接收。
+ *          一次追加的数据可能跨越 chunk 边界，此时分段拷贝。
+ * @param[in] data 数据首地址
+ * @param[in] len  数据长度
+ * @return  0 表示成功，其他值表示之前写 Flash 失败的错误码
+ */
+int boot_update_write(const uint8_t *data, uint32_t len)
+{
+    uint8_t *update_chunk;
+    uint32_t chunk_idx;         // 当前 update_chunk 的块索引
+    uint32_t offset_in_chunk;   // 当前 update_chunk 内的写入偏移
+    uint32_t copy_len;          // 本次拷贝到 update_chunk 的字节数
+
+    if (!boot_update_ctx.err)
+        boot_update_feed_crc(data, len);
+
+    while (len && !boot_update_ctx.err) {
+        chunk_idx = boot_update_ctx.recv_bytes / BOOT_APP_UPDATE_CHUNK_SIZE;
+        offset_in_chunk = boot_update_ctx.recv_bytes % BOOT_APP_UPDATE_CHUNK_SIZE;
+
+        /* 待写入的数据块占用着同一个缓冲区，先写入 Flash */
+        boot_update_release_chunk(chunk_idx);
+
+        update_chunk = boot_get_update_chunk(chunk_idx);
+        copy_len = BOOT_APP_UPDATE_CHUNK_SIZE - offset_in_chunk;
+        if (copy_len > len)
+            copy_len = len;
+
+        memcpy(&update_chunk[offset_in_chunk], data, copy_len);
+        boot_update_ctx.recv_bytes += copy_len;
+        data += copy_len;
+        len  -= copy_len;
+
+        /* update_chunk 填满，标记为待写入 */
+        if ((boot_update_ctx.recv_bytes % BOOT_APP_UPDATE_CHUNK_SIZE) == 0)
+            boot_update_mark_pending(chunk_idx, BOOT_APP_UPDATE_CHUNK_SIZE);
+    }
+
+    boot_update_ctx.tail_len = boot_update_ctx.recv_bytes % BOOT_APP_UPDATE_CHUNK_SIZE;
+    return boot_update_ctx.err;
+}
+
+/**
+ * @brief   按块索引写入一个完整的数据块，块可以乱序到达
+ * @details 内/外部 Flash 已提前擦除，每个块写入各自的地址，与到达顺序无关。
+ *          除最后一块外 len 必须等于 BOOT_APP_UPDATE_CHUNK_SIZE，同一数据流中不能与 boot_update_write 混用。
+ * @param[in] chunk_idx 数据块索引（从 0 开始）
+ * @param[in] data      数据首地址
+ * @param[in] len       数据长度，不超过 BOOT_APP_UPDATE_CHUNK_SIZE
+ * @return  0 表示成功，其他值表示之前写 Flash 失败的错误码
+ */
+int boot_update_write_chunk_at(uint32_t chunk_idx, const uint8_t *data, uint32_t len)
+{
+    uint32_t end = chunk_idx * BOOT_APP_UPDATE_CHUNK_SIZE + len;
+
+    if (boot_update_ctx.err)
+        return boot_update_ctx.err;
+
+    boot_update_release_chunk(chunk_idx);
+    memcpy(boot_get_update_chunk(chunk_idx), data, len);
+    boot_update_mark_pending(chunk_idx, len);
+    boot_update_ctx.chunk_at = true;
+
+    if (end > boot_update_ctx.recv_bytes)
+        boot_update_ctx.recv_bytes = end;
+
+    return boot_update_ctx.err;
+}
+
+/**
+ * @brief   立即写入待写入的数据块
+ * @details 用于按块停等的写入，在回复发送端之前确认数据块已写入 Flash
+ * @return  0 表示成功，其他值表示写 Flash 失败的错误码
+ */
+int boot_update_flush(void)
+{
+    boot_update_write_all();
+    return boot_update_ctx.err;
+}
+
+/**
+ * @brief   结束 APP 更新数据流，写入待写入的数据块和最后不足一个 update_chunk 的剩余数据
+ * @details 最后校验写入目标中的整个固件：内部 Flash 用硬件 CRC 计算，外部 Flash 读出计算。
+ *          参考值优先使用数据来源给出的整个固件的 CRC，否则使用顺序写入时累计的 CRC；
+ *          按块索引写入时没有累计的 CRC，数据来源未给出时返回失败。
+ *          范围为开始时给出的固件大小，未给出时为收到的字节数。
+ * @return  0 表示成功，其他值表示写 Flash 或校验失败
+ */
+int boot_update_finish(void)
+{
+    uint32_t remaining_bytes = boot_update_ctx.tail_len;
+    uint32_t size = boot_update_ctx.image_size ? boot_update_ctx.image_size : boot_update_ctx.recv_bytes;
+    uint32_t crc;
+    int ret = 0;
+
+    /*
+     * chunk_idx 表示之前已经写满的 update_chunk 数量（索引从 0 开始）
+     * 例： 收到 1280 字节，前 1024 字节写满第 0 个 chunk，还剩 256 字节属于 chunk_idx = 1
+     */
+    uint32_t chunk_idx = boot_update_ctx.recv_bytes / BOOT_APP_UPDATE_CHUNK_SIZE;
+
+    boot_update_write_all();
+    if (boot_update_ctx.err)
+        return boot_update_ctx.err;
+
+    if (remaining_bytes)
+        ret = boot_update_write_chunk(chunk_idx, remaining_bytes);
+    if (ret)
+        return ret;
+
+    if (boot_update_ctx.image_crc_set) {
+        crc = boot_update_ctx.image_crc;
+    } else if (!boot_update_ctx.chunk_at) {
+        crc = boot_crc32_word(boot_update_ctx.data_crc, boot_update_ctx.crc_carry, boot_update_ctx.crc_carry_len);
+    } else {
+        log_error("No image CRC given, Flash content cannot be verified!");
+        return -EINVAL;
+    }
+
+    if (boot_update_ctx.target == BOOT_UPDATE_TARGET_FLASH) {
+        ret = boot_flash_verify(size, crc);
+    } else if (boot_ext_flash_calc_image_crc(boot_update_ctx.slot_idx, size) != crc) {
+        log_error("Ext flash verify failed for slot %d (%d bytes)!", boot_update_ctx.slot_idx, size);
+        ret = -EIO;
+    }
+    if (!ret)
+        boot_resume_info_clear();
+    return ret;
+}
+
+/**
+ * @brief   从 EEPROM 中的断点继续一次 APP 更新数据流
+ * @details 断点的写入目标、槽位和固件大小都与本次一致，且 Flash 中前 chunk_cnt 个数据块的 CRC
+ *          与记录一致时才能继续，之后从第 chunk_cnt 个数据块开始写入，已写入的页/扇区不再擦除。
+ *          内部 Flash 与 boot_update_begin 一样按固件大小规划擦除断点之后的页/扇区，
+ *          F4 的 128KB 扇区不会在传输中途擦除。
+ *          上位机还要用返回的 CRC 确认这些数据块与它的固件一致。
+ * @param[in]  target    写入目标
+ * @param[in]  size      固件字节数
+ * @param[out] chunk_cnt 已写入的数据块数
+ * @param[out] crc       已写入数据块的 CRC32/MPEG-2
+ * @return  0 表示成功，-ENOENT 表示没有可用的断点
+ */
+int boot_update_resume(boot_update_target_t target, uint32_t size, uint32_t *chunk_cnt, uint32_t *crc)
+{
+    boot_resume_info_t info;
+    uint8_t slot_idx = (target == BOOT_UPDATE_TARGET_EXT_FLASH) ? boot_ext_flash_get_cur_slot_idx() : 0;
+    int ret;
+
+    ret = boot_resume_info_load(&info);
+    if (ret)
+        return -ENOENT;
+
+    if (info.target != target || info.slot_idx != slot_idx || info.file_size != size ||
+        info.chunk_cnt == 0 || info.chunk_cnt * BOOT_APP_UPDATE_CHUNK_SIZE >= size)
+        return -ENOENT;
+
+    boot_update_ctx.target = target;
+    boot_update_ctx.slot_idx = slot_idx;
+    if (boot_update_calc_crc(0, info.chunk_cnt * BOOT_APP_UPDATE_CHUNK_SIZE, 0xFFFFFFFF) != info.data_crc) {
+        log_warn("Resume point does not match Flash content, ignored");
+        return -ENOENT;
+    }
+
+    boot_update_ctx.recv_bytes = info.chunk_cnt * BOOT_APP_UPDATE_CHUNK_SIZE;
+    boot_update_ctx.tail_len = 0;
+    boot_update_slot_reset();
+    boot_update_ctx.err = 0;
+    boot_update_ctx.file_size = size;
+    boot_update_ctx.image_size = size;
+    boot_update_ctx.chunk_at = false;
+    boot_update_ctx.image_crc_set = false;
+    boot_update_ctx.committed = info.chunk_cnt;
+    boot_update_ctx.ahead = 0;
+    boot_update_ctx.saved_cnt = info.chunk_cnt;
+    boot_update_ctx.saved_crc = info.data_crc;
+
+    if (target == BOOT_UPDATE_TARGET_FLASH) {
+        boot_flash_erase_begin();
+        boot_flash_resume(boot_update_ctx.recv_bytes);
+        boot_update_ctx.err = boot_flash_erase_plan(bsp_flash_get(), size);  // 只擦除断点之后的页/扇区
+    } else {
+        boot_ext_flash_erase_begin(size);
+        boot_ext_flash_resume(boot_update_ctx.recv_bytes);
+    }
+
+    log_info("Resume download from chunk %d of %d", info.chunk_cnt,
+             (size + BOOT_APP_UPDATE_CHUNK_SIZE - 1) / BOOT_APP_UPDATE_CHUNK_SIZE);
+    *chunk_cnt = info.chunk_cnt;
+    *crc = info.data_crc;
+    return 0;
+}
+
+/**
+ * @brief   获取当前 APP 更新数据流已接收的字节数
+ * @return  已接收的字节数
+ */
+uint32_t boot_update_get_size(void)
+{
+    return boot_update_ctx.recv_bytes;
+}
@@ -0,0 +1,89 @@
+#ifndef BOOT_UPDATE_H
+#define BOOT_UPDATE_H
+
+#include <stdint.h>
+
+#ifndef ENOENT
+#define ENOENT      2
+#endif
+
+/* APP 更新数据的写入目标 */
+typedef enum {
+    BOOT_UPDATE_TARGET_FLASH,       // 内部 Flash A 区
+    BOOT_UPDATE_TARGET_EXT_FLASH,   // 外部 Flash 当前槽位
+} boot_update_target_t;
+
+/**
+ * @brief   开始一次 APP 更新数据流
+ * @param[in] target 写入目标
+ * @param[in] size   固件字节数，0 表示未知（如 Xmodem）
+ */
+void boot_update_begin(boot_update_target_t target, uint32_t size);
+
+/**
+ * @brief   本次 APP 更新数据流在下载过程中向 EEPROM 保存断点，在 boot_update_begin 之后调用
+ */
+void boot_update_set_resumable(void);
+
+/**
+ * @brief   设置数据来源给出的整个固件的 CRC（boot_crc32_word），boot_update_finish 用它校验 Flash
+ * @param[in] size 整个固件的字节数
+ * @param[in] crc  整个固件的 CRC32
+ */
+void boot_update_set_image_crc(uint32_t size, uint32_t crc);
+
+/**
+ * @brief   将待写入的数据块写入 Flash，在主循环空闲时调用
+ */
+void boot_update_poll(void);
+
+/**
+ * @brief   向 APP 更新数据流追加数据
+ * @details 数据按顺序拷贝到 update_chunk，每填满一个 chunk 标记为待写入，由 boot_update_poll 写入 Flash
+ * @param[in] data 数据首地址
+ * @param[in] len  数据长度
+ * @return  0 表示成功，其他值表示之前写 Flash 失败的错误码
+ */
+int boot_update_write(const uint8_t *data, uint32_t len);
+
+/**
+ * @brief   按块索引写入一个完整的数据块，块可以乱序到达
+ * @details 除最后一块外 len 必须等于 BOOT_APP_UPDATE_CHUNK_SIZE，同一数据流中不能与 boot_update_write 混用
+ * @param[in] chunk_idx 数据块索引（从 0 开始）
+ * @param[in] data      数据首地址
+ * @param[in] len       数据长度，不超过 BOOT_APP_UPDATE_CHUNK_SIZE
+ * @return  0 表示成功，其他值表示之前写 Flash 失败的错误码
+ */
+int boot_update_write_chunk_at(uint32_t chunk_idx, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief   立即写入待写入的数据块，用于按块停等的写入
+ * @return  0 表示成功，其他值表示写 Flash 失败的错误码
+ */
+int boot_update_flush(void);
+
+/**
+ * @brief   结束 APP 更新数据流，写入待写入的数据块和最后不足一个 update_chunk 的剩余数据
+ * @details 最后用整个固件的 CRC 校验写入目标，参考值为数据来源给出的 CRC 或顺序写入时累计的 CRC
+ * @return  0 表示成功，其他值表示写 Flash 或校验失败
+ */
+int boot_update_finish(void);
+
+/**
+ * @brief   从 EEPROM 中的断点继续一次 APP 更新数据流
+ * @details 写入目标、槽位、固件大小一致且 Flash 内容与记录的 CRC 一致时，从第 chunk_cnt 个数据块继续写入
+ * @param[in]  target    写入目标
+ * @param[in]  size      固件字节数
+ * @param[out] chunk_cnt 已写入的数据块数
+ * @param[out] crc       已写入数据块的 CRC32/MPEG-2
+ * @return  0 表示成功，-ENOENT 表示没有可用的断点
+ */
+int boot_update_resume(boot_update_target_t target, uint32_t size, uint32_t *chunk_cnt, uint32_t *crc);
+
+/**
+ * @brief   获取当前 APP 更新数据流已接收的字节数
+ * @return  已接收的字节数
+ */
+uint32_t boot_update_get_size(void);
+
+#endif
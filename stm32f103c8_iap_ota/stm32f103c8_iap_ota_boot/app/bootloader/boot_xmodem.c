@@ -1,76 +1,185 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdbool.h>
+#include <errno.h>
 #include "bsp_delay.h"
 #include "boot_core.h"
 #include "boot_cmd.h"
 #include "boot_comm.h"
+#include "boot_crc.h"
 #include "boot_store.h"
 #include "boot_flash.h"
 #include "boot_ext_flash.h"
+#include "boot_update.h"
+#include "boot_baud.h"
+#include "boot_xmodem.h"
 #include "log.h"
 
-/* Xmodem协议 */
-#define XMODEM_PACKET_LEN       133	// 数据包总长度 SOH + pkt_no + ~pkt_no + 128 bytes + CRC(2 bytes) 
-#define XMODEM_PACKET_DATA_LEN  128	// 数据包有效数据长度
-#define XMODEM_SOH              0x01
-#define XMODEM_EOT              0x04 
-
-/* 每个 update_chunk 包含多少个 Xmodem 包 */
-#define XMODEM_PACKETS_PER_CHUNK	(BOOT_APP_UPDATE_CHUNK_SIZE / XMODEM_PACKET_DATA_LEN)
+/* 一个 STX 数据包必须恰好落在整数个 update_chunk 内，保证 1K 包与 chunk 边界对齐 */
+#if (BOOT_APP_UPDATE_CHUNK_SIZE % XMODEM_1K_PACKET_DATA_LEN) != 0
+#error boot_xmodem.c: BOOT_APP_UPDATE_CHUNK_SIZE must be a multiple of 1024!
+#endif
 
 typedef struct {
-    uint32_t xmodem_timeout_ms;	// Xmodem 协议延时
-    uint32_t xmodem_packet_cnt;	// Xmodem 协议数据包接收计数，一个包 128 字节，8 个包写满一页内部 Flash
+    uint32_t xmodem_c_deadline;	// 下一次发送 'C' 的时刻（毫秒时基）
+    uint8_t  xmodem_expect_seq;	// 期望的下一个包序号（从 1 开始，255 之后回绕到 0）
+    uint8_t  xmodem_eot_cnt;	// 上一个数据包之后收到的 EOT 个数
+    uint8_t  xmodem_can_cnt;	// 连续收到的 CAN 个数
 } boot_xmodem_ctx_t;
 
+/* 帧重组：数据包被串口空闲中断拆成多段时，在此拼接成完整的包 */
+typedef struct {
+    uint8_t  buf[XMODEM_1K_PACKET_LEN];	// 拼接缓冲区
+    uint32_t len;						// 已拼接的字节数，0 表示不在拼接中
+    uint32_t expect_len;				// 当前包的总长度
+} boot_xmodem_framer_t;
+
 static boot_xmodem_ctx_t boot_xmodem_ctx;
+static boot_xmodem_framer_t boot_xmodem_framer;
 
 /**
  * @brief   Xmodem 协议初始化
  */
 void boot_xmodem_init(void)
 {
-    boot_xmodem_ctx.xmodem_timeout_ms = 0;
-    boot_xmodem_ctx.xmodem_packet_cnt = 0;
+    boot_xmodem_ctx.xmodem_c_deadline = bsp_delay_get_tick_ms();   // 第一个 'C' 立即发送
+    boot_xmodem_ctx.xmodem_expect_seq = 1;
+    boot_xmodem_ctx.xmodem_eot_cnt = 0;
+    boot_xmodem_ctx.xmodem_can_cnt = 0;
+    boot_xmodem_framer_reset();
+
+    if (boot_has_flag(BOOT_FLAG_EXT_DOWNLOAD_XMODEM))
+        boot_update_begin(BOOT_UPDATE_TARGET_EXT_FLASH, 0);
+    else
+        boot_update_begin(BOOT_UPDATE_TARGET_FLASH, 0);
 }
 
 /**
  * @brief   按周期发送 'C' 字符开始 Xmodem CRC 模式握手
+ * @details 按毫秒时基比较截止时刻，未到时间立即返回，不阻塞主循环
  */
 void boot_xmodem_send_c(void)
 {
-    bsp_delay_ms(1);
-    if (boot_xmodem_ctx.xmodem_timeout_ms >= 1000)
-	{
-		boot_send_data("C", 1);
-		boot_xmodem_ctx.xmodem_timeout_ms = 0;
-	}
-	boot_xmodem_ctx.xmodem_timeout_ms++;
+    uint32_t now = bsp_delay_get_tick_ms();
+
+    if ((int32_t)(now - boot_xmodem_ctx.xmodem_c_deadline) < 0)
+        return;
+
+    boot_send_data("C", 1);
+    boot_xmodem_ctx.xmodem_c_deadline = now + XMODEM_C_INTERVAL_MS;
 }
 
 /**
- * @brief   计算 Xmodem 协议 CRC16 校验值
- * @param[in] data 待校验的数据
- * @param[in] len  数据长度
- * @return	CRC16 校验值
+ * @brief   复位 Xmodem/Ymodem 帧重组状态，丢弃未拼完的包
  */
-static uint16_t boot_xmodem_crc16(uint8_t *data, uint16_t len)
+void boot_xmodem_framer_reset(void)
 {
-    uint16_t crc = 0x0000;
-    uint16_t i;
-    
-    while(len--) {
-        crc ^= *data++ << 8;
-        for(i = 0; i < 8; i++) {
-            if(crc & 0x8000) {
-                crc = (crc << 1) ^ 0x1021;
-            } else {
-                crc <<= 1;
-            }
+    boot_xmodem_framer.len = 0;
+    boot_xmodem_framer.expect_len = 0;
+}
+
+/**
+ * @brief   判断一段串口数据是否为单独成段的控制帧
+ * @details 发送端只在收到应答后才发送 EOT，EOT 必须单独成段；CAN 可以连续发送多个，整段都是 CAN 才算
+ * @param[in] data 接收数据的首地址
+ * @param[in] len  接收数据的长度
+ * @return  true 表示本段是 EOT/CAN 控制帧
+ */
+static bool boot_xmodem_framer_is_ctrl(const uint8_t *data, uint32_t len)
+{
+    uint32_t i;
+
+    if (data[0] == XMODEM_EOT)
+        return len == 1;
+
+    if (data[0] != XMODEM_CAN)
+        return false;
+
+    for (i = 1; i < len; i++) {
+        if (data[i] != XMODEM_CAN)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief   把一段串口数据送入 Xmodem/Ymodem 帧重组
+ * @details 串口按空闲中断分段，一个数据包可能被拆成多段，一段中也可能有多个背靠背的包。
+ *          本函数按帧头识别包长：SOH 包 133 字节，STX 包 1029 字节，其他不在包内的字节丢弃。
+ *          EOT/CAN 只在帧边界上且单独成段时才作为单字节帧交给 handler，
+ *          从包中间开始重新同步时，固件数据中的 0x04/0x18 不会被当作控制帧。
+ *          完整落在本段内的包直接交给 handler（零拷贝），
+ *          跨段的包先拷贝到拼接缓冲区，拼完后再交给 handler。
+ *          handler 返回负值（CRC 错误或会话结束）时丢弃本段剩余数据并复位，等待发送端重发。
+ * @param[in] data    接收数据的首地址
+ * @param[in] len     接收数据的长度
+ * @param[in] handler 完整帧处理函数
+ */
+void boot_xmodem_framer_feed(uint8_t *data, uint32_t len, boot_xmodem_frame_handler_t handler)
+{
+    boot_xmodem_framer_t *framer = &boot_xmodem_framer;
+    uint32_t copy_len;
+    uint32_t i;
+    int ret;
+
+    if (len == 0)
+        return;
+
+    /* 帧边界上单独成段的 EOT/CAN，逐字节交给 handler */
+    if (framer->len == 0 && boot_xmodem_framer_is_ctrl(data, len)) {
+        for (i = 0; i < len; i++) {
+            if (handler(&data[i], 1) < 0)
+                return;
+        }
+        return;
+    }
+
+    while (len) {
+        /* 继续拼接上一段未完成的包 */
+        if (framer->len) {
+            copy_len = framer->expect_len - framer->len;
+            if (copy_len > len)
+                copy_len = len;
+
+            memcpy(&framer->buf[framer->len], data, copy_len);
+            framer->len += copy_len;
+            data += copy_len;
+            len  -= copy_len;
+
+            if (framer->len < framer->expect_len)
+                return;
+
+            framer->len = 0;
+            ret = handler(framer->buf, framer->expect_len);
+            if (ret < 0)
+                return;
+            continue;
+        }
+
+        /* 根据帧头确定帧长度 */
+        if (data[0] == XMODEM_SOH) {
+            framer->expect_len = XMODEM_PACKET_LEN;
+        } else if (data[0] == XMODEM_STX) {
+            framer->expect_len = XMODEM_1K_PACKET_LEN;
+        } else {
+            data++;
+            len--;
+            continue;
+        }
+
+        /* 包不完整，拷贝到拼接缓冲区等待下一段 */
+        if (len < framer->expect_len) {
+            memcpy(framer->buf, data, len);
+            framer->len = len;
+            return;
         }
+
+        ret = handler(data, framer->expect_len);
+        if (ret < 0)
+            return;
+        data += framer->expect_len;
+        len  -= framer->expect_len;
     }
-    return crc;
 }
 
 /**
@@ -79,100 +188,116 @@ static uint16_t boot_xmodem_crc16(uint8_t *data, uint16_t len)
  */
 static void boot_xmodem_send_ack_nack(bool is_ack)
 {
-	uint8_t ch = is_ack ? 0x06 : 0x15;
+	uint8_t ch = is_ack ? XMODEM_ACK : XMODEM_NAK;
 	boot_send_data(&ch, 1);
 }
 
 /**
- * @brief   处理一个完整的 Xmodem 数据包
- * @details	工作流程：
- *   		1. 校验 CRC，若不通过则发送 NACK 并退出。
- *   		2. 根据当前 Xmodem 包序号计算写入 update_chunk 的偏移。
- *   		3. 若一个 update_chunk 被填满，则写入内/外部 Flash。
- *   		4. 最终对本包发送 ACK。
- * @param[in] data 数据包首地址（133 字节）
+ * @brief   解析一个 Xmodem/Ymodem 数据包
+ * @details 根据帧头和长度识别 SOH（133 字节）或 STX（1029 字节）数据包，校验包序号与其反码以及 CRC16
+ * @param[in]  data    接收数据的首地址
+ * @param[in]  len     接收数据的长度
+ * @param[out] seq     数据包序号
+ * @param[out] payload 有效数据首地址
+ * @return	有效数据长度（128 或 1024），0 表示不是数据包，-EBADMSG 表示序号反码或 CRC 校验错误
  */
-static void boot_xmodem_process_packet(uint8_t *data)
+int boot_xmodem_parse_packet(uint8_t *data, uint32_t len, uint8_t *seq, uint8_t **payload)
 {
-	bsp_flash_t *flash = bsp_flash_get();
-    bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
-	uint8_t *update_chunk = boot_get_update_chunk();
-	uint32_t packet_idx_in_chunk;	// 当前 update_chunk 内的 Xmodem 包索引（从 0 开始）
-	uint32_t chunk_idx;				// update_chunk 的块索引
+	uint32_t data_len;
+	uint16_t recv_crc;
+
+	if (len == XMODEM_PACKET_LEN && data[0] == XMODEM_SOH)
+		data_len = XMODEM_PACKET_DATA_LEN;
+	else if (len == XMODEM_1K_PACKET_LEN && data[0] == XMODEM_STX)
+		data_len = XMODEM_1K_PACKET_DATA_LEN;
+	else
+		return 0;
+
+	/* 包序号与其反码必须匹配 */
+	if ((uint8_t)(data[1] ^ data[2]) != 0xFF)
+		return -EBADMSG;
 
 	/* 提取 CRC，校验数据部分 */
-	uint16_t recv_crc = (data[131] << 8) | data[132];
-	uint16_t crc = boot_xmodem_crc16(&data[3], XMODEM_PACKET_DATA_LEN);
+	recv_crc = (data[3 + data_len] << 8) | data[3 + data_len + 1];
+	if (boot_crc16(0, &data[3], data_len) != recv_crc)
+		return -EBADMSG;
 
-	if (crc != recv_crc) {
-        boot_xmodem_send_ack_nack(false);	// CRC校验错误，发送 NACK	
-        return;
-    }
+	*seq = data[1];
+	*payload = &data[3];
+	return data_len;
+}
 
-	/* 累积接收到的包数量，从 1 开始计数 */
-	boot_xmodem_ctx.xmodem_packet_cnt++;
-
-	/* 将本 Xmodem 数据包（128 字节）拷贝到当前 update_chunk 的对应偏移位置 */
-	packet_idx_in_chunk = (boot_xmodem_ctx.xmodem_packet_cnt - 1) % XMODEM_PACKETS_PER_CHUNK;
-	memcpy(&update_chunk[packet_idx_in_chunk * XMODEM_PACKET_DATA_LEN], 
-		   &data[3], 
-		   XMODEM_PACKET_DATA_LEN);
-	
-	/*
-	 * 若 X 个包已经填满一个 chunk（packet_cnt % PACKETS_PER_CHUNK == 0），
-	 * 则可计算当前 chunk 的完整索引（从 0 开始）。
-	 *
-	 * 例如：收到第 8 个包（XMODEM_PACKETS_PER_CHUNK = 8）
-	 *   packet_cnt = 8
-	 *   chunk_idx = 8 / 8 - 1 = 0
-	 *   → 第 0 个 chunk 收满，可以写 Flash
-	 * 
-	 * 当未收到 8 个 Xmodem 包时，chunk_idx = -1，此时无意义
-	 */
-	chunk_idx = (boot_xmodem_ctx.xmodem_packet_cnt / XMODEM_PACKETS_PER_CHUNK) - 1;
-
-	/* 如果 update_chunk 填满，则写入内部或外部 Flash */
-	if ((boot_xmodem_ctx.xmodem_packet_cnt % XMODEM_PACKETS_PER_CHUNK) == 0) {
-		if (boot_has_flag(BOOT_FLAG_EXT_DOWNLOAD_XMODEM)) {
-			boot_ext_flash_write_chunk(ext_flash, chunk_idx);
-		} else {
-			boot_flash_write_chunk(flash, chunk_idx);
-		}
-		
-	}
+/**
+ * @brief   Xmodem 传输中止，清除标志位并恢复默认波特率
+ */
+static void boot_xmodem_stop(void)
+{
+	boot_clear_flag(BOOT_FLAG_IAP_XMODEM_SEND_C);
+	boot_clear_flag(BOOT_FLAG_IAP_XMODEM_RECV_DATA);
+	boot_clear_flag(BOOT_FLAG_EXT_DOWNLOAD_XMODEM);
+	boot_baud_restore();
+}
 
-	boot_xmodem_send_ack_nack(true);	// 接收成功，发送 ACK
+/**
+ * @brief   写 Flash 失败，向发送端发送两个 CAN 取消传输
+ * @param[in] err 错误码
+ */
+static void boot_xmodem_abort(int err)
+{
+	uint8_t can[2] = { XMODEM_CAN, XMODEM_CAN };
+
+	boot_send_data(can, sizeof(can));
+	boot_xmodem_stop();
+
+	log_error("Failed to write firmware (err=%d), Xmodem transfer aborted!\r\n", err);
+	boot_cmd_print_menu();
 }
 
 /**
- * @brief   写入最后不足一个 update_chunk 的剩余数据
+ * @brief   处理一个完整的 Xmodem 数据包
+ * @details	只接受期望序号的包，重复的上一包只回 ACK 不写入，其他序号回 NAK。
+ *          有效数据交给 boot_update 按 update_chunk 分块写入内/外部 Flash，
+ *          SOH 包（128 字节）需要 8 个包才能填满一个 chunk；
+ *          STX 包（1024 字节）在 chunk 边界对齐时直接填满一个 chunk，对应一次写 Flash。
+ * @param[in] data 接收数据的首地址
+ * @param[in] len  接收数据的长度
+ * @return	0 表示成功，负值表示 CRC 错误或写 Flash 失败
  */
-static void boot_xmodem_flush_final_chunk(void)
+static int boot_xmodem_process_packet(uint8_t *data, uint32_t len)
 {
-	bsp_flash_t *flash = bsp_flash_get();
-    bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
-	uint8_t *update_chunk = boot_get_update_chunk();
-	uint32_t remaining_packets = boot_xmodem_ctx.xmodem_packet_cnt % XMODEM_PACKETS_PER_CHUNK;
-	uint32_t remaining_bytes = remaining_packets * XMODEM_PACKET_DATA_LEN;
-
-	/*
-	 * chunk_idx 表示之前已经写满的 update_chunk 数量（索引从 0 开始）
-	 * 例： 收到 10 个包，8 个包写满第 0 个 chunk，还剩 2 个包属于 chunk_idx = 1
-	 */
-	uint32_t chunk_idx = (boot_xmodem_ctx.xmodem_packet_cnt / XMODEM_PACKETS_PER_CHUNK);
-
-	if (!remaining_packets)
-        return;
+	uint8_t seq;
+	uint8_t *payload;
+	int data_len = boot_xmodem_parse_packet(data, len, &seq, &payload);
+	int ret;
 
-	if (boot_has_flag(BOOT_FLAG_EXT_DOWNLOAD_XMODEM)) {
-		/* 外部 Flash 始终按 1KB 写，多写无影响 */
-		boot_ext_flash_write_chunk(ext_flash, chunk_idx);
+	if (data_len < 0) {
+        boot_xmodem_send_ack_nack(false);	// CRC校验错误，发送 NACK	
+        return data_len;
+    }
 
-	} else {
-		/* 内部 Flash 写有效字节，避免影响后续空间 */
-		uint32_t addr = BOOT_FLASH_APP_START_ADDR + chunk_idx * BOOT_APP_UPDATE_CHUNK_SIZE;
-		flash->ops->write(flash, addr, remaining_bytes, (uint32_t *)update_chunk);
+	/* 上一包的 ACK 丢失，发送端重发了上一包：只回 ACK，不重复写入 */
+	if (seq == (uint8_t)(boot_xmodem_ctx.xmodem_expect_seq - 1)) {
+		boot_xmodem_send_ack_nack(true);
+		return 0;
+	}
+
+	/* 序号不连续，NAK 让发送端重发期望的包 */
+	if (seq != boot_xmodem_ctx.xmodem_expect_seq) {
+		boot_xmodem_send_ack_nack(false);
+		return -EBADMSG;
+	}
+
+	/* 数据拷贝到 update_chunk 后立即 ACK，填满的 chunk 在等待下一包时写入 Flash */
+	ret = boot_update_write(payload, data_len);
+	if (ret) {
+		boot_xmodem_abort(ret);
+		return ret;
 	}
+
+	boot_xmodem_ctx.xmodem_expect_seq++;
+	boot_xmodem_ctx.xmodem_eot_cnt = 0;	// 收到新数据包，之前的 EOT 不是传输结束
+	boot_xmodem_send_ack_nack(true);	// 接收成功，发送 ACK
+	return 0;
 }
 
 /**
@@ -184,39 +309,79 @@ static void boot_xmodem_finalize_update(void)
 	uint8_t ext_flash_slot_idx = boot_ext_flash_get_cur_slot_idx();
 
 	boot_clear_flag(BOOT_FLAG_IAP_XMODEM_RECV_DATA);
+	boot_baud_restore();
 
 	if (boot_has_flag(BOOT_FLAG_EXT_DOWNLOAD_XMODEM)) {
 		boot_clear_flag(BOOT_FLAG_EXT_DOWNLOAD_XMODEM);
 
 		boot_app_info_load(&boot_app_info);
-		boot_app_info.app_size[ext_flash_slot_idx] = boot_xmodem_ctx.xmodem_packet_cnt * XMODEM_PACKET_DATA_LEN;
+		boot_app_info.app_size[ext_flash_slot_idx] = boot_update_get_size();
 		boot_app_info_save(&boot_app_info);
 
 		log_info("Download completed!\r\n");
 		boot_cmd_print_menu();
 
 	} else {
-		log_info("IAP update completed, restart!\r\n");
+		log_info("IAP update completed (%d chunks identical to Flash skipped), restart!\r\n", boot_flash_get_skipped());
 		boot_system_reset();
 	}
 }
 
 /**
- * @brief   Xmodem 协议接收数据
- * @param[in] data 接收数据的首地址
- * @param[in] len  接收数据的长度
+ * @brief   处理一个完整的 Xmodem 帧
+ * @details EOT 和 CAN 都需要确认：第一个 EOT 回 NAK，发送端重发 EOT 后才结束传输；
+ *          连续收到两个 CAN 才认为发送端取消传输
+ * @param[in] data 帧首地址
+ * @param[in] len  帧长度
+ * @return	0 表示继续接收，负值表示丢弃本段剩余数据
  */
-void boot_xmodem_recv_data(uint8_t *data, uint32_t len)
+static int boot_xmodem_handle_frame(uint8_t *data, uint32_t len)
 {
-	if (len == XMODEM_PACKET_LEN && data[0] == XMODEM_SOH) {
-		/* 接收到一个数据包 */
+	int ret;
+
+	if (data[0] == XMODEM_CAN) {
+		if (++boot_xmodem_ctx.xmodem_can_cnt < 2)
+			return 0;
+		boot_xmodem_stop();
+		log_error("Xmodem transfer canceled by sender!\r\n");
+		boot_cmd_print_menu();
+		return -ECANCELED;
+	}
+	boot_xmodem_ctx.xmodem_can_cnt = 0;
+
+	if (data[0] == XMODEM_SOH || data[0] == XMODEM_STX) {
+		/* 接收到一个 128 字节数据包或 1024 字节数据包（Xmodem-1K） */
 		boot_clear_flag(BOOT_FLAG_IAP_XMODEM_SEND_C);
-		boot_xmodem_process_packet(data);	// 将接收到的数据包按照 update_chunk 容量分块写入内/外部 Flash
+		return boot_xmodem_process_packet(data, len);	// 将接收到的数据包按照 update_chunk 容量分块写入内/外部 Flash
     
-    } else if (len == 1 && data[0] == XMODEM_EOT) {
-		/* 接收到 EOT，传输完成 */
+    } else if (data[0] == XMODEM_EOT) {
+		/* 第一个 EOT 回 NAK，避免误收的 EOT 提前结束传输 */
+		if (++boot_xmodem_ctx.xmodem_eot_cnt < 2) {
+			boot_xmodem_send_ack_nack(false);
+			return 0;
+		}
+
+		/* 确认的 EOT，先写完剩余数据，确认 Flash 写入全部成功后再 ACK */
+		ret = boot_update_finish();			// 把剩余不足一个 update_chunk 的数据写入内/外部 Flash
+		if (ret) {
+			boot_xmodem_abort(ret);
+			return ret;
+		}
 		boot_xmodem_send_ack_nack(true);	// 发送 ACK
-		boot_xmodem_flush_final_chunk();	// 把剩余不足一个 update_chunk 的数据写入内/外部 Flash
 		boot_xmodem_finalize_update();		// 写入内/外部 Flash 完成，更新操作
+		return -ECANCELED;					// 会话结束，丢弃之后的数据
 	}
+
+	return 0;
+}
+
+/**
+ * @brief   Xmodem 协议接收数据
+ * @details 数据先经过帧重组，数据包被拆成多段或多个包合并成一段时都能正确接收
+ * @param[in] data 接收数据的首地址
+ * @param[in] len  接收数据的长度
+ */
+void boot_xmodem_recv_data(uint8_t *data, uint32_t len)
+{
+	boot_xmodem_framer_feed(data, len, boot_xmodem_handle_frame);
 }
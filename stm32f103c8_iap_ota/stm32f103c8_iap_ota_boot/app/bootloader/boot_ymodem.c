@@ -0,0 +1,311 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "bsp_delay.h"
+#include "boot_config.h"
+#include "boot_core.h"
+#include "boot_cmd.h"
+#include "boot_comm.h"
+#include "boot_store.h"
+#include "boot_ext_flash.h"
+#include "boot_flash.h"
+#include "boot_update.h"
+#include "boot_baud.h"
+#include "boot_xmodem.h"
+#include "boot_ymodem.h"
+#include "log.h"
+
+/* Ymodem 接收状态 */
+typedef enum {
+    YMODEM_STATE_WAIT_HEADER,   // 等待 0 号包（文件名 + 文件大小）
+    YMODEM_STATE_RECV_DATA,     // 接收文件数据
+} boot_ymodem_state_t;
+
+typedef struct {
+    uint32_t ymodem_c_deadline;     // 下一次发送 'C' 的时刻（毫秒时基）
+    boot_ymodem_state_t state;      // 接收状态
+    boot_update_target_t target;    // 写入目标
+    uint32_t file_size;             // 当前文件大小
+    uint32_t remaining_bytes;       // 当前文件剩余未写入的字节数
+    uint8_t  expect_seq;            // 期望的下一个数据包序号（从 1 开始，255 之后回绕到 0）
+    uint8_t  eot_cnt;               // 当前文件已收到的 EOT 个数
+    uint8_t  can_cnt;               // 连续收到的 CAN 个数
+    uint8_t  file_cnt;              // 本次会话已完成的文件个数
+} boot_ymodem_ctx_t;
+
+static boot_ymodem_ctx_t boot_ymodem_ctx;
+
+/**
+ * @brief   发送单字节 Ymodem 控制字符
+ * @param[in] ch 控制字符
+ */
+static void boot_ymodem_send_byte(uint8_t ch)
+{
+    boot_send_data(&ch, 1);
+}
+
+/**
+ * @brief   Ymodem 会话结束，清除标志位
+ * @param[in] ok true 表示会话正常结束，false 表示会话被取消
+ */
+static void boot_ymodem_end_session(bool ok)
+{
+    boot_clear_flag(BOOT_FLAG_IAP_YMODEM_SEND_C);
+    boot_clear_flag(BOOT_FLAG_IAP_YMODEM_RECV_DATA);
+    boot_clear_flag(BOOT_FLAG_EXT_DOWNLOAD_YMODEM);
+    boot_baud_restore();
+
+    if (!ok) {
+        log_error("Ymodem session aborted!\r\n");
+        boot_cmd_print_menu();
+        return;
+    }
+
+    if (boot_ymodem_ctx.target == BOOT_UPDATE_TARGET_EXT_FLASH) {
+        log_info("Download completed, %d file(s) received!\r\n", boot_ymodem_ctx.file_cnt);
+        boot_cmd_print_menu();
+    } else {
+        log_info("IAP update completed (%d chunks identical to Flash skipped), restart!\r\n", boot_flash_get_skipped());
+        boot_system_reset();
+    }
+}
+
+/**
+ * @brief   取消 Ymodem 会话，向发送端发送两个 CAN
+ */
+static void boot_ymodem_cancel(void)
+{
+    uint8_t can[2] = { XMODEM_CAN, XMODEM_CAN };
+
+    boot_send_data(can, sizeof(can));
+    boot_ymodem_end_session(false);
+}
+
+/**
+ * @brief   处理 Ymodem 0 号包（文件头）
+ * @details 0 号包数据格式为 "文件名\0文件大小(ASCII 十进制)..."，文件名为空表示批量传输结束。
+ *          外部 Flash 目标每个文件依次写入下一个槽位，只擦除文件大小覆盖的块；
+ *          内部 Flash 目标只接受一个文件。
+ * @param[in] payload  有效数据首地址
+ * @param[in] data_len 有效数据长度
+ */
+static void boot_ymodem_process_header(uint8_t *payload, uint32_t data_len)
+{
+    boot_app_info_t boot_app_info;
+    uint8_t slot_idx;
+    uint32_t name_len;
+    uint32_t max_size;
+    uint32_t header_size;
+
+    /* 文件名为空，批量传输结束 */
+    if (payload[0] == '\0') {
+        boot_ymodem_send_byte(XMODEM_ACK);
+        boot_ymodem_end_session(true);
+        return;
+    }
+
+    /* 解析文件大小，不带大小字段时按最大容量接收 */
+    payload[data_len - 1] = '\0';
+    name_len = strlen((char *)payload);
+    boot_ymodem_ctx.file_size = strtoul((char *)&payload[name_len + 1], NULL, 10);
+
+    if (boot_ymodem_ctx.target == BOOT_UPDATE_TARGET_EXT_FLASH) {
+        slot_idx = boot_ext_flash_get_cur_slot_idx() + (boot_ymodem_ctx.file_cnt ? 1 : 0);
+        max_size = BOOT_EXT_FLASH_APP_MAX_SIZE;
+    } else {
+        slot_idx = 0;
+        max_size = boot_flash_get_app_size();
+    }
+
+    if (boot_ymodem_ctx.file_size > max_size ||
+        (boot_ymodem_ctx.target == BOOT_UPDATE_TARGET_FLASH && boot_ymodem_ctx.file_cnt) ||
+        (boot_ymodem_ctx.target == BOOT_UPDATE_TARGET_EXT_FLASH && slot_idx >= BOOT_EXT_FLASH_APP_SLOT_COUNT)) {
+        log_error("Reject file %s (size=%d bytes)", (char *)payload, boot_ymodem_ctx.file_size);
+        boot_ymodem_cancel();
+        return;
+    }
+
+    header_size = boot_ymodem_ctx.file_size;
+    if (!boot_ymodem_ctx.file_size)
+        boot_ymodem_ctx.file_size = max_size;
+
+    if (boot_ymodem_ctx.target == BOOT_UPDATE_TARGET_EXT_FLASH) {
+        boot_ext_flash_set_cur_slot_idx(slot_idx);
+
+        /* 先清零槽位记录的大小再写入，传输中断时不会留下无效的大小记录 */
+        boot_app_info_load(&boot_app_info);
+        boot_app_info.app_size[slot_idx] = 0;
+        boot_app_info_save(&boot_app_info);
+    }
+
+    boot_update_begin(boot_ymodem_ctx.target, header_size);   // 文件头带大小时按大小规划擦除
+    boot_ymodem_ctx.remaining_bytes = boot_ymodem_ctx.file_size;
+    boot_ymodem_ctx.expect_seq = 1;
+    boot_ymodem_ctx.eot_cnt = 0;
+    boot_ymodem_ctx.state = YMODEM_STATE_RECV_DATA;
+
+    /* 应答 0 号包后再发 C，发送端开始发送文件数据 */
+    boot_ymodem_send_byte(XMODEM_ACK);
+    boot_ymodem_send_byte('C');
+}
+
+/**
+ * @brief   处理 Ymodem 数据包，只写入文件大小以内的数据，丢弃最后一包的填充字节
+ * @param[in] payload  有效数据首地址
+ * @param[in] data_len 有效数据长度
+ */
+static void boot_ymodem_process_data(uint8_t *payload, uint32_t data_len)
+{
+    if (data_len > boot_ymodem_ctx.remaining_bytes)
+        data_len = boot_ymodem_ctx.remaining_bytes;
+
+    if (data_len) {
+        if (boot_update_write(payload, data_len)) {
+            log_error("Failed to write firmware");
+            boot_ymodem_cancel();
+            return;
+        }
+        boot_ymodem_ctx.remaining_bytes -= data_len;
+    }
+
+    boot_ymodem_send_byte(XMODEM_ACK);
+}
+
+/**
+ * @brief   处理 Ymodem EOT
+ * @details 第一个 EOT 回 NAK，第二个 EOT 回 ACK 并结束当前文件，再发 C 请求下一个文件头。
+ *          两个 EOT 之间收到新数据包时计数清零，误收的单个 EOT 不会提前结束文件
+ */
+static void boot_ymodem_process_eot(void)
+{
+    boot_app_info_t boot_app_info;
+
+    if (++boot_ymodem_ctx.eot_cnt < 2) {
+        boot_ymodem_send_byte(XMODEM_NAK);
+        return;
+    }
+
+    /* 确认 Flash 写入全部成功后再 ACK 最后一个 EOT */
+    if (boot_update_finish()) {
+        log_error("Failed to write firmware");
+        boot_ymodem_cancel();
+        return;
+    }
+
+    boot_ymodem_send_byte(XMODEM_ACK);
+
+    if (boot_ymodem_ctx.target == BOOT_UPDATE_TARGET_EXT_FLASH) {
+        boot_app_info_load(&boot_app_info);
+        boot_app_info.app_size[boot_ext_flash_get_cur_slot_idx()] = boot_update_get_size();
+        boot_app_info_save(&boot_app_info);
+    }
+
+    boot_ymodem_ctx.file_cnt++;
+    boot_ymodem_ctx.state = YMODEM_STATE_WAIT_HEADER;
+    boot_ymodem_send_byte('C');
+}
+
+/**
+ * @brief   Ymodem 协议初始化
+ */
+void boot_ymodem_init(void)
+{
+    boot_ymodem_ctx.ymodem_c_deadline = bsp_delay_get_tick_ms();   // 第一个 'C' 立即发送
+    boot_ymodem_ctx.state = YMODEM_STATE_WAIT_HEADER;
+    boot_ymodem_ctx.file_cnt = 0;
+    boot_ymodem_ctx.can_cnt = 0;
+    boot_xmodem_framer_reset();
+
+    if (boot_has_flag(BOOT_FLAG_EXT_DOWNLOAD_YMODEM))
+        boot_ymodem_ctx.target = BOOT_UPDATE_TARGET_EXT_FLASH;
+    else
+        boot_ymodem_ctx.target = BOOT_UPDATE_TARGET_FLASH;
+}
+
+/**
+ * @brief   按周期发送 'C' 字符开始 Ymodem CRC 模式握手
+ * @details 按毫秒时基比较截止时刻，未到时间立即返回，不阻塞主循环
+ */
+void boot_ymodem_send_c(void)
+{
+    uint32_t now = bsp_delay_get_tick_ms();
+
+    if ((int32_t)(now - boot_ymodem_ctx.ymodem_c_deadline) < 0)
+        return;
+
+    boot_ymodem_send_byte('C');
+    boot_ymodem_ctx.ymodem_c_deadline = now + XMODEM_C_INTERVAL_MS;
+}
+
+/**
+ * @brief   处理一个完整的 Ymodem 帧
+ * @param[in] data 帧首地址
+ * @param[in] len  帧长度
+ * @return	0 表示继续接收，负值表示丢弃本段剩余数据
+ */
+static int boot_ymodem_handle_frame(uint8_t *data, uint32_t len)
+{
+    uint8_t seq;
+    uint8_t *payload;
+    int data_len;
+
+    /* 连续收到两个 CAN，发送端取消传输 */
+    if (data[0] == XMODEM_CAN) {
+        if (++boot_ymodem_ctx.can_cnt < 2)
+            return 0;
+        boot_ymodem_end_session(false);
+        return -ECANCELED;
+    }
+    boot_ymodem_ctx.can_cnt = 0;
+
+    if (data[0] == XMODEM_EOT) {
+        if (boot_ymodem_ctx.state == YMODEM_STATE_RECV_DATA)
+            boot_ymodem_process_eot();
+        return 0;
+    }
+
+    data_len = boot_xmodem_parse_packet(data, len, &seq, &payload);
+    if (data_len == 0)
+        return 0;
+
+    if (data_len < 0) {
+        boot_ymodem_send_byte(XMODEM_NAK);  // CRC校验错误，发送 NACK
+        return data_len;
+    }
+
+    boot_clear_flag(BOOT_FLAG_IAP_YMODEM_SEND_C);
+
+    if (boot_ymodem_ctx.state == YMODEM_STATE_WAIT_HEADER) {
+        if (seq == 0)
+            boot_ymodem_process_header(payload, data_len);
+        else
+            boot_ymodem_send_byte(XMODEM_NAK);
+    } else if (seq == boot_ymodem_ctx.expect_seq) {
+        boot_ymodem_ctx.expect_seq++;
+        boot_ymodem_ctx.eot_cnt = 0;    // 收到新数据包，之前的 EOT 不是文件结束
+        boot_ymodem_process_data(payload, data_len);
+    } else if (seq == (uint8_t)(boot_ymodem_ctx.expect_seq - 1)) {
+        boot_ymodem_send_byte(XMODEM_ACK);  // 上一包（或 0 号包）的 ACK 丢失，发送端重发，只回 ACK 不重复写入
+    } else {
+        boot_ymodem_send_byte(XMODEM_NAK);  // 序号不连续，NAK 让发送端重发期望的包
+        return -EBADMSG;
+    }
+
+    /* 会话已结束（批量传输完成或被取消），丢弃之后的数据 */
+    if (!boot_has_flag(BOOT_FLAG_IAP_YMODEM_RECV_DATA))
+        return -ECANCELED;
+
+    return 0;
+}
+
+/**
+ * @brief   Ymodem 协议接收数据
+ * @details 数据先经过帧重组，数据包被拆成多段或多个包合并成一段时都能正确接收
+ * @param[in] data 接收数据的首地址
+ * @param[in] len  接收数据的长度
+ */
+void boot_ymodem_recv_data(uint8_t *data, uint32_t len)
+{
+    boot_xmodem_framer_feed(data, len, boot_ymodem_handle_frame);
+}
@@ -0,0 +1,23 @@
+#ifndef BOOT_YMODEM_H
+#define BOOT_YMODEM_H
+
+#include <stdint.h>
+
+/**
+ * @brief   Ymodem 协议初始化
+ */
+void boot_ymodem_init(void);
+
+/**
+ * @brief   Ymodem 协议发 C
+ */
+void boot_ymodem_send_c(void);
+
+/**
+ * @brief   Ymodem 协议接收数据
+ * @param[in] data 接收数据的首地址
+ * @param[in] len  接收数据的长度
+ */
+void boot_ymodem_recv_data(uint8_t *data, uint32_t len);
+
+#endif
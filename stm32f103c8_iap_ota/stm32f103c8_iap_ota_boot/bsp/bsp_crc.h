@@ -0,0 +1,23 @@
+#ifndef BSP_CRC_H
+#define BSP_CRC_H
+
+#include <stdint.h>
+
+typedef struct bsp_crc bsp_crc_t;
+
+/* 操作接口 */
+typedef struct {
+    int (*init)(bsp_crc_t *self);
+    uint32_t (*calc)(bsp_crc_t *self, const uint32_t *data, uint32_t cnt);
+} bsp_crc_ops_t;
+
+/* 设备实例结构体 */
+struct bsp_crc {
+    const bsp_crc_ops_t *ops;
+    void *drv;  /* 指向底层驱动对象 */
+};
+
+/* 获取 BSP 单例对象 */
+bsp_crc_t *bsp_crc_get(void);
+
+#endif  /* BSP_CRC_H */
@@ -4,18 +4,28 @@
 #include <errno.h>
 
 /**
- * @brief   BSP 初始化延时
+ * @brief   BSP 初始化延时，启动 1ms 周期的 SysTick 时基
  * @param[in] self 指向 BSP 对象的指针
  * @return  0 表示成功，其他值表示失败
  */
 static int bsp_delay_init_impl(bsp_delay_t *self)
 {
-    return 0;
+    return delay_tick_init();
+}
+
+/**
+ * @brief   BSP 关闭延时时基，停止 SysTick 及其中断
+ * @param[in] self 指向 BSP 对象的指针
+ */
+static void bsp_delay_deinit_impl(bsp_delay_t *self)
+{
+    delay_tick_deinit();
 }
 
 /* --- 操作表 --- */
 static const bsp_delay_ops_t bsp_delay_ops = {
-    .init = bsp_delay_init_impl
+    .init   = bsp_delay_init_impl,
+    .deinit = bsp_delay_deinit_impl,
 };
 
 /* --- 单例对象 --- */
@@ -54,3 +64,12 @@ void bsp_delay_ms(uint32_t ms)
 {
     delay_ms(ms);
 }
+
+/**
+ * @brief   获取毫秒时基计数
+ * @return  时基启动后经过的毫秒数，比较先后应使用 (int32_t)(a - b) 的差值
+ */
+uint32_t bsp_delay_get_tick_ms(void)
+{
+    return delay_get_tick_ms();
+}
@@ -23,6 +23,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f10x_it.h"
+#include "drv_delay.h"
 
 /** @addtogroup STM32F10x_StdPeriph_Template
   * @{
@@ -132,8 +133,9 @@ void PendSV_Handler(void)
   * @param  None
   * @retval None
   */
-void SysTick_Handler(void)
+DRV_RAMFUNC void SysTick_Handler(void)
 {
+  delay_tick_inc();
 }
 
 /******************************************************************************/
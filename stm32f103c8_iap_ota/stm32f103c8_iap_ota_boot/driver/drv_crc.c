@@ -0,0 +1,193 @@
+#include "drv_crc.h"
+#include <stddef.h>
+#include <errno.h>
+
+#define CRC_DMA_MAX_WORDS   0xFFFF      // DMA 一次传输的最大数据项数（计数寄存器为 16 位）
+
+static uint32_t crc_calc_impl(crc_dev_t *dev, const uint32_t *data, uint32_t cnt);
+static int crc_deinit_impl(crc_dev_t *dev);
+
+/* 操作接口表 */
+static const crc_ops_t crc_ops = {
+	.calc   = crc_calc_impl,
+	.deinit = crc_deinit_impl
+};
+
+/**
+ * @brief   初始化硬件 CRC 驱动
+ * @details 打开 CRC 单元时钟，启用 DMA 送数时同时打开所用 DMA 控制器的时钟
+ * @param[out] dev crc_dev_t 结构体指针
+ * @return	0 表示成功，其他值表示失败
+ */
+int drv_crc_init(crc_dev_t *dev)
+{
+	if (!dev)
+        return -EINVAL;
+
+#if DRV_CRC_PLATFORM_STM32F1
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_CRC, ENABLE);
+#if DRV_CRC_USE_DMA
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+#endif
+
+#elif DRV_CRC_PLATFORM_STM32F4
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_CRC, ENABLE);
+#if DRV_CRC_USE_DMA
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+#endif
+
+#elif DRV_CRC_PLATFORM_GD32F1
+	rcu_periph_clock_enable(RCU_CRC);
+#if DRV_CRC_USE_DMA
+	rcu_periph_clock_enable(RCU_DMA0);
+#endif
+#endif
+
+	dev->ops = &crc_ops;
+	return 0;
+}
+
+#if DRV_CRC_USE_DMA
+/**
+ * @brief   用 DMA 存储器到存储器传输把一段字送入 CRC 数据寄存器
+ * @details 源地址递增、目的地址固定为 CRC 数据寄存器，按字传输，轮询传输完成标志
+ * @param[in] data  数据首地址（4 字节对齐）
+ * @param[in] words 字数，不超过 CRC_DMA_MAX_WORDS
+ */
+static void crc_dma_feed(const uint32_t *data, uint32_t words)
+{
+#if DRV_CRC_PLATFORM_STM32F1
+	DMA_InitTypeDef DMA_InitStructure;
+
+	DMA_DeInit(DMA1_Channel1);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&CRC->DR;				// 目的地址为 CRC 数据寄存器
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;		// 外设数据宽度为32位
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;			// 外设地址寄存器不变
+	DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)data;						// 源地址为待计算的数据
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;				// 内存数据宽度为32位
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;						// 内存地址寄存器递增
+	DMA_InitStructure.DMA_BufferSize = words;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;							// 从内存读取写入外设
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Enable;									// 存储器到存储器，不等待外设请求
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+	DMA_Init(DMA1_Channel1, &DMA_InitStructure);
+
+	DMA_Cmd(DMA1_Channel1, ENABLE);
+	while (DMA_GetFlagStatus(DMA1_FLAG_TC1) == RESET);
+	DMA_ClearFlag(DMA1_FLAG_GL1);
+	DMA_Cmd(DMA1_Channel1, DISABLE);
+
+#elif DRV_CRC_PLATFORM_STM32F4
+	DMA_InitTypeDef DMA_InitStructure;
+
+	/* F4 存储器到存储器只能用 DMA2，源地址为“外设”端口，且不能使用直接模式 */
+	DMA_DeInit(DMA2_Stream0);
+	DMA_InitStructure.DMA_Channel = DMA_Channel_0;
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)data;					// 源地址为待计算的数据
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;		// 外设数据宽度为32位
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Enable;				// 源地址递增
+	DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)&CRC->DR;					// 目的地址为 CRC 数据寄存器
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;				// 内存数据宽度为32位
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Disable;					// 目的地址不变
+	DMA_InitStructure.DMA_BufferSize = words;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToMemory;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+	DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
+	DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+	DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+	DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+	DMA_Init(DMA2_Stream0, &DMA_InitStructure);
+
+	DMA_Cmd(DMA2_Stream0, ENABLE);
+	while (DMA_GetFlagStatus(DMA2_Stream0, DMA_FLAG_TCIF0) == RESET);
+	DMA_ClearFlag(DMA2_Stream0, DMA_FLAG_TCIF0 | DMA_FLAG_HTIF0 | DMA_FLAG_TEIF0 |
+	                            DMA_FLAG_DMEIF0 | DMA_FLAG_FEIF0);
+	DMA_Cmd(DMA2_Stream0, DISABLE);
+
+#elif DRV_CRC_PLATFORM_GD32F1
+	dma_parameter_struct dma_init_struct;
+
+	dma_deinit(DMA0, DMA_CH0);
+	dma_struct_para_init(&dma_init_struct);
+	dma_init_struct.periph_addr  = (uint32_t)&CRC_DATA;						// 目的地址为 CRC 数据寄存器
+	dma_init_struct.periph_width = DMA_PERIPHERAL_WIDTH_32BIT;
+	dma_init_struct.periph_inc   = DMA_PERIPH_INCREASE_DISABLE;
+	dma_init_struct.memory_addr  = (uint32_t)data;							// 源地址为待计算的数据
+	dma_init_struct.memory_width = DMA_MEMORY_WIDTH_32BIT;
+	dma_init_struct.memory_inc   = DMA_MEMORY_INCREASE_ENABLE;
+	dma_init_struct.number       = words;
+	dma_init_struct.direction    = DMA_MEMORY_TO_PERIPHERAL;
+	dma_init_struct.priority     = DMA_PRIORITY_MEDIUM;
+	dma_init(DMA0, DMA_CH0, &dma_init_struct);
+	dma_memory_to_memory_enable(DMA0, DMA_CH0);
+
+	dma_channel_enable(DMA0, DMA_CH0);
+	while (dma_flag_get(DMA0, DMA_CH0, DMA_FLAG_FTF) == RESET);
+	dma_flag_clear(DMA0, DMA_CH0, DMA_FLAG_G);
+	dma_channel_disable(DMA0, DMA_CH0);
+#endif
+}
+#endif
+
+/**
+ * @brief   计算一段数据的 CRC32
+ * @details 硬件 CRC 单元（多项式 0x04C11DB7，初值 0xFFFFFFFF，不反转，无结果异或），每次计算前复位数据寄存器。
+ *          CRC 单元按字从高位到低位处理，与逐字节计算的 CRC32/MPEG-2 结果不同，只能与同一单元算出的值比较。
+ * @param[in] dev  crc_dev_t 结构体指针
+ * @param[in] data 数据首地址（4 字节对齐，可以是 SRAM 或 Flash）
+ * @param[in] cnt  数据字节数（4 的倍数）
+ * @return	CRC32 值
+ */
+static uint32_t crc_calc_impl(crc_dev_t *dev, const uint32_t *data, uint32_t cnt)
+{
+	uint32_t words = cnt / 4;
+#if DRV_CRC_USE_DMA
+	uint32_t n;
+#endif
+	(void)dev;
+
+#if DRV_CRC_PLATFORM_STM32F1 || DRV_CRC_PLATFORM_STM32F4
+	CRC_ResetDR();
+#if DRV_CRC_USE_DMA
+	while (words) {
+		n = words > CRC_DMA_MAX_WORDS ? CRC_DMA_MAX_WORDS : words;
+		crc_dma_feed(data, n);
+		data  += n;
+		words -= n;
+	}
+	return CRC_GetCRC();
+#else
+	return CRC_CalcBlockCRC((uint32_t *)data, words);
+#endif
+
+#elif DRV_CRC_PLATFORM_GD32F1
+	crc_data_register_reset();
+#if DRV_CRC_USE_DMA
+	while (words) {
+		n = words > CRC_DMA_MAX_WORDS ? CRC_DMA_MAX_WORDS : words;
+		crc_dma_feed(data, n);
+		data  += n;
+		words -= n;
+	}
+	return crc_data_register_read();
+#else
+	return crc_block_data_calculate((uint32_t *)data, words);
+#endif
+#endif
+}
+
+/**
+ * @brief   去初始化硬件 CRC
+ * @param[in] dev crc_dev_t 结构体指针
+ * @return	0 表示成功，其他值表示失败
+ */
+static int crc_deinit_impl(crc_dev_t *dev)
+{
+    if (!dev)
+		return -EINVAL;
+
+	dev->ops = NULL;
+	return 0;
+}
@@ -0,0 +1,54 @@
+#ifndef DRV_CRC_H
+#define DRV_CRC_H
+
+#include <stdint.h>
+
+#if defined(STM32F10X_HD) || defined(STM32F10X_MD)
+#define DRV_CRC_PLATFORM_STM32F1 1
+#include "stm32f10x.h"
+
+#elif defined(STM32F40_41xxx) || defined(STM32F429_439xx) || defined(STM32F411xE)
+#define DRV_CRC_PLATFORM_STM32F4 1
+#include "stm32f4xx.h"
+
+#elif defined (GD32F10X_MD) || defined (GD32F10X_HD)
+#define DRV_CRC_PLATFORM_GD32F1 1
+#include "gd32f10x.h"
+
+#else
+#error drv_crc.h: No processor defined!
+#endif
+
+#ifndef EINVAL
+#define EINVAL 22
+#endif
+
+/*
+ * 用 DMA 存储器到存储器传输把数据送入 CRC 数据寄存器，CPU 只等待传输完成；0 表示由 CPU 逐字写入。
+ * 占用的通道：F1 为 DMA1 通道 1，F4 为 DMA2 数据流 0，GD32 为 DMA0 通道 0
+ */
+#ifndef DRV_CRC_USE_DMA
+#define DRV_CRC_USE_DMA  0
+#endif
+
+typedef struct crc_dev crc_dev_t;
+
+/* 操作接口结构体 */
+typedef struct {
+	uint32_t (*calc)(crc_dev_t *dev, const uint32_t *data, uint32_t cnt);
+	int (*deinit)(crc_dev_t *dev);
+} crc_ops_t;
+
+/* 设备结构体 */
+struct crc_dev {
+	const crc_ops_t *ops;
+};
+
+/**
+ * @brief   初始化硬件 CRC 驱动
+ * @param[out] dev crc_dev_t 结构体指针
+ * @return	0 表示成功，其他值表示失败
+ */
+int drv_crc_init(crc_dev_t *dev);
+
+#endif
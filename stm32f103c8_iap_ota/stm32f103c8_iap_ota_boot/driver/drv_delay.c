@@ -1,5 +1,6 @@
 #include "drv_delay.h"
 #include <stddef.h>
+#include <errno.h>
 
 #if defined (STM32F10X_LD) || defined (STM32F10X_LD_VL) || defined (STM32F10X_MD) || defined (STM32F10X_MD_VL) || \
     defined (STM32F10X_HD) || defined (STM32F10X_HD_VL) || defined (STM32F10X_XL) || defined (STM32F10X_CL) 
@@ -21,6 +22,78 @@
 /* 系统主频 */
 extern uint32_t SystemCoreClock;
 
+static volatile uint32_t delay_tick_ms;     // 毫秒时基计数，由 SysTick 中断累加
+static volatile uint8_t  delay_tick_running; // SysTick 是否作为 1ms 周期时基运行
+
+/**
+ * @brief   启动 1ms 周期的 SysTick 时基
+ * @details 启动后 SysTick 连续计数并每毫秒产生一次中断，需要在 SysTick_Handler 中调用 delay_tick_inc。
+ *          delay_us 改为读取 SysTick 当前值计算经过的时间，不再重装计数器。
+ * @return  0 表示成功，其他值表示失败
+ */
+int delay_tick_init(void)
+{
+    delay_tick_ms = 0;
+    if (SysTick_Config(SystemCoreClock / 1000))
+        return -EINVAL;     // 重装值超出 24 位
+
+    delay_tick_running = 1;
+    return 0;
+}
+
+/**
+ * @brief   停止 SysTick 时基，关闭计数器和中断，清除挂起的 SysTick 异常
+ * @details 跳转 APP 前调用，保证 APP 启动时 SysTick 处于复位状态
+ */
+void delay_tick_deinit(void)
+{
+    SysTick->CTRL = 0;
+    SysTick->LOAD = 0;
+    SysTick->VAL = 0;
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+    delay_tick_running = 0;
+}
+
+/**
+ * @brief   毫秒时基加 1，在 SysTick_Handler 中调用
+ * @details 放在 SRAM 中执行，写内部 Flash 期间 SysTick 中断不会因取指而被挂起
+ */
+DRV_RAMFUNC void delay_tick_inc(void)
+{
+    delay_tick_ms++;
+}
+
+/**
+ * @brief   获取毫秒时基计数
+ * @details 计数约 49.7 天回绕一次，比较时间先后应使用 (int32_t)(a - b) 的差值
+ * @return  delay_tick_init 之后经过的毫秒数，时基未启动时不增长
+ */
+uint32_t delay_get_tick_ms(void)
+{
+    return delay_tick_ms;
+}
+
+/**
+ * @brief   在连续运行的 SysTick 上延时，累加两次读数之间经过的计数值，不修改 SysTick 配置
+ * @param[in] ticks 延时的 SysTick 计数值
+ */
+static void delay_ticks_free_running(uint32_t ticks)
+{
+    uint32_t reload = SysTick->LOAD + 1;
+    uint32_t last = SysTick->VAL;
+    uint32_t now;
+    uint32_t elapsed = 0;
+
+    while (elapsed < ticks) {
+        now = SysTick->VAL;
+        if (now <= last)
+            elapsed += last - now;
+        else
+            elapsed += last + reload - now;    // 计数器已重装
+        last = now;
+    }
+}
+
 /**
  * @brief   微秒级延时
  * @param[in] us 延时微秒数
@@ -32,6 +105,11 @@ void delay_us(uint32_t us)
     
     uint32_t tmp;
     
+    if (delay_tick_running) {
+        delay_ticks_free_running(us * (SystemCoreClock / 1000000));
+        return;
+    }
+
     SysTick->CTRL |= SysTick_CTRL_CLKSOURCE_Msk;            // 使用系统主频作为SysTick的时钟源
     SysTick->LOAD = us * (SystemCoreClock / 1000000) - 1;   // 设置倒计时初始值
     SysTick->VAL = 0x00;                                    // 清空计数器，确保从头计时
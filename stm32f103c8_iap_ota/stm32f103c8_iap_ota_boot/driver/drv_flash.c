@@ -5,18 +5,81 @@
 static int flash_erase_page_impl(flash_dev_t *dev, uint16_t cnt, uint16_t idx);
 static int flash_erase_sector_impl(flash_dev_t *dev, uint16_t cnt, uint8_t idx);
 static int flash_write_impl(flash_dev_t *dev, uint32_t addr, uint32_t cnt, uint32_t *data);
+static int flash_write_start_impl(flash_dev_t *dev, uint32_t addr, uint32_t cnt, const uint32_t *data);
+static int flash_write_poll_impl(flash_dev_t *dev);
 static int flash_deinit_impl(flash_dev_t *dev);
 
+#if DRV_FLASH_FAST_PROGRAM
+static int flash_fast_erase(uint32_t unit);
+#endif
+
+/* 异步写入状态，write_start 启动、write_poll 查询 */
+typedef struct {
+	bool busy;      // DMA 编程进行中
+	int  ret;       // 最近一次异步写入的结果
+} flash_async_t;
+
+static flash_async_t flash_async;
+
 /* 操作接口表 */
 static const flash_ops_t flash_ops = {
 	.page_erase   = flash_erase_page_impl,
 	.sector_erase = flash_erase_sector_impl,
 	.write        = flash_write_impl,
+	.write_start  = flash_write_start_impl,
+	.write_poll   = flash_write_poll_impl,
 	.deinit       = flash_deinit_impl
 };
 
+#define FLASH_BASE_ADDR         0x08000000UL
+#if DRV_FLASH_PLATFORM_STM32F4
+#define FLASH_SIZE_REG_ADDR     0x1FFF7A22UL    // Flash 容量寄存器 F_SIZE（单位 KB）
+#else
+#define FLASH_SIZE_REG_ADDR     0x1FFFF7E0UL
+#endif
+#define FLASH_SIZE_DEFAULT_KB   64              // 容量寄存器无效时按 64KB 处理
+
+/* F1 器件 ID：大容量、超大容量、互联型为 2KB 页，小/中容量为 1KB 页 */
+#define FLASH_DEV_ID_F1_HD      0x414
+#define FLASH_DEV_ID_F1_XL      0x430
+#define FLASH_DEV_ID_F1_CL      0x418
+
+/**
+ * @brief   读取 Flash 容量寄存器和器件 ID，得到 Flash 几何信息
+ * @details F1 的 DBGMCU_IDCODE 在未连接调试器时可能读出 0（勘误手册），此时按容量判断页大小：
+ *          超过 128KB 的只有大容量/超大容量/互联型，均为 2KB 页。GD32F10x 同样是中容量 1KB 页、
+ *          超过 128KB 的大容量/互联型 2KB 页。
+ * @param[out] info Flash 几何信息
+ */
+static void flash_probe(flash_info_t *info)
+{
+	uint32_t size_kb = *(volatile uint16_t *)FLASH_SIZE_REG_ADDR;
+
+	if (size_kb == 0 || size_kb == 0xFFFF)
+		size_kb = FLASH_SIZE_DEFAULT_KB;
+
+	info->base = FLASH_BASE_ADDR;
+	info->size = size_kb * 1024;
+
+#if DRV_FLASH_PLATFORM_STM32F1
+	info->dev_id = DBGMCU->IDCODE & DBGMCU_IDCODE_DEV_ID;
+	if (info->dev_id == FLASH_DEV_ID_F1_HD || info->dev_id == FLASH_DEV_ID_F1_XL ||
+	    info->dev_id == FLASH_DEV_ID_F1_CL || size_kb > 128)
+		info->page_size = 2048;
+	else
+		info->page_size = 1024;
+#elif DRV_FLASH_PLATFORM_STM32F4
+	info->dev_id = DBGMCU->IDCODE & DBGMCU_IDCODE_DEV_ID;
+	info->page_size = 0;
+#elif DRV_FLASH_PLATFORM_GD32F1
+	info->dev_id = 0;
+	info->page_size = size_kb > 128 ? 2048 : 1024;
+#endif
+}
+
 /**
  * @brief   初始化内部 Flash 驱动
+ * @details 同时读取 Flash 几何信息，页擦除按实际页大小计算地址
  * @param[out] dev flash_dev_t 结构体指针
  * @return	0 表示成功，其他值表示失败
  */	
@@ -25,6 +88,7 @@ int drv_flash_init(flash_dev_t *dev)
 	if (!dev)
         return -EINVAL;
 
+	flash_probe(&dev->info);
 	dev->ops = &flash_ops;
 	return 0;
 }
@@ -32,7 +96,7 @@ int drv_flash_init(flash_dev_t *dev)
 
 /**
  * @brief   内部 Flash 页擦除
- * @details 以 GD32F10x_MD 为例，Flash 为 64KB，闪存页大小为 1KB，共 64 页
+ * @details 页地址按初始化时读到的页大小计算，中容量 1KB 页，大容量 2KB 页
  * @param[in] dev w25qx_dev_t 结构体指针
  * @param[in] cnt 擦除页的数量
  * @param[in] idx 擦除页的起始索引
@@ -44,16 +108,18 @@ static int flash_erase_page_impl(flash_dev_t *dev, uint16_t cnt, uint16_t idx)
 	uint16_t i;
     uint32_t addr;
 
-    (void)dev;
-
 #if DRV_FLASH_PLATFORM_STM32F1
 	FLASH_Unlock();
 	FLASH_ClearFlag(FLASH_FLAG_BSY      |
                     FLASH_FLAG_PGERR    |
                     FLASH_FLAG_WRPRTERR);
 	for (i = 0; i < cnt; i++) {
-		addr = 0x08000000 + (idx + i) * 1024;
+		addr = dev->info.base + (idx + i) * dev->info.page_size;
+#if DRV_FLASH_FAST_PROGRAM
+		if (flash_fast_erase(addr)) {
+#else
 		if (FLASH_ErasePage(addr) != FLASH_COMPLETE) {
+#endif
             FLASH_Lock();
             return -EIO;
         }
@@ -62,9 +128,16 @@ static int flash_erase_page_impl(flash_dev_t *dev, uint16_t cnt, uint16_t idx)
 
 #elif DRV_FLASH_PLATFORM_GD32F1
 	fmc_unlock();
+#if DRV_FLASH_FAST_PROGRAM
+    FMC_STAT0 = FMC_STAT0_ENDF | FMC_STAT0_WPERR | FMC_STAT0_PGERR;   // 写 1 清除状态标志
+#endif
 	for (i = 0; i < cnt; i++) {
-		addr = 0x08000000 + (idx + i) * 1024;
+		addr = dev->info.base + (idx + i) * dev->info.page_size;
+#if DRV_FLASH_FAST_PROGRAM
+		if (flash_fast_erase(addr)) {
+#else
 		if (fmc_page_erase(addr) != FMC_READY) {
+#endif
             fmc_lock();
             return -EIO;
         }
@@ -75,6 +148,7 @@ static int flash_erase_page_impl(flash_dev_t *dev, uint16_t cnt, uint16_t idx)
 	return 0;
 
 #else
+	(void)dev;
 	return -EINVAL;
 #endif
 }
@@ -91,7 +165,9 @@ static int flash_erase_sector_impl(flash_dev_t *dev, uint16_t cnt, uint8_t idx)
 {
 #if DRV_FLASH_PLATFORM_STM32F4
 	uint8_t i;
+#if !DRV_FLASH_FAST_PROGRAM
     FLASH_Status status;
+#endif
 	uint32_t sector;
 	static const uint32_t sector_tbl[] = {
 		FLASH_Sector_0, FLASH_Sector_1, FLASH_Sector_2, FLASH_Sector_3,
@@ -108,8 +184,12 @@ static int flash_erase_sector_impl(flash_dev_t *dev, uint16_t cnt, uint8_t idx)
 
     for (i = 0; i < cnt; i++) {
 		sector = sector_tbl[idx + i];
+#if DRV_FLASH_FAST_PROGRAM
+        if (flash_fast_erase(sector)) {
+#else
         status = FLASH_EraseSector(sector, VoltageRange_3);
         if (status != FLASH_COMPLETE) {
+#endif
             FLASH_Lock();
             return -EIO;
         }
@@ -122,8 +202,168 @@ static int flash_erase_sector_impl(flash_dev_t *dev, uint16_t cnt, uint8_t idx)
 #endif
 }
 
+#if DRV_FLASH_FAST_PROGRAM
+#define FLASH_FAST_ERR_CHECK_SIZE   1024UL          // 每编程多少字节检查一次错误标志
+#define FLASH_FAST_PROG_TIMEOUT     0x000B0000UL    // 编程时等待 BSY 清零的最大轮询次数（与标准库 ProgramTimeout 一致）
+#if DRV_FLASH_PLATFORM_STM32F4
+#define FLASH_FAST_ERASE_TIMEOUT    0xFFFFFFFFUL    // F4 扇区擦除最长约 2s（128KB 扇区），标准库不设超时
+#else
+#define FLASH_FAST_ERASE_TIMEOUT    0x000B0000UL    // 页擦除时等待 BSY 清零的最大轮询次数（与标准库 EraseTimeout 一致）
+#endif
+
+/*
+ * 以下 flash_fast_* 函数放在 SRAM 中执行（DRV_RAMFUNC）：擦除/编程期间 CPU 从 Flash 取指会被挂起到操作结束，
+ * 在 SRAM 中轮询 BSY 时，中断向量表和串口空闲中断也在 SRAM 中，DMA 接收的分段处理不会被推迟。
+ * 这些函数内只访问寄存器和 RAM 中的数据，不能调用标准库或其他放在 Flash 中的函数。
+ */
+
+/**
+ * @brief   等待当前擦除/编程操作完成，直接轮询状态寄存器的 BSY 位
+ * @param[in] timeout 最大轮询次数
+ * @return	0 表示完成，-ETIMEDOUT 表示超时
+ */
+DRV_RAMFUNC static int flash_fast_wait_busy(uint32_t timeout)
+{
+#if DRV_FLASH_PLATFORM_STM32F1 || DRV_FLASH_PLATFORM_STM32F4
+    while (FLASH->SR & FLASH_SR_BSY) {
+#elif DRV_FLASH_PLATFORM_GD32F1
+    while (FMC_STAT0 & FMC_STAT0_BUSY) {
+#endif
+        if (--timeout == 0)
+            return -ETIMEDOUT;
+    }
+    return 0;
+}
+
+/**
+ * @brief   检查编程错误标志（写保护、编程错误、对齐/并行度/顺序错误）
+ * @return	0 表示无错误，-EIO 表示编程失败
+ */
+DRV_RAMFUNC static int flash_fast_check_error(void)
+{
+#if DRV_FLASH_PLATFORM_STM32F1
+    if (FLASH->SR & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR))
+        return -EIO;
+#elif DRV_FLASH_PLATFORM_STM32F4
+    if (FLASH->SR & (FLASH_SR_WRPERR | FLASH_SR_PGAERR | FLASH_SR_PGPERR | FLASH_SR_PGSERR))
+        return -EIO;
+#elif DRV_FLASH_PLATFORM_GD32F1
+    if (FMC_STAT0 & (FMC_STAT0_PGERR | FMC_STAT0_WPERR))
+        return -EIO;
+#endif
+    return 0;
+}
+
+/**
+ * @brief   寄存器级快速编程，调用前 Flash 已解锁并清除状态标志
+ * @details 标准库每写一个字都要先等待上一次操作、置位 PG、再等待完成并清除 PG，F1 上还拆成两次半字编程各走一遍。
+ *          这里整段数据只置位一次 PG（F4 同时设置 32 位并行度 PSIZE），每个编程单元写入后只轮询 BSY，
+ *          每 FLASH_FAST_ERR_CHECK_SIZE 字节和结束时检查一次错误标志。
+ *          F1 按半字编程，GD32/F4 按字编程，目标单元中已经是要写入的值时跳过。
+ * @param[in] addr 起始地址（4 字节对齐）
+ * @param[in] cnt  写入字节数（4 的倍数）
+ * @param[in] data 要写入的数据
+ * @return	0 表示成功，其他值表示失败
+ */
+DRV_RAMFUNC static int flash_fast_program(uint32_t addr, uint32_t cnt, const uint32_t *data)
+{
+    uint32_t i;
+    int ret = 0;
+
+#if DRV_FLASH_PLATFORM_STM32F1
+    volatile uint16_t *dst = (volatile uint16_t *)addr;
+    const uint16_t *src = (const uint16_t *)data;
+
+    FLASH->CR |= FLASH_CR_PG;
+    for (i = 0; i < cnt / 2; i++) {
+        if (dst[i] != src[i]) {
+            dst[i] = src[i];
+            ret = flash_fast_wait_busy(FLASH_FAST_PROG_TIMEOUT);
+            if (ret)
+                break;
+        }
+        if (((i + 1) * 2) % FLASH_FAST_ERR_CHECK_SIZE == 0) {
+            ret = flash_fast_check_error();
+            if (ret)
+                break;
+        }
+    }
+    FLASH->CR &= ~FLASH_CR_PG;
+
+#elif DRV_FLASH_PLATFORM_STM32F4 || DRV_FLASH_PLATFORM_GD32F1
+    volatile uint32_t *dst = (volatile uint32_t *)addr;
+
+#if DRV_FLASH_PLATFORM_STM32F4
+    FLASH->CR &= ~FLASH_CR_PSIZE;
+    FLASH->CR |= FLASH_PSIZE_WORD | FLASH_CR_PG;
+#else
+    FMC_CTL0 |= FMC_CTL0_PG;
+#endif
+    for (i = 0; i < cnt / 4; i++) {
+        if (dst[i] != data[i]) {
+            dst[i] = data[i];
+            ret = flash_fast_wait_busy(FLASH_FAST_PROG_TIMEOUT);
+            if (ret)
+                break;
+        }
+        if (((i + 1) * 4) % FLASH_FAST_ERR_CHECK_SIZE == 0) {
+            ret = flash_fast_check_error();
+            if (ret)
+                break;
+        }
+    }
+#if DRV_FLASH_PLATFORM_STM32F4
+    FLASH->CR &= ~FLASH_CR_PG;
+#else
+    FMC_CTL0 &= ~FMC_CTL0_PG;
+#endif
+#endif
+
+    if (!ret)
+        ret = flash_fast_check_error();
+    return ret;
+}
+
+/**
+ * @brief   寄存器级擦除一个页/扇区，调用前 Flash 已解锁并清除状态标志
+ * @param[in] unit F1/GD32 为页内任意地址，F4 为 FLASH_Sector_x（CR 寄存器 SNB 字段的值）
+ * @return	0 表示成功，其他值表示失败
+ */
+DRV_RAMFUNC static int flash_fast_erase(uint32_t unit)
+{
+    int ret;
+
+#if DRV_FLASH_PLATFORM_STM32F1
+    FLASH->CR |= FLASH_CR_PER;
+    FLASH->AR = unit;
+    FLASH->CR |= FLASH_CR_STRT;
+    ret = flash_fast_wait_busy(FLASH_FAST_ERASE_TIMEOUT);
+    FLASH->CR &= ~FLASH_CR_PER;
+
+#elif DRV_FLASH_PLATFORM_STM32F4
+    FLASH->CR &= ~(FLASH_CR_PSIZE | FLASH_CR_SNB);
+    FLASH->CR |= FLASH_PSIZE_WORD | FLASH_CR_SER | unit;
+    FLASH->CR |= FLASH_CR_STRT;
+    ret = flash_fast_wait_busy(FLASH_FAST_ERASE_TIMEOUT);
+    FLASH->CR &= ~(FLASH_CR_SER | FLASH_CR_SNB);
+
+#elif DRV_FLASH_PLATFORM_GD32F1
+    FMC_CTL0 |= FMC_CTL0_PER;
+    FMC_ADDR0 = unit;
+    FMC_CTL0 |= FMC_CTL0_START;
+    ret = flash_fast_wait_busy(FLASH_FAST_ERASE_TIMEOUT);
+    FMC_CTL0 &= ~FMC_CTL0_PER;
+#endif
+
+    if (!ret)
+        ret = flash_fast_check_error();
+    return ret;
+}
+#endif
+
 /**
  * @brief   写内部 Flash
+ * @details 目标字中已经是要写入的值时跳过该字，不重复编程（重复编程非 0 值在 F1 上会报 PGERR）
  * @param[in] dev  w25qx_dev_t 结构体指针
  * @param[in] addr 起始地址
  * @param[in] cnt  写入数据的数量（单位：字节）
@@ -132,7 +372,10 @@ static int flash_erase_sector_impl(flash_dev_t *dev, uint16_t cnt, uint8_t idx)
  */
 static int flash_write_impl(flash_dev_t *dev, uint32_t addr, uint32_t cnt, uint32_t *data)
 {
+#if !DRV_FLASH_FAST_PROGRAM
     uint32_t i;
+#endif
+    int ret = 0;
     (void)dev;
 
     /* 地址必须 4 字节对齐 */
@@ -150,13 +393,19 @@ static int flash_write_impl(flash_dev_t *dev, uint32_t addr, uint32_t cnt, uint3
                     FLASH_FLAG_PGERR |
                     FLASH_FLAG_WRPRTERR);
 
+#if DRV_FLASH_FAST_PROGRAM
+    ret = flash_fast_program(addr, cnt, data);
+#else
     for (i = 0; i < cnt; i += 4) {
+        if (*(volatile uint32_t *)(addr + i) == data[i / 4])
+            continue;
         FLASH_Status st = FLASH_ProgramWord(addr + i, data[i / 4]);
         if (st != FLASH_COMPLETE) {
             FLASH_Lock();
             return -EIO; /* 写入失败 */
         }
     }
+#endif
     FLASH_Lock();
 
 #elif DRV_FLASH_PLATFORM_STM32F4
@@ -165,30 +414,215 @@ static int flash_write_impl(flash_dev_t *dev, uint32_t addr, uint32_t cnt, uint3
                     FLASH_FLAG_WRPERR  | FLASH_FLAG_PGAERR |
                     FLASH_FLAG_PGPERR  | FLASH_FLAG_PGSERR);
 
+#if DRV_FLASH_FAST_PROGRAM
+    ret = flash_fast_program(addr, cnt, data);
+#else
     for (i = 0; i < cnt; i += 4) {
+        if (*(volatile uint32_t *)(addr + i) == data[i / 4])
+            continue;
         FLASH_Status st = FLASH_ProgramWord(addr + i, data[i / 4]);
         if (st != FLASH_COMPLETE) {
             FLASH_Lock();
             return -EIO;
         }
     }
+#endif
     FLASH_Lock();
 
 #elif DRV_FLASH_PLATFORM_GD32F1
     fmc_unlock();
 
+#if DRV_FLASH_FAST_PROGRAM
+    FMC_STAT0 = FMC_STAT0_ENDF | FMC_STAT0_WPERR | FMC_STAT0_PGERR;   // 写 1 清除状态标志
+    ret = flash_fast_program(addr, cnt, data);
+#else
     for (i = 0; i < cnt; i += 4) {
+        if (*(volatile uint32_t *)(addr + i) == data[i / 4])
+            continue;
         fmc_status_ecnt st = fmc_word_program(addr + i, data[i / 4]);
         if (st != FMC_READY) {
             fmc_lock();
             return -EIO;
         }
     }
+#endif
 
     fmc_lock();
 #endif
 
-    return 0;
+    return ret;
+}
+
+#if DRV_FLASH_DMA_PROGRAM && (DRV_FLASH_PLATFORM_STM32F1 || DRV_FLASH_PLATFORM_GD32F1)
+/**
+ * @brief   启动 DMA 半字编程，调用前 Flash 已解锁、清除状态标志并置位 PG
+ * @details DMA 把 SRAM 中的数据逐个半字写入 Flash，上一个半字编程期间（BSY）Flash 接口挂起下一次写访问，
+ *          DMA 传输因此自动按编程速度推进，不需要 CPU 逐个写入和轮询 BSY。
+ * @param[in] addr 起始地址
+ * @param[in] cnt  写入字节数
+ * @param[in] data 要写入的数据
+ */
+static void flash_dma_start(uint32_t addr, uint32_t cnt, const uint32_t *data)
+{
+#if DRV_FLASH_PLATFORM_STM32F1
+	DMA_InitTypeDef DMA_InitStructure;
+
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+	DMA_DeInit(DMA1_Channel2);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = addr;							// 目的地址为 Flash
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;	// Flash 按半字编程
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Enable;				// 目的地址递增
+	DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)data;						// 源地址为 SRAM 中的数据
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_BufferSize = cnt / 2;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;							// 从内存读取写入“外设”（Flash）
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Enable;									// 存储器到存储器，不等待外设请求
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Low;							// 低于串口接收 DMA
+	DMA_Init(DMA1_Channel2, &DMA_InitStructure);
+	DMA_Cmd(DMA1_Channel2, ENABLE);
+
+#elif DRV_FLASH_PLATFORM_GD32F1
+	dma_parameter_struct dma_init_struct;
+
+	rcu_periph_clock_enable(RCU_DMA0);
+	dma_deinit(DMA0, DMA_CH1);
+	dma_struct_para_init(&dma_init_struct);
+	dma_init_struct.periph_addr  = addr;									// 目的地址为 Flash
+	dma_init_struct.periph_width = DMA_PERIPHERAL_WIDTH_16BIT;				// Flash 按半字编程
+	dma_init_struct.periph_inc   = DMA_PERIPH_INCREASE_ENABLE;
+	dma_init_struct.memory_addr  = (uint32_t)data;							// 源地址为 SRAM 中的数据
+	dma_init_struct.memory_width = DMA_MEMORY_WIDTH_16BIT;
+	dma_init_struct.memory_inc   = DMA_MEMORY_INCREASE_ENABLE;
+	dma_init_struct.number       = cnt / 2;
+	dma_init_struct.direction    = DMA_MEMORY_TO_PERIPHERAL;
+	dma_init_struct.priority     = DMA_PRIORITY_LOW;						// 低于串口接收 DMA
+	dma_init(DMA0, DMA_CH1, &dma_init_struct);
+	dma_memory_to_memory_enable(DMA0, DMA_CH1);
+	dma_channel_enable(DMA0, DMA_CH1);
+#endif
+}
+
+/**
+ * @brief   查询 DMA 传输状态
+ * @return	0 表示传输完成，-EBUSY 表示传输中，-EIO 表示传输错误
+ */
+static int flash_dma_status(void)
+{
+#if DRV_FLASH_PLATFORM_STM32F1
+	if (DMA_GetFlagStatus(DMA1_FLAG_TE2) != RESET)
+		return -EIO;
+	if (DMA_GetFlagStatus(DMA1_FLAG_TC2) == RESET)
+		return -EBUSY;
+#elif DRV_FLASH_PLATFORM_GD32F1
+	if (dma_flag_get(DMA0, DMA_CH1, DMA_FLAG_ERR) != RESET)
+		return -EIO;
+	if (dma_flag_get(DMA0, DMA_CH1, DMA_FLAG_FTF) == RESET)
+		return -EBUSY;
+#endif
+	return 0;
+}
+
+/**
+ * @brief   停止 DMA 通道并清除标志
+ */
+static void flash_dma_stop(void)
+{
+#if DRV_FLASH_PLATFORM_STM32F1
+	DMA_Cmd(DMA1_Channel2, DISABLE);
+	DMA_ClearFlag(DMA1_FLAG_GL2);
+#elif DRV_FLASH_PLATFORM_GD32F1
+	dma_channel_disable(DMA0, DMA_CH1);
+	dma_flag_clear(DMA0, DMA_CH1, DMA_FLAG_G);
+#endif
+}
+#endif
+
+/**
+ * @brief   启动异步写内部 Flash
+ * @details F1/GD32 启用 DRV_FLASH_DMA_PROGRAM 时由 DMA 按半字编程，启动后立即返回，CPU 可以处理串口和协议，
+ *          完成后由 write_poll 检查错误并重新锁定 Flash；数据缓冲区在完成前不能修改，目标区域必须已擦除
+ *          （DMA 不能像 write 那样跳过已是目标值的单元）。其他情况同步写入，结果由 write_poll 返回。
+ * @param[in] dev  flash_dev_t 结构体指针
+ * @param[in] addr 起始地址（4 字节对齐）
+ * @param[in] cnt  写入字节数（4 的倍数）
+ * @param[in] data 要写入的数据
+ * @return	0 表示已启动，-EBUSY 表示上一次异步写入尚未完成，其他值表示失败
+ */
+static int flash_write_start_impl(flash_dev_t *dev, uint32_t addr, uint32_t cnt, const uint32_t *data)
+{
+	if (flash_async.busy)
+		return -EBUSY;
+
+	if ((addr & 0x3) || (cnt & 0x3))
+		return -EINVAL;
+
+#if DRV_FLASH_DMA_PROGRAM && (DRV_FLASH_PLATFORM_STM32F1 || DRV_FLASH_PLATFORM_GD32F1)
+	(void)dev;
+
+	if (cnt == 0) {
+		flash_async.ret = 0;
+		return 0;
+	}
+
+#if DRV_FLASH_PLATFORM_STM32F1
+	FLASH_Unlock();
+	FLASH_ClearFlag(FLASH_FLAG_BSY |
+                    FLASH_FLAG_EOP |
+                    FLASH_FLAG_PGERR |
+                    FLASH_FLAG_WRPRTERR);
+	FLASH->CR |= FLASH_CR_PG;
+#elif DRV_FLASH_PLATFORM_GD32F1
+	fmc_unlock();
+	FMC_STAT0 = FMC_STAT0_ENDF | FMC_STAT0_WPERR | FMC_STAT0_PGERR;   // 写 1 清除状态标志
+	FMC_CTL0 |= FMC_CTL0_PG;
+#endif
+
+	flash_async.busy = true;
+	flash_dma_start(addr, cnt, data);
+	return 0;
+#else
+	flash_async.ret = flash_write_impl(dev, addr, cnt, (uint32_t *)data);
+	return 0;
+#endif
+}
+
+/**
+ * @brief   查询异步写内部 Flash 是否完成
+ * @details DMA 传输完成后还要等待最后一个半字编程结束，之后检查错误标志、清除 PG 并锁定 Flash
+ * @param[in] dev flash_dev_t 结构体指针
+ * @return	0 表示已完成，-EBUSY 表示写入中，其他值表示写入失败
+ */
+static int flash_write_poll_impl(flash_dev_t *dev)
+{
+	(void)dev;
+
+	if (!flash_async.busy)
+		return flash_async.ret;
+
+#if DRV_FLASH_DMA_PROGRAM && (DRV_FLASH_PLATFORM_STM32F1 || DRV_FLASH_PLATFORM_GD32F1)
+	flash_async.ret = flash_dma_status();
+	if (flash_async.ret == -EBUSY)
+		return -EBUSY;
+
+	if (!flash_async.ret)
+		flash_async.ret = flash_fast_wait_busy(FLASH_FAST_PROG_TIMEOUT);
+	if (!flash_async.ret)
+		flash_async.ret = flash_fast_check_error();
+
+	flash_dma_stop();
+#if DRV_FLASH_PLATFORM_STM32F1
+	FLASH->CR &= ~FLASH_CR_PG;
+	FLASH_Lock();
+#elif DRV_FLASH_PLATFORM_GD32F1
+	FMC_CTL0 &= ~FMC_CTL0_PG;
+	fmc_lock();
+#endif
+	flash_async.busy = false;
+#endif
+
+	return flash_async.ret;
 }
 
 /**
@@ -24,19 +24,60 @@
 #define EIO 8
 #endif
 
+#ifndef ETIMEDOUT
+#define ETIMEDOUT 110
+#endif
+
+#ifndef EBUSY
+#define EBUSY 16
+#endif
+
+/* 放到 SRAM 中执行的函数，分散加载文件把 RAMCODE 段放到 RAM 执行域；未使用该分散加载文件的工程中仍在 Flash 中执行 */
+#ifndef DRV_RAMFUNC
+#define DRV_RAMFUNC __attribute__((section("RAMCODE")))
+#endif
+
+/* 寄存器级快速编程/擦除：整段数据只置位一次 PG/PSIZE，直接轮询 BSY，每页检查一次错误标志，轮询代码在 SRAM 中执行；0 表示使用标准库 */
+#ifndef DRV_FLASH_FAST_PROGRAM
+#define DRV_FLASH_FAST_PROGRAM  1
+#endif
+
+/*
+ * F1/GD32 用 DMA 存储器到存储器传输按半字编程（F1 为 DMA1 通道 2，GD32 为 DMA0 通道 1）：write_start 启动后立即返回，
+ * 由 write_poll 查询完成；目标区域必须已擦除。依赖寄存器级快速编程的错误检查；0 表示 write_start 同步写入
+ */
+#ifndef DRV_FLASH_DMA_PROGRAM
+#define DRV_FLASH_DMA_PROGRAM   0
+#endif
+
+#if DRV_FLASH_DMA_PROGRAM && !DRV_FLASH_FAST_PROGRAM
+#error drv_flash.h: DRV_FLASH_DMA_PROGRAM requires DRV_FLASH_FAST_PROGRAM!
+#endif
+
 typedef struct flash_dev flash_dev_t;
 
+/* 内部 Flash 几何信息，初始化时读取 Flash 容量寄存器和器件 ID 得到 */
+typedef struct {
+	uint32_t base;          // Flash 起始地址
+	uint32_t size;          // Flash 总字节数
+	uint32_t page_size;     // 页字节数，F4 按扇区擦除，为 0
+	uint16_t dev_id;        // DBGMCU_IDCODE 中的器件 ID，读不到时为 0
+} flash_info_t;
+
 /* 操作接口结构体 */
 typedef struct {
 	int (*page_erase)(flash_dev_t *dev, uint16_t cnt, uint16_t idx);
 	int (*sector_erase)(flash_dev_t *dev, uint16_t cnt, uint8_t idx);
 	int (*write)(flash_dev_t *dev, uint32_t addr, uint32_t cnt, uint32_t *data);
+	int (*write_start)(flash_dev_t *dev, uint32_t addr, uint32_t cnt, const uint32_t *data);
+	int (*write_poll)(flash_dev_t *dev);
 	int (*deinit)(flash_dev_t *dev);
 } flash_ops_t;
 
 /* 设备结构体 */
 struct flash_dev {
 	const flash_ops_t *ops;
+	flash_info_t info;
 };
 
 /**
@@ -246,6 +246,350 @@ static inline uint16_t spi_hw_recv_data(spi_periph_t spi_periph)
 #endif
 }
 
+/**
+ * @brief	SPI 发送寄存器是否为空（直接读寄存器，用于批量传输）
+ * @param[in] spi_periph SPI 外设
+ * @return	true 表示发送寄存器为空
+ */
+static inline bool spi_hw_tx_empty(spi_periph_t spi_periph)
+{
+#if DRV_SPI_PLATFORM_STM32F1 || DRV_SPI_PLATFORM_STM32F4
+	return (spi_periph->SR & SPI_I2S_FLAG_TXE) != 0;
+#elif DRV_SPI_PLATFORM_GD32F1
+	return (SPI_STAT(spi_periph) & SPI_FLAG_TBE) != 0;
+#endif
+}
+
+/**
+ * @brief	SPI 接收寄存器是否非空（直接读寄存器，用于批量传输）
+ * @param[in] spi_periph SPI 外设
+ * @return	true 表示接收寄存器非空
+ */
+static inline bool spi_hw_rx_not_empty(spi_periph_t spi_periph)
+{
+#if DRV_SPI_PLATFORM_STM32F1 || DRV_SPI_PLATFORM_STM32F4
+	return (spi_periph->SR & SPI_I2S_FLAG_RXNE) != 0;
+#elif DRV_SPI_PLATFORM_GD32F1
+	return (SPI_STAT(spi_periph) & SPI_FLAG_RBNE) != 0;
+#endif
+}
+
+/**
+ * @brief	SPI 是否正在传输（直接读寄存器，用于批量传输）
+ * @param[in] spi_periph SPI 外设
+ * @return	true 表示移位寄存器仍在工作
+ */
+static inline bool spi_hw_busy(spi_periph_t spi_periph)
+{
+#if DRV_SPI_PLATFORM_STM32F1 || DRV_SPI_PLATFORM_STM32F4
+	return (spi_periph->SR & SPI_I2S_FLAG_BSY) != 0;
+#elif DRV_SPI_PLATFORM_GD32F1
+	return (SPI_STAT(spi_periph) & SPI_FLAG_TRANS) != 0;
+#endif
+}
+
+/**
+ * @brief	SPI 写数据寄存器（直接写寄存器，用于批量传输）
+ * @param[in] spi_periph SPI 外设
+ * @param[in] data 		 发送的数据
+ */
+static inline void spi_hw_write_dr(spi_periph_t spi_periph, uint8_t data)
+{
+#if DRV_SPI_PLATFORM_STM32F1 || DRV_SPI_PLATFORM_STM32F4
+	spi_periph->DR = data;
+#elif DRV_SPI_PLATFORM_GD32F1
+	SPI_DATA(spi_periph) = data;
+#endif
+}
+
+/**
+ * @brief	SPI 读数据寄存器（直接读寄存器，用于批量传输）
+ * @param[in] spi_periph SPI 外设
+ * @return	接收的数据
+ */
+static inline uint8_t spi_hw_read_dr(spi_periph_t spi_periph)
+{
+#if DRV_SPI_PLATFORM_STM32F1 || DRV_SPI_PLATFORM_STM32F4
+	return (uint8_t)spi_periph->DR;
+#elif DRV_SPI_PLATFORM_GD32F1
+	return (uint8_t)SPI_DATA(spi_periph);
+#endif
+}
+
+/**
+ * @brief	SPI 读状态寄存器，配合读数据寄存器清除 OVR 标志
+ * @param[in] spi_periph SPI 外设
+ */
+static inline void spi_hw_read_sr(spi_periph_t spi_periph)
+{
+#if DRV_SPI_PLATFORM_STM32F1 || DRV_SPI_PLATFORM_STM32F4
+	(void)spi_periph->SR;
+#elif DRV_SPI_PLATFORM_GD32F1
+	(void)SPI_STAT(spi_periph);
+#endif
+}
+
+/* DMA 硬件信息结构体，接收、发送各占一个通道 */
+typedef struct {
+	spi_periph_t spi_periph;
+#if DRV_SPI_PLATFORM_STM32F1
+	DMA_Channel_TypeDef *rx_channel;
+	DMA_Channel_TypeDef *tx_channel;
+	uint32_t rx_tc_flag;		// 接收通道传输完成标志
+	uint32_t rx_te_flag;		// 接收通道传输错误标志
+	uint32_t tx_te_flag;		// 发送通道传输错误标志
+	uint32_t clear_flags;		// 两个通道的全局标志
+#elif DRV_SPI_PLATFORM_STM32F4
+	uint32_t dma_channel;
+	DMA_Stream_TypeDef *rx_stream;
+	DMA_Stream_TypeDef *tx_stream;
+	uint32_t rx_tc_flag;		// 接收数据流传输完成标志
+	uint32_t rx_te_flag;		// 接收数据流传输错误标志
+	uint32_t tx_te_flag;		// 发送数据流传输错误标志
+	uint32_t rx_clear_flags;	// 接收数据流的全部标志
+	uint32_t tx_clear_flags;	// 发送数据流的全部标志
+#elif DRV_SPI_PLATFORM_GD32F1
+	dma_channel_enum rx_channel;
+	dma_channel_enum tx_channel;
+#endif
+	uint8_t idx;
+} spi_dma_hw_info_t;
+
+/*
+ * SPI DMA 硬件信息列表。注意与其他外设共用的通道：
+ * F1 的 SPI1 接收与内部 Flash DMA 编程共用 DMA1 通道 2，SPI2 发送与 USART1 接收共用 DMA1 通道 5；
+ * GD32 的 SPI0 接收与内部 Flash DMA 编程共用 DMA0 通道 1，SPI1 发送与 USART0 接收共用 DMA0 通道 4；
+ * F4 的 SPI1 避开了 USART1 接收使用的 DMA2 数据流 5
+ */
+static const spi_dma_hw_info_t spi_dma_hw_info_table[] = {
+#if DRV_SPI_PLATFORM_STM32F1
+	{ SPI1, DMA1_Channel2, DMA1_Channel3, DMA1_FLAG_TC2, DMA1_FLAG_TE2, DMA1_FLAG_TE3, DMA1_FLAG_GL2 | DMA1_FLAG_GL3, 0 },
+	{ SPI2, DMA1_Channel4, DMA1_Channel5, DMA1_FLAG_TC4, DMA1_FLAG_TE4, DMA1_FLAG_TE5, DMA1_FLAG_GL4 | DMA1_FLAG_GL5, 1 },
+#elif DRV_SPI_PLATFORM_STM32F4
+	{ SPI1, DMA_Channel_3, DMA2_Stream0, DMA2_Stream3, DMA_FLAG_TCIF0, DMA_FLAG_TEIF0, DMA_FLAG_TEIF3,
+	  DMA_FLAG_TCIF0 | DMA_FLAG_HTIF0 | DMA_FLAG_TEIF0 | DMA_FLAG_DMEIF0 | DMA_FLAG_FEIF0,
+	  DMA_FLAG_TCIF3 | DMA_FLAG_HTIF3 | DMA_FLAG_TEIF3 | DMA_FLAG_DMEIF3 | DMA_FLAG_FEIF3, 0 },
+	{ SPI2, DMA_Channel_0, DMA1_Stream3, DMA1_Stream4, DMA_FLAG_TCIF3, DMA_FLAG_TEIF3, DMA_FLAG_TEIF4,
+	  DMA_FLAG_TCIF3 | DMA_FLAG_HTIF3 | DMA_FLAG_TEIF3 | DMA_FLAG_DMEIF3 | DMA_FLAG_FEIF3,
+	  DMA_FLAG_TCIF4 | DMA_FLAG_HTIF4 | DMA_FLAG_TEIF4 | DMA_FLAG_DMEIF4 | DMA_FLAG_FEIF4, 1 },
+#elif DRV_SPI_PLATFORM_GD32F1
+	{ SPI0, DMA_CH1, DMA_CH2, 0 },
+	{ SPI1, DMA_CH3, DMA_CH4, 1 },
+#endif
+};
+
+#define MAX_SPI_DMA_NUM	(sizeof(spi_dma_hw_info_table) / sizeof(spi_dma_hw_info_t))
+
+/* 不需要发送数据时 DMA 重复发送的字节，不需要接收数据时 DMA 重复写入的字节；放在 SRAM 中，F4 的 DMA1 不能访问 CCM */
+static uint8_t spi_dma_tx_dummy = 0xFF;
+static uint8_t spi_dma_rx_dummy;
+
+/**
+ * @brief	获取 SPI DMA 硬件信息
+ * @param[in] spi_periph SPI 外设
+ * @return	成功返回对应硬件信息指针，不支持 DMA 时返回 NULL
+ */
+static const spi_dma_hw_info_t *spi_get_dma_hw_info(spi_periph_t spi_periph)
+{
+	for (uint8_t i = 0; i < MAX_SPI_DMA_NUM; i++)
+		if (spi_dma_hw_info_table[i].spi_periph == spi_periph)
+			return &spi_dma_hw_info_table[i];
+	return NULL;
+}
+
+/**
+ * @brief	使能 DMA 时钟
+ * @param[in] hw_info DMA 硬件信息
+ */
+static void spi_hw_dma_clock_enable(const spi_dma_hw_info_t *hw_info)
+{
+#if DRV_SPI_PLATFORM_STM32F1
+	(void)hw_info;
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+#elif DRV_SPI_PLATFORM_STM32F4
+	if (hw_info->rx_stream < DMA2_Stream0)
+		RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA1, ENABLE);
+	else
+		RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+#elif DRV_SPI_PLATFORM_GD32F1
+	(void)hw_info;
+	rcu_periph_clock_enable(RCU_DMA0);
+#endif
+}
+
+/**
+ * @brief	启动一次 DMA 全双工传输
+ * @details 先使能接收通道再使能发送通道，SPI 的 DMA 请求也先开接收后开发送，保证第一个字节到达时接收通道已就绪；
+ *          tx 为 NULL 时发送通道地址不递增，重复发送 0xFF，rx 为 NULL 时接收通道地址不递增，丢弃接收数据
+ * @param[in]  hw_info DMA 硬件信息
+ * @param[in]  tx      发送的数据
+ * @param[out] rx      接收的数据
+ * @param[in]  len     数据长度，不超过 65535
+ */
+static void spi_hw_dma_start(const spi_dma_hw_info_t *hw_info, const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+	spi_periph_t spi_periph = hw_info->spi_periph;
+
+	spi_hw_read_dr(spi_periph);		// 丢弃之前残留的接收数据，避免 DMA 读到旧字节
+	spi_hw_read_sr(spi_periph);
+
+#if DRV_SPI_PLATFORM_STM32F1
+	DMA_InitTypeDef DMA_InitStructure;
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&spi_periph->DR;		// 外设基地址为 SPI 数据寄存器
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_BufferSize = len;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+
+	DMA_DeInit(hw_info->rx_channel);
+	DMA_InitStructure.DMA_MemoryBaseAddr = rx ? (uint32_t)rx : (uint32_t)&spi_dma_rx_dummy;
+	DMA_InitStructure.DMA_MemoryInc = rx ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;							// 从 SPI 读取写入内存
+	DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;						// 接收不及时会溢出丢字节
+	DMA_Init(hw_info->rx_channel, &DMA_InitStructure);
+
+	DMA_DeInit(hw_info->tx_channel);
+	DMA_InitStructure.DMA_MemoryBaseAddr = tx ? (uint32_t)tx : (uint32_t)&spi_dma_tx_dummy;
+	DMA_InitStructure.DMA_MemoryInc = tx ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;							// 从内存读取写入 SPI
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+	DMA_Init(hw_info->tx_channel, &DMA_InitStructure);
+
+	DMA_Cmd(hw_info->rx_channel, ENABLE);
+	DMA_Cmd(hw_info->tx_channel, ENABLE);
+	SPI_I2S_DMACmd(spi_periph, SPI_I2S_DMAReq_Rx, ENABLE);
+	SPI_I2S_DMACmd(spi_periph, SPI_I2S_DMAReq_Tx, ENABLE);
+
+#elif DRV_SPI_PLATFORM_STM32F4
+	DMA_InitTypeDef DMA_InitStructure;
+	DMA_InitStructure.DMA_Channel = hw_info->dma_channel;
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&spi_periph->DR;		// 外设基地址为 SPI 数据寄存器
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_BufferSize = len;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+	DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+	DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+	DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+
+	DMA_DeInit(hw_info->rx_stream);
+	DMA_InitStructure.DMA_Memory0BaseAddr = rx ? (uint32_t)rx : (uint32_t)&spi_dma_rx_dummy;
+	DMA_InitStructure.DMA_MemoryInc = rx ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;						// 从 SPI 读取写入内存
+	DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;						// 接收不及时会溢出丢字节
+	DMA_Init(hw_info->rx_stream, &DMA_InitStructure);
+
+	DMA_DeInit(hw_info->tx_stream);
+	DMA_InitStructure.DMA_Memory0BaseAddr = tx ? (uint32_t)tx : (uint32_t)&spi_dma_tx_dummy;
+	DMA_InitStructure.DMA_MemoryInc = tx ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;						// 从内存读取写入 SPI
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+	DMA_Init(hw_info->tx_stream, &DMA_InitStructure);
+
+	DMA_Cmd(hw_info->rx_stream, ENABLE);
+	DMA_Cmd(hw_info->tx_stream, ENABLE);
+	SPI_I2S_DMACmd(spi_periph, SPI_I2S_DMAReq_Rx, ENABLE);
+	SPI_I2S_DMACmd(spi_periph, SPI_I2S_DMAReq_Tx, ENABLE);
+
+#elif DRV_SPI_PLATFORM_GD32F1
+	dma_parameter_struct dma_init_struct;
+	dma_struct_para_init(&dma_init_struct);
+	dma_init_struct.periph_addr  = spi_periph + 0x0CU;			// 外设基地址为 SPI 数据寄存器，偏移0x0C
+	dma_init_struct.periph_width = DMA_PERIPHERAL_WIDTH_8BIT;
+	dma_init_struct.periph_inc   = DMA_PERIPH_INCREASE_DISABLE;
+	dma_init_struct.memory_width = DMA_MEMORY_WIDTH_8BIT;
+	dma_init_struct.number       = len;
+
+	dma_deinit(DMA0, hw_info->rx_channel);
+	dma_init_struct.memory_addr = rx ? (uint32_t)rx : (uint32_t)&spi_dma_rx_dummy;
+	dma_init_struct.memory_inc  = rx ? DMA_MEMORY_INCREASE_ENABLE : DMA_MEMORY_INCREASE_DISABLE;
+	dma_init_struct.direction   = DMA_PERIPHERAL_TO_MEMORY;		// 从 SPI 读取写入内存
+	dma_init_struct.priority    = DMA_PRIORITY_ULTRA_HIGH;		// 接收不及时会溢出丢字节
+	dma_init(DMA0, hw_info->rx_channel, &dma_init_struct);
+
+	dma_deinit(DMA0, hw_info->tx_channel);
+	dma_init_struct.memory_addr = tx ? (uint32_t)tx : (uint32_t)&spi_dma_tx_dummy;
+	dma_init_struct.memory_inc  = tx ? DMA_MEMORY_INCREASE_ENABLE : DMA_MEMORY_INCREASE_DISABLE;
+	dma_init_struct.direction   = DMA_MEMORY_TO_PERIPHERAL;		// 从内存读取写入 SPI
+	dma_init_struct.priority    = DMA_PRIORITY_MEDIUM;
+	dma_init(DMA0, hw_info->tx_channel, &dma_init_struct);
+
+	dma_circulation_disable(DMA0, hw_info->rx_channel);
+	dma_circulation_disable(DMA0, hw_info->tx_channel);
+	dma_channel_enable(DMA0, hw_info->rx_channel);
+	dma_channel_enable(DMA0, hw_info->tx_channel);
+	spi_dma_enable(spi_periph, SPI_DMA_RECEIVE);
+	spi_dma_enable(spi_periph, SPI_DMA_TRANSMIT);
+#endif
+}
+
+/**
+ * @brief	查询 DMA 传输状态，以接收通道完成为准（最后一个字节已经移入，总线空闲）
+ * @param[in] hw_info DMA 硬件信息
+ * @return	0 表示已完成，-EBUSY 表示传输中，-EIO 表示 DMA 传输错误
+ */
+static int spi_hw_dma_status(const spi_dma_hw_info_t *hw_info)
+{
+#if DRV_SPI_PLATFORM_STM32F1
+	if (DMA_GetFlagStatus(hw_info->rx_te_flag) != RESET || DMA_GetFlagStatus(hw_info->tx_te_flag) != RESET)
+		return -EIO;
+	if (DMA_GetFlagStatus(hw_info->rx_tc_flag) == RESET)
+		return -EBUSY;
+#elif DRV_SPI_PLATFORM_STM32F4
+	if (DMA_GetFlagStatus(hw_info->rx_stream, hw_info->rx_te_flag) != RESET ||
+		DMA_GetFlagStatus(hw_info->tx_stream, hw_info->tx_te_flag) != RESET)
+		return -EIO;
+	if (DMA_GetFlagStatus(hw_info->rx_stream, hw_info->rx_tc_flag) == RESET)
+		return -EBUSY;
+#elif DRV_SPI_PLATFORM_GD32F1
+	if (dma_flag_get(DMA0, hw_info->rx_channel, DMA_FLAG_ERR) != RESET ||
+		dma_flag_get(DMA0, hw_info->tx_channel, DMA_FLAG_ERR) != RESET)
+		return -EIO;
+	if (dma_flag_get(DMA0, hw_info->rx_channel, DMA_FLAG_FTF) == RESET)
+		return -EBUSY;
+#endif
+	return 0;
+}
+
+/**
+ * @brief	关闭 SPI 的 DMA 请求，停止 DMA 通道并清除标志
+ * @param[in] hw_info DMA 硬件信息
+ */
+static void spi_hw_dma_stop(const spi_dma_hw_info_t *hw_info)
+{
+	spi_periph_t spi_periph = hw_info->spi_periph;
+
+#if DRV_SPI_PLATFORM_STM32F1
+	SPI_I2S_DMACmd(spi_periph, SPI_I2S_DMAReq_Tx | SPI_I2S_DMAReq_Rx, DISABLE);
+	DMA_Cmd(hw_info->tx_channel, DISABLE);
+	DMA_Cmd(hw_info->rx_channel, DISABLE);
+	DMA_ClearFlag(hw_info->clear_flags);
+#elif DRV_SPI_PLATFORM_STM32F4
+	SPI_I2S_DMACmd(spi_periph, SPI_I2S_DMAReq_Tx | SPI_I2S_DMAReq_Rx, DISABLE);
+	DMA_Cmd(hw_info->tx_stream, DISABLE);
+	DMA_Cmd(hw_info->rx_stream, DISABLE);
+	while (DMA_GetCmdStatus(hw_info->tx_stream) != DISABLE);	// F4 的数据流要等 EN 清零后才能重新配置
+	while (DMA_GetCmdStatus(hw_info->rx_stream) != DISABLE);
+	DMA_ClearFlag(hw_info->tx_stream, hw_info->tx_clear_flags);
+	DMA_ClearFlag(hw_info->rx_stream, hw_info->rx_clear_flags);
+#elif DRV_SPI_PLATFORM_GD32F1
+	spi_dma_disable(spi_periph, SPI_DMA_TRANSMIT);
+	spi_dma_disable(spi_periph, SPI_DMA_RECEIVE);
+	dma_channel_disable(DMA0, hw_info->tx_channel);
+	dma_channel_disable(DMA0, hw_info->rx_channel);
+	dma_flag_clear(DMA0, hw_info->tx_channel, DMA_FLAG_G);
+	dma_flag_clear(DMA0, hw_info->rx_channel, DMA_FLAG_G);
+#endif
+
+	while (spi_hw_busy(spi_periph));	// 出错中止时等待正在发送的字节结束
+	spi_hw_read_dr(spi_periph);			// 清除 RXNE 和 OVR
+	spi_hw_read_sr(spi_periph);
+}
+
 /**
  * @brief   初始化 SPI 硬件
  * @param[in] cfg spi_cfg_t 结构体指针
@@ -263,22 +607,50 @@ static void spi_hw_init(const spi_cfg_t *cfg)
 /* ------------------------------- 硬件抽象层结束 ------------------------------- */
 
 /* --------------------------------- 核心驱动层 --------------------------------- */
-								
+
+#define SPI_DMA_MAX_LEN		65535	// DMA 传输计数寄存器为 16 位，更长的传输分段进行
+
+/* 私有数据结构体，只有使用 DMA 的设备分配 */
+typedef struct {
+	const spi_dma_hw_info_t *hw_info;
+	const uint8_t *tx;		// 下一段发送的数据，NULL 表示发送 0xFF
+	uint8_t       *rx;		// 下一段接收缓冲区，NULL 表示丢弃
+	uint32_t       remain;	// 尚未启动的字节数
+	bool           busy;	// DMA 传输进行中
+	bool           in_use;
+} spi_priv_t;
+
+static spi_priv_t g_spi_priv[MAX_SPI_DMA_NUM];
+
+static spi_priv_t *spi_priv_alloc(spi_periph_t spi_periph);
+static void spi_priv_free(spi_priv_t *priv);
+
 static int spi_start_impl(spi_dev_t *dev, gpio_port_t cs_port, gpio_pin_t cs_pin);
 static int spi_stop_impl(spi_dev_t *dev, gpio_port_t cs_port, gpio_pin_t cs_pin);
 static int spi_swap_byte_impl(spi_dev_t *dev, uint8_t send, uint8_t *recv);
+static int spi_transfer_impl(spi_dev_t *dev, const uint8_t *tx, uint8_t *rx, uint32_t len);
+static int spi_write_impl(spi_dev_t *dev, const uint8_t *tx, uint32_t len);
+static int spi_read_impl(spi_dev_t *dev, uint8_t *rx, uint32_t len);
+static int spi_transfer_start_impl(spi_dev_t *dev, const uint8_t *tx, uint8_t *rx, uint32_t len);
+static int spi_transfer_poll_impl(spi_dev_t *dev);
 static int spi_deinit_impl(spi_dev_t *dev);
 
 /* 操作接口表 */
 static const spi_ops_t spi_ops = {
-	.start     = spi_start_impl, 
-	.stop      = spi_stop_impl, 
-	.swap_byte = spi_swap_byte_impl,
-	.deinit    = spi_deinit_impl,
+	.start          = spi_start_impl, 
+	.stop           = spi_stop_impl, 
+	.swap_byte      = spi_swap_byte_impl,
+	.transfer       = spi_transfer_impl,
+	.write          = spi_write_impl,
+	.read           = spi_read_impl,
+	.transfer_start = spi_transfer_start_impl,
+	.transfer_poll  = spi_transfer_poll_impl,
+	.deinit         = spi_deinit_impl,
 };
 							
 /**
  * @brief   初始化 SPI 驱动
+ * @details cfg->dma 为 true 时分配 DMA 通道，不少于 DRV_SPI_DMA_MIN_LEN 字节的批量传输由 DMA 完成
  * @param[out] dev spi_dev_t 结构体指针
  * @param[in]  cfg spi_cfg_t 结构体指针
  * @return	0 表示成功，其他值表示失败
@@ -287,14 +659,112 @@ int drv_spi_init(spi_dev_t *dev, const spi_cfg_t *cfg)
 {
 	if (!dev || !cfg)
         return -EINVAL;
+
+	spi_priv_t *priv = NULL;
+	if (cfg->dma) {
+		priv = spi_priv_alloc(cfg->spi_periph);
+		if (!priv)
+			return -ENOMEM;
+		spi_hw_dma_clock_enable(priv->hw_info);
+	}
 	
-	dev->cfg = *cfg;
-	dev->ops = &spi_ops;
+	dev->priv = priv;
+	dev->cfg  = *cfg;
+	dev->ops  = &spi_ops;
 	
 	spi_hw_init(cfg);
 	return 0;
 }
 
+/**
+ * @brief   根据 SPI 外设从私有数据数组中分配一个空闲槽位
+ * @param[in] spi_periph SPI 外设
+ * @return	成功返回槽位指针，不支持 DMA 或已被占用时返回 NULL
+ */
+static spi_priv_t *spi_priv_alloc(spi_periph_t spi_periph)
+{
+	const spi_dma_hw_info_t *hw_info = spi_get_dma_hw_info(spi_periph);
+	if (!hw_info)
+		return NULL;
+
+	uint8_t idx = hw_info->idx;
+	if (g_spi_priv[idx].in_use)
+		return NULL;
+
+	g_spi_priv[idx].hw_info = hw_info;
+	g_spi_priv[idx].busy = false;
+	g_spi_priv[idx].in_use = true;
+	return &g_spi_priv[idx];
+}
+
+/**
+ * @brief   释放私有数据槽位
+ * @param[in,out] priv 待释放的槽位 spi_priv_t 结构体指针
+ */
+static void spi_priv_free(spi_priv_t *priv)
+{
+	if (priv)
+		priv->in_use = false;
+}
+
+/**
+ * @brief   CPU 轮询批量交换数据
+ * @details 每次只有一个字节在传输，读走上一个字节后才发送下一个，中断打断循环时也不会溢出丢字节
+ * @param[in]  spi_periph SPI 外设
+ * @param[in]  tx  		  发送的数据，NULL 时发送 0xFF
+ * @param[out] rx  		  接收的数据，NULL 时丢弃
+ * @param[in]  len 		  数据长度
+ */
+static void spi_transfer_cpu(spi_periph_t spi_periph, const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+	uint8_t recv;
+
+	for (uint32_t i = 0; i < len; i++) {
+		while (!spi_hw_tx_empty(spi_periph));				// 等待TXE置1
+		spi_hw_write_dr(spi_periph, tx ? tx[i] : 0xFF);		// 发送字节
+		while (!spi_hw_rx_not_empty(spi_periph));			// 等待RXNE置1
+		recv = spi_hw_read_dr(spi_periph);					// 读取接收到的字节
+		if (rx)
+			rx[i] = recv;
+	}
+}
+
+/**
+ * @brief   CPU 轮询批量发送数据
+ * @details 只等待 TXE 连续发送，接收到的字节全部丢弃，结束时等待发送完成并清除 RXNE、OVR 标志
+ * @param[in] spi_periph SPI 外设
+ * @param[in] tx  		 发送的数据
+ * @param[in] len 		 数据长度
+ */
+static void spi_write_cpu(spi_periph_t spi_periph, const uint8_t *tx, uint32_t len)
+{
+	for (uint32_t i = 0; i < len; i++) {
+		while (!spi_hw_tx_empty(spi_periph));	// 等待TXE置1
+		spi_hw_write_dr(spi_periph, tx[i]);		// 发送字节
+	}
+	while (!spi_hw_tx_empty(spi_periph));		// 等待最后一个字节进入移位寄存器
+	while (spi_hw_busy(spi_periph));			// 等待最后一个字节发送完成
+
+	spi_hw_read_dr(spi_periph);					// 先读DR再读SR，清除RXNE和OVR
+	spi_hw_read_sr(spi_periph);
+}
+
+/**
+ * @brief   启动下一段 DMA 传输
+ * @param[in,out] priv spi_priv_t 结构体指针
+ */
+static void spi_dma_next(spi_priv_t *priv)
+{
+	uint32_t seg = priv->remain > SPI_DMA_MAX_LEN ? SPI_DMA_MAX_LEN : priv->remain;
+
+	spi_hw_dma_start(priv->hw_info, priv->tx, priv->rx, seg);
+	if (priv->tx)
+		priv->tx += seg;
+	if (priv->rx)
+		priv->rx += seg;
+	priv->remain -= seg;
+}
+
 /**
  * @brief   SPI 起始
  * @param[in] dev     spi_dev_t 结构体指针
@@ -339,6 +809,10 @@ static int spi_swap_byte_impl(spi_dev_t *dev, uint8_t send, uint8_t *recv)
 	if (!dev)
 		return -EINVAL;	
 
+	spi_priv_t *priv = dev->priv;
+	if (priv && priv->busy)
+		return -EBUSY;
+
 	while (!spi_hw_get_flag_status(dev->cfg.spi_periph, SPI_I2S_FLAG_TXE));	// 等待TXE置1，表示发送寄存器为空，发送一个字节	
 	spi_hw_send_data(dev->cfg.spi_periph, send);							// 发送字节
 	while(!spi_hw_get_flag_status(dev->cfg.spi_periph, SPI_I2S_FLAG_RXNE));	// 等待RXNE置1，表示接收寄存器非空，收到一个字节
@@ -350,6 +824,123 @@ static int spi_swap_byte_impl(spi_dev_t *dev, uint8_t send, uint8_t *recv)
 	return 0;
 }
 
+/**
+ * @brief   SPI 批量交换数据，完成后返回
+ * @param[in]  dev spi_dev_t 结构体指针
+ * @param[in]  tx  发送的数据，NULL 时发送 0xFF
+ * @param[out] rx  接收的数据，NULL 时丢弃
+ * @param[in]  len 数据长度
+ * @return	0 表示成功，-EBUSY 表示异步传输未完成，其他值表示失败
+ */
+static int spi_transfer_impl(spi_dev_t *dev, const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+	int ret;
+
+	ret = spi_transfer_start_impl(dev, tx, rx, len);
+	if (ret)
+		return ret;
+
+	while ((ret = spi_transfer_poll_impl(dev)) == -EBUSY);
+	return ret;
+}
+
+/**
+ * @brief   SPI 批量发送数据，接收到的字节全部丢弃
+ * @param[in] dev spi_dev_t 结构体指针
+ * @param[in] tx  发送的数据
+ * @param[in] len 数据长度
+ * @return	0 表示成功，-EBUSY 表示异步传输未完成，其他值表示失败
+ */
+static int spi_write_impl(spi_dev_t *dev, const uint8_t *tx, uint32_t len)
+{
+	if (!dev || (!tx && len))
+		return -EINVAL;
+
+	spi_priv_t *priv = dev->priv;
+	if (priv && len >= DRV_SPI_DMA_MIN_LEN)
+		return spi_transfer_impl(dev, tx, NULL, len);
+	if (priv && priv->busy)
+		return -EBUSY;
+
+	spi_write_cpu(dev->cfg.spi_periph, tx, len);
+	return 0;
+}
+
+/**
+ * @brief   SPI 批量接收数据，发送 0xFF
+ * @param[in]  dev spi_dev_t 结构体指针
+ * @param[out] rx  接收的数据
+ * @param[in]  len 数据长度
+ * @return	0 表示成功，-EBUSY 表示异步传输未完成，其他值表示失败
+ */
+static int spi_read_impl(spi_dev_t *dev, uint8_t *rx, uint32_t len)
+{
+	if (!dev || (!rx && len))
+		return -EINVAL;
+
+	return spi_transfer_impl(dev, NULL, rx, len);
+}
+
+/**
+ * @brief   SPI 启动异步批量交换数据
+ * @details 使用 DMA 且长度不少于 DRV_SPI_DMA_MIN_LEN 时启动后立即返回，由 transfer_poll 查询完成；
+ *          其他情况同步完成传输后返回。完成前 tx、rx 缓冲区不能修改，也不能调用该设备的其他传输接口
+ * @param[in]  dev spi_dev_t 结构体指针
+ * @param[in]  tx  发送的数据，NULL 时发送 0xFF
+ * @param[out] rx  接收的数据，NULL 时丢弃
+ * @param[in]  len 数据长度
+ * @return	0 表示已启动（或已完成），-EBUSY 表示上一次传输未完成，其他值表示失败
+ */
+static int spi_transfer_start_impl(spi_dev_t *dev, const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+	if (!dev)
+		return -EINVAL;
+
+	spi_priv_t *priv = dev->priv;
+	if (priv && priv->busy)
+		return -EBUSY;
+
+	if (!priv || len < DRV_SPI_DMA_MIN_LEN) {
+		spi_transfer_cpu(dev->cfg.spi_periph, tx, rx, len);
+		return 0;
+	}
+
+	priv->tx     = tx;
+	priv->rx     = rx;
+	priv->remain = len;
+	priv->busy   = true;
+	spi_dma_next(priv);
+	return 0;
+}
+
+/**
+ * @brief   SPI 查询异步批量交换是否完成，一段 DMA 完成后自动启动下一段
+ * @param[in] dev spi_dev_t 结构体指针
+ * @return	0 表示已完成（或没有进行中的传输），-EBUSY 表示传输中，其他值表示传输失败
+ */
+static int spi_transfer_poll_impl(spi_dev_t *dev)
+{
+	if (!dev)
+		return -EINVAL;
+
+	spi_priv_t *priv = dev->priv;
+	if (!priv || !priv->busy)
+		return 0;
+
+	int ret = spi_hw_dma_status(priv->hw_info);
+	if (ret == -EBUSY)
+		return ret;
+
+	spi_hw_dma_stop(priv->hw_info);
+	if (ret == 0 && priv->remain) {
+		spi_dma_next(priv);
+		return -EBUSY;
+	}
+
+	priv->busy = false;
+	return ret;
+}
+
 /**
  * @brief   去初始化 SPI
  * @param[in] dev spi_dev_t 结构体指针
@@ -360,6 +951,14 @@ static int spi_deinit_impl(spi_dev_t *dev)
 	if (!dev)
 		return -EINVAL;
 
+	spi_priv_t *priv = dev->priv;
+	if (priv && priv->busy) {
+		spi_hw_dma_stop(priv->hw_info);
+		priv->busy = false;
+	}
+	spi_priv_free(priv);
+
+	dev->priv = NULL;
 	dev->ops = NULL;
 	return 0;
 }
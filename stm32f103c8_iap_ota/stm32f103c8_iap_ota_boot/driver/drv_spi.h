@@ -29,6 +29,19 @@ typedef uint32_t	gpio_pin_t;
 #error drv_spi.h: No processor defined!
 #endif
 
+#ifndef EIO
+#define EIO 	8
+#endif
+
+#ifndef EBUSY
+#define EBUSY	16
+#endif
+
+/* 批量传输不少于该字节数时使用 DMA，更短的传输（指令、地址）配置 DMA 的开销大于收益，由 CPU 轮询 */
+#ifndef DRV_SPI_DMA_MIN_LEN
+#define DRV_SPI_DMA_MIN_LEN	16
+#endif
+
 /* SPI 模式 */
 typedef enum {
     SPI_MODE_0,
@@ -48,6 +61,7 @@ typedef struct {
 	gpio_pin_t   mosi_pin;
 	uint16_t 	 prescaler;
 	spi_mode_t   mode;
+	bool         dma;		// 批量传输使用 DMA，只支持 SPI1/SPI2（GD32 为 SPI0/SPI1），DMA 通道不能被其他外设占用
 } spi_cfg_t;
 
 typedef struct spi_dev spi_dev_t;
@@ -57,11 +71,17 @@ typedef struct {
 	int (*start)(spi_dev_t *dev, gpio_port_t cs_port, gpio_pin_t cs_pin);
 	int (*stop)(spi_dev_t *dev, gpio_port_t cs_port, gpio_pin_t cs_pin);
 	int (*swap_byte)(spi_dev_t *dev, uint8_t send, uint8_t *recv);
+	int (*transfer)(spi_dev_t *dev, const uint8_t *tx, uint8_t *rx, uint32_t len);
+	int (*write)(spi_dev_t *dev, const uint8_t *tx, uint32_t len);
+	int (*read)(spi_dev_t *dev, uint8_t *rx, uint32_t len);
+	int (*transfer_start)(spi_dev_t *dev, const uint8_t *tx, uint8_t *rx, uint32_t len);
+	int (*transfer_poll)(spi_dev_t *dev);
 	int (*deinit)(spi_dev_t *dev);
 } spi_ops_t;
 
 /* 设备结构体 */
 struct spi_dev {
+	void *priv;
 	spi_cfg_t cfg;
 	const spi_ops_t *ops;
 };
@@ -41,6 +41,11 @@ typedef IRQn_Type			iqrn_type_t;
 #define EAGAIN	11
 #endif
 
+/* 放到 SRAM 中执行的函数，分散加载文件把 RAMCODE 段放到 RAM 执行域；未使用该分散加载文件的工程中仍在 Flash 中执行 */
+#ifndef DRV_RAMFUNC
+#define DRV_RAMFUNC __attribute__((section("RAMCODE")))
+#endif
+
 /* 配置结构体 */
 typedef struct {
 	uart_periph_t uart_periph;
@@ -67,6 +72,7 @@ typedef struct {
 	int (*send_data)(uart_dev_t *dev, uint8_t *data, uint32_t len);
 	int (*recv_str)(uart_dev_t *dev, char *str);
 	int (*recv_data)(uart_dev_t *dev, uint8_t **data, uint32_t *len);
+	int (*set_baudrate)(uart_dev_t *dev, uint32_t baudrate);
 	int (*deinit)(uart_dev_t *dev);
 } uart_ops_t;
 
@@ -87,23 +87,43 @@ static void w25qx_hw_init(const w25qx_cfg_t *cfg)
 
 static int w25qx_read_id_impl(w25qx_dev_t *dev, uint8_t *mid, uint16_t *did);
 static int w25qx_write_page_impl(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data);
+static int w25qx_write_page_start_impl(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data);
 static int w25qx_write_data_impl(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data);
 static int w25qx_erase_sector_4kb_impl(w25qx_dev_t *dev, uint32_t addr);
+static int w25qx_erase_sector_4kb_start_impl(w25qx_dev_t *dev, uint32_t addr);
+static int w25qx_erase_block_32kb_impl(w25qx_dev_t *dev, uint32_t addr);
+static int w25qx_erase_block_32kb_start_impl(w25qx_dev_t *dev, uint32_t addr);
 static int w25qx_erase_block_64kb_impl(w25qx_dev_t *dev, uint16_t index);
+static int w25qx_erase_block_64kb_start_impl(w25qx_dev_t *dev, uint16_t index);
+static int w25qx_busy_poll_impl(w25qx_dev_t *dev);
+static int w25qx_erase_suspend_impl(w25qx_dev_t *dev);
+static int w25qx_erase_resume_impl(w25qx_dev_t *dev);
 static int w25qx_read_data_impl(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data);
+static int w25qx_read_data_start_impl(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data);
+static int w25qx_read_data_poll_impl(w25qx_dev_t *dev);
 static int w25qx_wake_up_impl(w25qx_dev_t *dev);
 static int w25qx_deinit_impl(w25qx_dev_t *dev);
 
 /* 操作接口表 */
 static const w25qx_ops_t w25qx_ops = {
-	.read_id          = w25qx_read_id_impl,
-	.write_page       = w25qx_write_page_impl,
-	.write_data       = w25qx_write_data_impl,
-	.erase_sector_4kb = w25qx_erase_sector_4kb_impl,
-	.erase_block_64kb = w25qx_erase_block_64kb_impl,
-	.read_data        = w25qx_read_data_impl,
-	.wakeup           = w25qx_wake_up_impl,
-	.deinit 		  = w25qx_deinit_impl
+	.read_id                = w25qx_read_id_impl,
+	.write_page             = w25qx_write_page_impl,
+	.write_page_start       = w25qx_write_page_start_impl,
+	.write_data             = w25qx_write_data_impl,
+	.erase_sector_4kb       = w25qx_erase_sector_4kb_impl,
+	.erase_sector_4kb_start = w25qx_erase_sector_4kb_start_impl,
+	.erase_block_32kb       = w25qx_erase_block_32kb_impl,
+	.erase_block_32kb_start = w25qx_erase_block_32kb_start_impl,
+	.erase_block_64kb       = w25qx_erase_block_64kb_impl,
+	.erase_block_64kb_start = w25qx_erase_block_64kb_start_impl,
+	.busy_poll              = w25qx_busy_poll_impl,
+	.erase_suspend          = w25qx_erase_suspend_impl,
+	.erase_resume           = w25qx_erase_resume_impl,
+	.read_data              = w25qx_read_data_impl,
+	.read_data_start        = w25qx_read_data_start_impl,
+	.read_data_poll         = w25qx_read_data_poll_impl,
+	.wakeup                 = w25qx_wake_up_impl,
+	.deinit 		        = w25qx_deinit_impl
 };
 
 /**
@@ -119,11 +139,32 @@ int drv_w25qx_init(w25qx_dev_t *dev, const w25qx_cfg_t *cfg)
 
     dev->cfg = *cfg;
 	dev->ops = &w25qx_ops;
+	dev->reading = false;
+	dev->busy = false;
+	dev->erasing = false;
+	dev->suspended = false;
 
 	w25qx_hw_init(cfg);
 	return 0;
 }
 
+/**
+ * @brief   W25QX 发送指令和 24 位地址，需在 SPI 起始后调用
+ * @param[in] dev  w25qx_dev_t 结构体指针
+ * @param[in] cmd  指令
+ * @param[in] addr 地址
+ */
+static void w25qx_send_cmd_addr(w25qx_dev_t *dev, uint8_t cmd, uint32_t addr)
+{
+	uint8_t buf[4];
+
+	buf[0] = cmd;					// 指令
+	buf[1] = (uint8_t)(addr >> 16);	// 地址23~16位
+	buf[2] = (uint8_t)(addr >> 8);	// 地址15~8位
+	buf[3] = (uint8_t)addr;			// 地址7~0位
+	dev->cfg.spi_ops->write(buf, sizeof(buf));
+}
+
 /**
  * @brief   W25QX 写使能
  * @param[in] dev w25qx_dev_t 结构体指针
@@ -140,8 +181,50 @@ static int w25qx_write_enable(w25qx_dev_t *dev)
 	return 0;
 }
 
+/**
+ * @brief   W25QX 读状态寄存器1
+ * @param[in]  dev    w25qx_dev_t 结构体指针
+ * @param[out] status 状态寄存器1的值
+ * @return	0 表示成功，其他值表示失败
+ */
+static int w25qx_read_status_1(w25qx_dev_t *dev, uint8_t *status)
+{
+	dev->cfg.spi_ops->start(dev->cfg.cs_port, dev->cfg.cs_pin);			// SPI起始
+	dev->cfg.spi_ops->swap_byte(W25QX_READ_STATUS_REGISTER_1, NULL);	// 交换发送读状态寄存器1的指令
+	dev->cfg.spi_ops->swap_byte(W25QX_DUMMY_BYTE, status);				// 交换接收状态寄存器1
+	dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);			// SPI终止
+	return 0;
+}
+
+/**
+ * @brief   W25QX 读状态寄存器2
+ * @param[in]  dev    w25qx_dev_t 结构体指针
+ * @param[out] status 状态寄存器2的值
+ * @return	0 表示成功，其他值表示失败
+ */
+static int w25qx_read_status_2(w25qx_dev_t *dev, uint8_t *status)
+{
+	dev->cfg.spi_ops->start(dev->cfg.cs_port, dev->cfg.cs_pin);			// SPI起始
+	dev->cfg.spi_ops->swap_byte(W25QX_READ_STATUS_REGISTER_2, NULL);	// 交换发送读状态寄存器2的指令
+	dev->cfg.spi_ops->swap_byte(W25QX_DUMMY_BYTE, status);				// 交换接收状态寄存器2
+	dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);			// SPI终止
+	return 0;
+}
+
+/**
+ * @brief   W25QX 记录编程/擦除已完成，擦除暂停期间完成的是页编程，擦除仍未完成
+ * @param[in] dev w25qx_dev_t 结构体指针
+ */
+static void w25qx_set_idle(w25qx_dev_t *dev)
+{
+	dev->busy = false;
+	if (!dev->suspended)
+		dev->erasing = false;
+}
+
 /**
  * @brief   W25QX 等待忙
+ * @details 没有未完成的编程/擦除时直接返回，否则连续读取状态寄存器1直到 BUSY 位清零
  * @param[in] dev w25qx_dev_t 结构体指针
  * @return	0 表示成功，其他值表示失败
  */
@@ -149,22 +232,81 @@ static int w25qx_wait_busy(w25qx_dev_t *dev)
 {
 	if (!dev)
         return -EINVAL;
+	if (!dev->busy)
+		return 0;
 	
 	uint32_t timeout;
-	uint8_t recv;
+	uint8_t recv = W25QX_STATUS_BUSY;
 	dev->cfg.spi_ops->start(dev->cfg.cs_port, dev->cfg.cs_pin);			// SPI起始
 	dev->cfg.spi_ops->swap_byte(W25QX_READ_STATUS_REGISTER_1, NULL);	// 交换发送读状态寄存器1的指令
 	timeout = 1000000;
 
 	while (timeout--) {
 		dev->cfg.spi_ops->swap_byte(W25QX_DUMMY_BYTE, &recv);
-		if ((recv & 0x01) == 0)
+		if ((recv & W25QX_STATUS_BUSY) == 0)
 			break;
 	}
-	if (timeout == 0)
+	dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);			// SPI终止
+	if (recv & W25QX_STATUS_BUSY)
 		return -ETIMEDOUT;
 	
-	dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);			// SPI终止
+	w25qx_set_idle(dev);
+	return 0;
+}
+
+/**
+ * @brief   W25QX 发出页编程指令，不等待编程完成
+ * @details 先等待上一次编程/擦除完成，数据在指令中发送完毕，返回后 data 可以立即复用
+ * @param[in] dev  w25qx_dev_t 结构体指针
+ * @param[in] addr 起始地址
+ * @param[in] cnt  要写入数据的数量
+ * @param[in] data 用于写入数据的数组
+ * @return	0 表示成功，其他值表示失败
+ */
+static int w25qx_program_page(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data)
+{
+	int ret;
+
+	ret = w25qx_wait_busy(dev);									// 等待上一次编程/擦除完成
+	if (ret)
+		return ret;
+
+	w25qx_write_enable(dev);									// 写使能
+	
+	dev->cfg.spi_ops->start(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI起始
+	w25qx_send_cmd_addr(dev, W25QX_PAGE_PROGRAM, addr);			// 发送页编程的指令和地址
+	ret = dev->cfg.spi_ops->write(data, cnt);					// 在起始地址后批量写入数据（DMA 时整页一次传输）
+	dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI终止
+	dev->busy = true;
+	return ret;
+}
+
+/**
+ * @brief   W25QX 发出擦除指令，不等待擦除完成
+ * @details 擦除暂停期间返回 -EBUSY
+ * @param[in] dev  w25qx_dev_t 结构体指针
+ * @param[in] cmd  擦除指令（扇区/半块/块）
+ * @param[in] addr 擦除单元内的地址
+ * @return	0 表示成功，其他值表示失败
+ */
+static int w25qx_erase(w25qx_dev_t *dev, uint8_t cmd, uint32_t addr)
+{
+	int ret;
+
+	if (dev->suspended)
+		return -EBUSY;												// 擦除暂停期间不能再擦除，需先恢复
+
+	ret = w25qx_wait_busy(dev);									// 等待上一次编程/擦除完成
+	if (ret)
+		return ret;
+
+	w25qx_write_enable(dev);									// 写使能
+	
+	dev->cfg.spi_ops->start(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI起始
+	w25qx_send_cmd_addr(dev, cmd, addr);						// 发送擦除的指令和地址
+	dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI终止
+	dev->busy = true;
+	dev->erasing = true;
 	return 0;
 }
 
@@ -204,22 +346,37 @@ static int w25qx_read_id_impl(w25qx_dev_t *dev, uint8_t *mid, uint16_t *did)
  */
 static int w25qx_write_page_impl(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data)
 {
+	int ret;
+
 	if (!dev)
         return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
 
-	w25qx_write_enable(dev);									// 写使能
-	
-	dev->cfg.spi_ops->start(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI起始
-	dev->cfg.spi_ops->swap_byte(W25QX_PAGE_PROGRAM, NULL);		// 交换发送页编程的指令
-	dev->cfg.spi_ops->swap_byte(addr >> 16, NULL);				// 交换发送地址23~16位
-	dev->cfg.spi_ops->swap_byte(addr >> 8, NULL);				// 交换发送地址15~8位
-	dev->cfg.spi_ops->swap_byte(addr, NULL);					// 交换发送地址7~0位
-	for (uint16_t i = 0; i < cnt; i++)							// 循环cnt次
-		dev->cfg.spi_ops->swap_byte(data[i], NULL);				// 依次在起始地址后写入数据
-	dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI终止
+	ret = w25qx_program_page(dev, addr, cnt, data);				// 发出页编程
+	if (ret)
+		return ret;
 	
-	w25qx_wait_busy(dev);										// 等待忙
-	return 0;
+	return w25qx_wait_busy(dev);								// 等待忙
+}
+
+/**
+ * @brief   W25QX 启动按页写入，发出页编程指令后立即返回，不等待编程完成
+ * @details 之后用 busy_poll 查询完成；在完成前调用其他操作时，该操作先等待编程完成
+ * @param[in] dev  w25qx_dev_t 结构体指针
+ * @param[in] addr 起始地址
+ * @param[in] cnt  要写入数据的数量
+ * @param[in] data 用于写入数据的数组，返回后可以立即复用
+ * @return	0 表示已启动，其他值表示失败
+ */
+static int w25qx_write_page_start_impl(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data)
+{
+	if (!dev)
+        return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
+
+	return w25qx_program_page(dev, addr, cnt, data);
 }
 
 /**
@@ -303,20 +460,72 @@ static int w25qx_write_data_impl(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt,
  */
 static int w25qx_erase_sector_4kb_impl(w25qx_dev_t *dev, uint32_t addr)
 {
+	int ret;
+
 	if (!dev)
         return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
 	
-	w25qx_write_enable(dev);									// 写使能
+	ret = w25qx_erase(dev, W25QX_SECTOR_ERASE_4KB, addr);		// 发出扇区擦除
+	if (ret)
+		return ret;
 	
-	dev->cfg.spi_ops->start(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI起始
-	dev->cfg.spi_ops->swap_byte(W25QX_SECTOR_ERASE_4KB, NULL);	// 交换发送扇区擦除的指令
-	dev->cfg.spi_ops->swap_byte(addr >> 16, NULL);				// 交换发送地址23~16位
-	dev->cfg.spi_ops->swap_byte(addr >> 8, NULL);				// 交换发送地址15~8位
-	dev->cfg.spi_ops->swap_byte(addr, NULL);					// 交换发送地址7~0位
-	dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI终止
+	return w25qx_wait_busy(dev);								// 等待忙
+}
+
+/**
+ * @brief   W25QX 启动扇区擦除（4KB），发出指令后立即返回，之后用 busy_poll 查询完成
+ * @param[in] dev  w25qx_dev_t 结构体指针
+ * @param[in] addr 指定扇区的地址
+ * @return	0 表示已启动，其他值表示失败
+ */
+static int w25qx_erase_sector_4kb_start_impl(w25qx_dev_t *dev, uint32_t addr)
+{
+	if (!dev)
+        return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
+
+	return w25qx_erase(dev, W25QX_SECTOR_ERASE_4KB, addr);
+}
+
+/**
+ * @brief   W25QX 半块擦除（32KB）
+ * @param[in] dev  w25qx_dev_t 结构体指针
+ * @param[in] addr 指定半块的地址
+ * @return	0 表示成功，其他值表示失败
+ */
+static int w25qx_erase_block_32kb_impl(w25qx_dev_t *dev, uint32_t addr)
+{
+	int ret;
+
+	if (!dev)
+        return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
 	
-	w25qx_wait_busy(dev);										// 等待忙
-	return 0;
+	ret = w25qx_erase(dev, W25QX_BLOCK_ERASE_32KB, addr);		// 发出半块擦除
+	if (ret)
+		return ret;
+	
+	return w25qx_wait_busy(dev);								// 等待忙
+}
+
+/**
+ * @brief   W25QX 启动半块擦除（32KB），发出指令后立即返回，之后用 busy_poll 查询完成
+ * @param[in] dev  w25qx_dev_t 结构体指针
+ * @param[in] addr 指定半块的地址
+ * @return	0 表示已启动，其他值表示失败
+ */
+static int w25qx_erase_block_32kb_start_impl(w25qx_dev_t *dev, uint32_t addr)
+{
+	if (!dev)
+        return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
+
+	return w25qx_erase(dev, W25QX_BLOCK_ERASE_32KB, addr);
 }
 
 /**
@@ -328,19 +537,124 @@ static int w25qx_erase_sector_4kb_impl(w25qx_dev_t *dev, uint32_t addr)
  */
 static int w25qx_erase_block_64kb_impl(w25qx_dev_t *dev, uint16_t index)
 {
+	int ret;
+
 	if (!dev)
         return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
 
-	w25qx_write_enable(dev);									// 写使能
+	ret = w25qx_erase(dev, W25QX_BLOCK_ERASE_64KB, (uint32_t)index * 64 * 1024);	// 发出块擦除
+	if (ret)
+		return ret;
 	
+	return w25qx_wait_busy(dev);								// 等待忙
+}
+
+/**
+ * @brief   W25QX 启动块擦除（64KB），发出指令后立即返回，之后用 busy_poll 查询完成
+ * @details 块擦除典型耗时数百毫秒，期间 CPU 可以继续接收数据
+ * @param[in] dev   w25qx_dev_t 结构体指针
+ * @param[in] index 指定擦除块的索引
+ * @return	0 表示已启动，其他值表示失败
+ */
+static int w25qx_erase_block_64kb_start_impl(w25qx_dev_t *dev, uint16_t index)
+{
+	if (!dev)
+        return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
+
+	return w25qx_erase(dev, W25QX_BLOCK_ERASE_64KB, (uint32_t)index * 64 * 1024);
+}
+
+/**
+ * @brief   W25QX 查询编程/擦除是否完成
+ * @details 每次只读一次状态寄存器1，不会阻塞
+ * @param[in] dev w25qx_dev_t 结构体指针
+ * @return	0 表示已完成（或没有进行中的编程/擦除），-EBUSY 表示进行中，其他值表示失败
+ */
+static int w25qx_busy_poll_impl(w25qx_dev_t *dev)
+{
+	uint8_t status;
+
+	if (!dev)
+        return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
+	if (!dev->busy)
+		return 0;
+
+	w25qx_read_status_1(dev, &status);
+	if (status & W25QX_STATUS_BUSY)
+		return -EBUSY;
+
+	w25qx_set_idle(dev);
+	return 0;
+}
+
+/**
+ * @brief   W25QX 暂停进行中的擦除（0x75）
+ * @details 暂停后可以读取或页编程正在擦除的扇区/块以外的地址，之后用 erase_resume 恢复擦除。
+ *          暂停在 tSUS（最长 20us）内生效；擦除已经完成时指令被忽略，按状态寄存器2 的 SUS 位判断。
+ *          恢复后立即再次暂停时擦除几乎没有进展，调用方应避免连续暂停
+ * @param[in] dev w25qx_dev_t 结构体指针
+ * @return	0 表示成功（已暂停，或没有进行中的擦除），其他值表示失败
+ */
+static int w25qx_erase_suspend_impl(w25qx_dev_t *dev)
+{
+	uint8_t status;
+	int ret;
+
+	if (!dev)
+        return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
+	if (!dev->erasing || dev->suspended)
+		return 0;
+
 	dev->cfg.spi_ops->start(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI起始
-	dev->cfg.spi_ops->swap_byte(W25QX_BLOCK_ERASE_64KB, NULL);	// 交换发送块擦除的指令
-	dev->cfg.spi_ops->swap_byte(index * 64 * 1024 >> 16, NULL);	// 交换发送地址23~16位
-	dev->cfg.spi_ops->swap_byte(index * 64 * 1024 >> 8, NULL);	// 交换发送地址15~8位
-	dev->cfg.spi_ops->swap_byte(index * 64 * 1024, NULL);		// 交换发送地址7~0位
+	dev->cfg.spi_ops->swap_byte(W25QX_ERASE_SUSPEND, NULL);		// 交换发送擦除暂停的指令
 	dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI终止
-	
-	w25qx_wait_busy(dev);										// 等待忙
+
+	ret = w25qx_wait_busy(dev);									// 等待暂停生效（或擦除完成）
+	if (ret)
+		return ret;
+
+	w25qx_read_status_2(dev, &status);
+	if (status & W25QX_STATUS_SUS) {
+		dev->erasing = true;
+		dev->suspended = true;
+	}
+	return 0;
+}
+
+/**
+ * @brief   W25QX 恢复已暂停的擦除（0x7A）
+ * @details 先等待暂停期间发出的页编程完成。没有暂停的擦除时直接返回
+ * @param[in] dev w25qx_dev_t 结构体指针
+ * @return	0 表示成功，其他值表示失败
+ */
+static int w25qx_erase_resume_impl(w25qx_dev_t *dev)
+{
+	int ret;
+
+	if (!dev)
+        return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
+	if (!dev->suspended)
+		return 0;
+
+	ret = w25qx_wait_busy(dev);									// 等待暂停期间的页编程完成
+	if (ret)
+		return ret;
+
+	dev->cfg.spi_ops->start(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI起始
+	dev->cfg.spi_ops->swap_byte(W25QX_ERASE_RESUME, NULL);		// 交换发送擦除恢复的指令
+	dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI终止
+	dev->suspended = false;
+	dev->busy = true;
 	return 0;
 }
 
@@ -354,20 +668,82 @@ static int w25qx_erase_block_64kb_impl(w25qx_dev_t *dev, uint16_t index)
  */
 static int w25qx_read_data_impl(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data)
 {
+	int ret;
+
 	if (!dev)
         return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
+
+	ret = w25qx_wait_busy(dev);										// 编程/擦除期间不能读取，先等待完成
+	if (ret)
+		return ret;
 
 	dev->cfg.spi_ops->start(dev->cfg.cs_port, dev->cfg.cs_pin);		// SPI起始
-	dev->cfg.spi_ops->swap_byte(W25QX_READ_DATA, NULL);				// 交换发送读取数据的指令
-	dev->cfg.spi_ops->swap_byte(addr >> 16, NULL);					// 交换发送地址23~16位
-	dev->cfg.spi_ops->swap_byte(addr >> 8, NULL);					// 交换发送地址15~8位
-	dev->cfg.spi_ops->swap_byte(addr, NULL);						// 交换发送地址7~0位
-	for (uint32_t i = 0; i < cnt; i++)
-		dev->cfg.spi_ops->swap_byte(W25QX_DUMMY_BYTE, &data[i]);	// 依次在起始地址后读取数据
+	w25qx_send_cmd_addr(dev, W25QX_READ_DATA, addr);				// 发送读取数据的指令和地址
+	ret = dev->cfg.spi_ops->read(data, cnt);						// 在起始地址后批量读取数据
 	dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);		// SPI终止
+	return ret;
+}
+
+/**
+ * @brief   W25QX 启动异步读取数据
+ * @details 发送指令和地址后由 SPI 的 DMA 接收数据并立即返回，CPU 可以处理其他工作，之后用 read_data_poll 查询完成；
+ *          完成前不能修改 data，也不能调用其他操作。SPI 不使用 DMA 时同步读完后返回
+ * @param[in]  dev  w25qx_dev_t 结构体指针
+ * @param[in]  addr 读取数据的起始地址
+ * @param[in]  cnt  要读取数据的数量
+ * @param[out] data 用于接收读取数据的数组
+ * @return	0 表示已启动，-EBUSY 表示上一次读取未完成，其他值表示失败
+ */
+static int w25qx_read_data_start_impl(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data)
+{
+	int ret;
+
+	if (!dev)
+        return -EINVAL;
+	if (dev->reading)
+		return -EBUSY;
+
+	ret = w25qx_wait_busy(dev);										// 编程/擦除期间不能读取，先等待完成
+	if (ret)
+		return ret;
+
+	dev->cfg.spi_ops->start(dev->cfg.cs_port, dev->cfg.cs_pin);		// SPI起始
+	w25qx_send_cmd_addr(dev, W25QX_READ_DATA, addr);				// 发送读取数据的指令和地址
+	ret = dev->cfg.spi_ops->transfer_start(NULL, data, cnt);		// 启动批量读取数据
+	if (ret) {
+		dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);	// SPI终止
+		return ret;
+	}
+
+	dev->reading = true;
 	return 0;
 }
 
+/**
+ * @brief   W25QX 查询异步读取是否完成，完成后结束片选
+ * @param[in] dev w25qx_dev_t 结构体指针
+ * @return	0 表示已完成（或没有进行中的读取），-EBUSY 表示读取中，其他值表示读取失败
+ */
+static int w25qx_read_data_poll_impl(w25qx_dev_t *dev)
+{
+	int ret;
+
+	if (!dev)
+        return -EINVAL;
+	if (!dev->reading)
+		return 0;
+
+	ret = dev->cfg.spi_ops->transfer_poll();
+	if (ret == -EBUSY)
+		return ret;
+
+	dev->cfg.spi_ops->stop(dev->cfg.cs_port, dev->cfg.cs_pin);		// SPI终止
+	dev->reading = false;
+	return ret;
+}
+
 /**
  * @brief   W25QX 唤醒
  * @param[in] dev w25qx_dev_t 结构体指针
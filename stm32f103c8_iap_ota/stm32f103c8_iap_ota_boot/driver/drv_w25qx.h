@@ -30,9 +30,14 @@ typedef uint32_t	gpio_pin_t;
 #define ETIMEDOUT	7
 #endif
 
+#ifndef EBUSY
+#define EBUSY		16
+#endif
+
 /* W25QX 存储结构宏定义 */
 #define W25QX_PAGE_SIZE         	256  							/* 每页256字节 */
 #define W25QX_BLOCK_64KB_PAGE_CNT	(64 * 1024 / W25QX_PAGE_SIZE)	/* 每块包含256页 */
+#define W25QX_BLOCK_32KB_PAGE_CNT	(32 * 1024 / W25QX_PAGE_SIZE)	/* 每半块包含128页 */
 #define W25QX_SECTOR_4KB_PAGE_CNT   (4 * 1024 / W25QX_PAGE_SIZE)	/* 每扇区包含16页 */
 
 /* W25QX 寄存器 */
@@ -65,10 +70,19 @@ typedef uint32_t	gpio_pin_t;
 #define W25QX_OCTAL_WORD_READ_QUAD_IO			0xE3
 #define W25QX_DUMMY_BYTE						0xFF
 
+/* W25QX 状态寄存器 */
+#define W25QX_STATUS_BUSY						0x01	/* 状态寄存器1：编程/擦除进行中 */
+#define W25QX_STATUS_SUS						0x80	/* 状态寄存器2：擦除/编程已暂停 */
+
 /* SPI 操作接口结构体 */
 typedef struct {
 	int (*start)(gpio_port_t cs_port, gpio_pin_t cs_pin);
 	int (*swap_byte)(uint8_t send, uint8_t *recv);
+	int (*transfer)(const uint8_t *tx, uint8_t *rx, uint32_t len);
+	int (*write)(const uint8_t *tx, uint32_t len);
+	int (*read)(uint8_t *rx, uint32_t len);
+	int (*transfer_start)(const uint8_t *tx, uint8_t *rx, uint32_t len);
+	int (*transfer_poll)(void);
 	int (*stop)(gpio_port_t cs_port, gpio_pin_t cs_pin);
 } w25qx_spi_ops_t;
 
@@ -85,10 +99,20 @@ typedef struct w25qx_dev w25qx_dev_t;
 typedef struct {
     int (*read_id)(w25qx_dev_t *dev, uint8_t *mid, uint16_t *did);
 	int (*write_page)(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data);
+	int (*write_page_start)(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data);
 	int (*write_data)(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data);
 	int (*erase_sector_4kb)(w25qx_dev_t *dev, uint32_t addr);
+	int (*erase_sector_4kb_start)(w25qx_dev_t *dev, uint32_t addr);
+	int (*erase_block_32kb)(w25qx_dev_t *dev, uint32_t addr);
+	int (*erase_block_32kb_start)(w25qx_dev_t *dev, uint32_t addr);
 	int (*erase_block_64kb)(w25qx_dev_t *dev, uint16_t index);
+	int (*erase_block_64kb_start)(w25qx_dev_t *dev, uint16_t index);
+	int (*busy_poll)(w25qx_dev_t *dev);
+	int (*erase_suspend)(w25qx_dev_t *dev);
+	int (*erase_resume)(w25qx_dev_t *dev);
 	int (*read_data)(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data);
+	int (*read_data_start)(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt, uint8_t *data);
+	int (*read_data_poll)(w25qx_dev_t *dev);
 	int (*wakeup)(w25qx_dev_t *dev);
 	int (*deinit)(w25qx_dev_t *dev);
 } w25qx_ops_t;
@@ -97,6 +121,10 @@ typedef struct {
 struct w25qx_dev {
 	w25qx_cfg_t cfg;
 	const w25qx_ops_t *ops;
+	bool reading;	// 异步读取进行中，片选保持有效
+	bool busy;		// 已发出编程/擦除指令，还未确认完成
+	bool erasing;	// 擦除进行中或已暂停
+	bool suspended;	// 擦除已暂停，期间不能擦除，也不能读写正在擦除的扇区/块
 };
 
 /**
@@ -2,6 +2,7 @@
 #include "ota_comm.h"
 #include "ota_core.h"
 #include "ota_event.h"
+#include "ota_ext_flash.h"
 #include "log.h"
 
 int main(void)
@@ -23,6 +24,7 @@ int main(void)
 		ota_net_recv_data(&net_rx_data, &net_rx_len);
 		// ota_console_print_recv("Net", net_rx_data, net_rx_len);
 		ota_process_event(net_rx_data, net_rx_len);
+		ota_ext_flash_poll();			/* 分片下载间隙后台擦除外部 Flash */
 
 		ota_mqtt_send_pingreq(60000);	/* 定时发送保活包 */
 	}
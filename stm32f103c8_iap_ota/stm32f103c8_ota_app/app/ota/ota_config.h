@@ -20,6 +20,9 @@
 #define OTA_ALIYUN_MQTT_TOPIC_PUBLISH_OTA_REQUEST           "/sys/k0p0bzqJdfA/D001/thing/file/download"
 
 /* Bootloader 存储信息相关，必须与 Bootloader 中的定义大小一致 */
+#define BOOT_EXT_FLASH_BLOCK_SIZE       (64UL * 1024UL) // 外部 Flash 块大小
+#define BOOT_EXT_FLASH_HALF_BLOCK_SIZE  (32UL * 1024UL) // 外部 Flash 半块大小
+#define BOOT_EXT_FLASH_SECTOR_SIZE      (4UL * 1024UL)  // 外部 Flash 扇区大小，最小擦除单元
 #define BOOT_EXT_FLASH_PAGE_SIZE        (256UL)         // 外部 Flash 页大小
 #define BOOT_EXT_FLASH_APP_BLOCK_COUNT  (16UL)          // 外部 Flash 存储的每个 APP 的块数
 #define BOOT_EXT_FLASH_APP_SLOT_COUNT   (10UL)          // 外部 Flash 存储的 APP 槽位数量，0 号位预留给 OTA
@@ -1,9 +1,9 @@
 #include <string.h>
 #include "bsp_net.h"
 #include "bsp_delay.h"
-#include "bsp_ext_flash.h"
 #include "ota_config.h"
 #include "ota_core.h"
+#include "ota_ext_flash.h"
 #include "ota_mqtt.h"
 #include "boot_store.h"
 #include "log.h"
@@ -215,17 +215,9 @@ static int ota_handle_publish_ota_upgrade(ota_mqtt_publish_pkt_t *pkt,
         return ret;
     }
 
-    /* 擦除外部 Flash （0 号为固定用于 OTA） */
-    bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
-    log_info("Erasing the 0th firmware of external Flash...");
-    for (uint8_t i = 0; i < BOOT_EXT_FLASH_APP_BLOCK_COUNT; i++) {
-        ret = ext_flash->ops->erase_block(ext_flash, i);
-        if (ret) {
-            log_error("Failed to erase block (err=%d)", ret);
-            return ret;
-        }
-        log_info("Erased block %d/%d", i + 1, BOOT_EXT_FLASH_APP_BLOCK_COUNT);
-    }
+    /* 外部 Flash 0 号位固定用于 OTA，按固件大小在分片下载过程中后台擦除 */
+    ota_ext_flash_begin(upgrade_info->size);
+    log_info("Downloading %d bytes to the 0th firmware of external Flash...", upgrade_info->size);
 
     /* 分片下载，一次 265 字节（外部 Flash 页大小） */
     if (upgrade_info->size % BOOT_EXT_FLASH_PAGE_SIZE == 0) {
@@ -259,13 +251,11 @@ static int ota_handle_publish_ota_download_reply(uint8_t *data,
     if (strstr((const char *)pkt->valid_data, "/thing/file/download_reply") == NULL)
         return -1;
     
-    /* 接收到一次 OTA 分片的数据，写入外部 Flash */
-    bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
+    /* 接收到一次 OTA 分片的数据，发出页编程后立即请求下一个分片，编程与网络传输重叠 */
     int ret;
-    ret = ext_flash->ops->write_page(ext_flash, 
-                                    download_info->slice_downloaded * BOOT_EXT_FLASH_PAGE_SIZE, 
-                                    BOOT_EXT_FLASH_PAGE_SIZE, 
-                                    &data[len - download_info->slice_size - 2]);
+    ret = ota_ext_flash_write_slice(download_info->slice_downloaded * BOOT_EXT_FLASH_PAGE_SIZE, 
+                                    &data[len - download_info->slice_size - 2], 
+                                    download_info->slice_size);
     if (ret) {
         log_error("Failed to write ext flash page (err=%d)", ret);
     }
@@ -279,7 +269,13 @@ static int ota_handle_publish_ota_download_reply(uint8_t *data,
             download_info->slice_size = upgrade_info->size % BOOT_EXT_FLASH_PAGE_SIZE;
         }
     } else if (download_info->slice_downloaded == download_info->slice_total) {
-        /* 下载完成 */
+        /* 下载完成，等待最后一页编程完成 */
+        ret = ota_ext_flash_finish();
+        if (ret) {
+            log_error("Failed to write ext flash page (err=%d)", ret);
+            return ret;
+        }
+
         boot_app_info_t boot_app_info;
         boot_app_info_load(&boot_app_info);
         boot_app_info.app_size[0] = upgrade_info->size;  // 0 号位固定用于 OTA
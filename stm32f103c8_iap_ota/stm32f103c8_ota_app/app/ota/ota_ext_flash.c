@@ -0,0 +1,115 @@
+#include <errno.h>
+#include "bsp_ext_flash.h"
+#include "ota_config.h"
+#include "ota_ext_flash.h"
+
+typedef struct {
+    uint32_t erased;        // 0 号槽位从起始处已擦除（或已发出擦除指令）的字节数，按扇区对齐
+    uint32_t erase_size;    // 固件大小按扇区向上取整，决定擦除单元的大小
+} ota_ext_flash_ctx_t;
+
+static ota_ext_flash_ctx_t ota_ext_flash_ctx;
+
+/**
+ * @brief   发出擦除 0 号槽位中下一个未擦除扇区/块的指令，不等待擦除完成
+ * @details 每次选择对齐且不超过剩余固件大小的最大擦除单元：64KB 块、32KB 半块或 4KB 扇区，
+ *          与 Bootloader 的外部 Flash 擦除规则一致
+ * @param[in] ext_flash 指向外部 Flash BSP 对象的指针
+ * @return  0 表示成功，其他值表示失败
+ */
+static int ota_ext_flash_erase_next(bsp_ext_flash_t *ext_flash)
+{
+    uint32_t erased = ota_ext_flash_ctx.erased;
+    uint32_t remain = ota_ext_flash_ctx.erase_size > erased ? ota_ext_flash_ctx.erase_size - erased : 0;
+    uint32_t unit;
+    int ret;
+
+    if (erased % BOOT_EXT_FLASH_BLOCK_SIZE == 0 && remain >= BOOT_EXT_FLASH_BLOCK_SIZE) {
+        unit = BOOT_EXT_FLASH_BLOCK_SIZE;
+        ret = ext_flash->ops->erase_block_start(ext_flash, erased / BOOT_EXT_FLASH_BLOCK_SIZE);
+    } else if (erased % BOOT_EXT_FLASH_HALF_BLOCK_SIZE == 0 && remain >= BOOT_EXT_FLASH_HALF_BLOCK_SIZE) {
+        unit = BOOT_EXT_FLASH_HALF_BLOCK_SIZE;
+        ret = ext_flash->ops->erase_block_32k_start(ext_flash, erased);
+    } else {
+        unit = BOOT_EXT_FLASH_SECTOR_SIZE;
+        ret = ext_flash->ops->erase_sector_start(ext_flash, erased);
+    }
+    if (ret)
+        return ret;
+
+    ota_ext_flash_ctx.erased = erased + unit;
+    return 0;
+}
+
+/**
+ * @brief   开始写入 OTA 固件，按固件大小规划外部 Flash 0 号槽位的擦除，不在此处擦除
+ * @details 原来收到升级消息时同步擦除整个槽位（16 个 64KB 块），主循环阻塞数秒无法处理网络数据；
+ *          现在只擦除固件覆盖的范围，并在分片下载的间隙由 ota_ext_flash_poll 在后台擦除
+ * @param[in] size 固件字节数
+ */
+void ota_ext_flash_begin(uint32_t size)
+{
+    uint32_t max_size = BOOT_EXT_FLASH_BLOCK_SIZE * BOOT_EXT_FLASH_APP_BLOCK_COUNT;
+
+    if (size == 0 || size > max_size)
+        size = max_size;
+
+    ota_ext_flash_ctx.erased = 0;
+    ota_ext_flash_ctx.erase_size = (size + BOOT_EXT_FLASH_SECTOR_SIZE - 1) / BOOT_EXT_FLASH_SECTOR_SIZE *
+                                   BOOT_EXT_FLASH_SECTOR_SIZE;
+}
+
+/**
+ * @brief   将一个下载分片写入外部 Flash 0 号槽位，发出页编程指令后立即返回
+ * @details 分片所在的扇区/块还未擦除时先擦除（通常已由 ota_ext_flash_poll 提前擦除），
+ *          后台擦除的是其他块时由 BSP 暂停擦除后写入。页编程在外部 Flash 内部进行，
+ *          期间主循环继续请求和接收下一个分片
+ * @param[in] offset 分片在固件中的偏移
+ * @param[in] data   分片数据，返回后可以立即复用
+ * @param[in] len    分片长度，分片不能跨页
+ * @return  0 表示成功，其他值表示失败
+ */
+int ota_ext_flash_write_slice(uint32_t offset, uint8_t *data, uint32_t len)
+{
+    bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
+    int ret;
+
+    while (ota_ext_flash_ctx.erased < offset + len) {
+        ret = ota_ext_flash_erase_next(ext_flash);
+        if (ret)
+            return ret;
+    }
+
+    return ext_flash->ops->write_page_start(ext_flash, offset, len, data);
+}
+
+/**
+ * @brief   在主循环中调用，外部 Flash 空闲时在后台依次擦除固件覆盖的扇区/块
+ * @details 擦除超前于分片写入进行。分片写入已擦除的区域时，BSP 暂停进行中的擦除，
+ *          页编程完成后恢复，块擦除不会阻塞分片的写入
+ */
+void ota_ext_flash_poll(void)
+{
+    bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
+
+    if (ota_ext_flash_ctx.erased >= ota_ext_flash_ctx.erase_size)
+        return;
+
+    if (ext_flash->ops->busy_poll(ext_flash) != 0)
+        return;
+
+    ota_ext_flash_erase_next(ext_flash);
+}
+
+/**
+ * @brief   等待最后一个分片编程完成
+ * @return  0 表示成功，其他值表示失败
+ */
+int ota_ext_flash_finish(void)
+{
+    bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
+    int ret;
+
+    while ((ret = ext_flash->ops->busy_poll(ext_flash)) == -EBUSY);
+    return ret;
+}
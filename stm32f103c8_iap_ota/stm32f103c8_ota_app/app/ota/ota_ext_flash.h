@@ -0,0 +1,32 @@
+#ifndef OTA_EXT_FLASH_H
+#define OTA_EXT_FLASH_H
+
+#include <stdint.h>
+
+/**
+ * @brief   开始写入 OTA 固件，按固件大小规划外部 Flash 0 号槽位的擦除，不在此处擦除
+ * @param[in] size 固件字节数
+ */
+void ota_ext_flash_begin(uint32_t size);
+
+/**
+ * @brief   将一个下载分片写入外部 Flash 0 号槽位，发出页编程指令后立即返回
+ * @param[in] offset 分片在固件中的偏移
+ * @param[in] data   分片数据，返回后可以立即复用
+ * @param[in] len    分片长度，分片不能跨页
+ * @return  0 表示成功，其他值表示失败
+ */
+int ota_ext_flash_write_slice(uint32_t offset, uint8_t *data, uint32_t len);
+
+/**
+ * @brief   在主循环中调用，外部 Flash 空闲时在后台依次擦除固件覆盖的扇区/块
+ */
+void ota_ext_flash_poll(void);
+
+/**
+ * @brief   等待最后一个分片编程完成
+ * @return  0 表示成功，其他值表示失败
+ */
+int ota_ext_flash_finish(void);
+
+#endif
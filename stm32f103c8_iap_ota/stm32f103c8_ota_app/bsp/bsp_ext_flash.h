@@ -3,6 +3,10 @@
 
 #include <stdint.h>
 
+#ifndef EBUSY
+#define EBUSY 16
+#endif
+
 /* 外部 Flash 存储结构宏定义 */
 #define EXT_FLASH_PAGE_SIZE         	256  							    /* 每页256字节 */
 #define EXT_FLASH_BLOCK_64KB_PAGE_CNT	(64 * 1024 / EXT_FLASH_PAGE_SIZE)	/* 每块包含256页 */
@@ -15,10 +19,18 @@ typedef struct {
     int (*init)(bsp_ext_flash_t *self);
     int (*read_id)(bsp_ext_flash_t *self, uint8_t *mid, uint16_t *did);
     int (*write_page)(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data);
+    int (*write_page_start)(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data);
 	int (*write_data)(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data);
 	int (*erase_sector)(bsp_ext_flash_t *self, uint32_t addr);
+	int (*erase_sector_start)(bsp_ext_flash_t *self, uint32_t addr);
+	int (*erase_block_32k)(bsp_ext_flash_t *self, uint32_t addr);
+	int (*erase_block_32k_start)(bsp_ext_flash_t *self, uint32_t addr);
 	int (*erase_block)(bsp_ext_flash_t *self, uint16_t idx);
+	int (*erase_block_start)(bsp_ext_flash_t *self, uint16_t idx);
+	int (*busy_poll)(bsp_ext_flash_t *self);
 	int (*read_data)(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data);
+	int (*read_data_start)(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data);
+	int (*read_data_poll)(bsp_ext_flash_t *self);
 } bsp_ext_flash_ops_t;
 
 /* 设备实例结构体 */
@@ -389,18 +389,65 @@ static void uart_hw_send(const uart_hw_info_t *hw_info, uint8_t *data, uint32_t
 #endif
 }
 
+/**
+ * @brief	修改串口波特率（硬件层实现）
+ * @details 先等待最后一个字节发送完成，再关闭串口重新设置波特率，
+ *          空闲中断和 DMA 接收配置保持不变
+ * @param[in] hw_info  uart_hw_info_t 结构体指针
+ * @param[in] baudrate 新的波特率
+ */
+static void uart_hw_set_baudrate(const uart_hw_info_t *hw_info, uint32_t baudrate)
+{
+#if DRV_UART_PLATFORM_STM32F1 || DRV_UART_PLATFORM_STM32F4
+	USART_InitTypeDef USART_InitStructure;
+
+	while (USART_GetFlagStatus(hw_info->uart_periph, USART_FLAG_TC) == RESET);
+	USART_Cmd(hw_info->uart_periph, DISABLE);
+
+	/* USART_Init 只修改帧格式和 BRR，CR1 的 IDLEIE、CR3 的 DMAR 不受影响 */
+	USART_InitStructure.USART_BaudRate = baudrate;
+	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+	USART_InitStructure.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;
+	USART_InitStructure.USART_Parity = USART_Parity_No;
+	USART_InitStructure.USART_StopBits = USART_StopBits_1;
+	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+	USART_Init(hw_info->uart_periph, &USART_InitStructure);
+
+	USART_Cmd(hw_info->uart_periph, ENABLE);
+
+#elif DRV_UART_PLATFORM_GD32F1
+	while (usart_flag_get(hw_info->uart_periph, USART_FLAG_TC) == RESET);
+	usart_disable(hw_info->uart_periph);
+	usart_baudrate_set(hw_info->uart_periph, baudrate);
+	usart_enable(hw_info->uart_periph);
+#endif
+}
+
+/*
+ * 以下 uart_hw_* 函数在空闲中断中调用，与中断服务函数一起放在 SRAM 中执行（DRV_RAMFUNC），
+ * 写内部 Flash 期间中断仍能及时处理。函数内直接访问寄存器，不调用放在 Flash 中的标准库函数。
+ */
+
+#if DRV_UART_PLATFORM_STM32F4
+/* DMA_FLAG_xxx 的编码：bit29 表示 HISR/HIFCR，低位为标志位（与标准库 stm32f4xx_dma.c 中的定义一致） */
+#define UART_DMA_HIGH_ISR_MASK		((uint32_t)0x20000000)
+#define UART_DMA_FLAG_MASK			((uint32_t)0x0F7D0F7D)
+#endif
+
 /**
  * @brief	检查串口空闲中断标志
  * @param[in] hw_info uart_hw_info_t 结构体指针
  * @return	true 表示空闲中断触发，false 表示未触发
  */
-static inline bool uart_hw_get_it_idle_flag(const uart_hw_info_t *hw_info)
+DRV_RAMFUNC static bool uart_hw_get_it_idle_flag(const uart_hw_info_t *hw_info)
 {
 #if DRV_UART_PLATFORM_STM32F1 || DRV_UART_PLATFORM_STM32F4
-	return (bool)USART_GetITStatus(hw_info->uart_periph, USART_IT_IDLE);
+	return (hw_info->uart_periph->CR1 & USART_CR1_IDLEIE) &&
+		   (hw_info->uart_periph->SR & USART_SR_IDLE);
 
 #elif DRV_UART_PLATFORM_GD32F1
-	return (bool)usart_interrupt_flag_get(hw_info->uart_periph, USART_INT_FLAG_IDLE);
+	return (USART_CTL0(hw_info->uart_periph) & USART_CTL0_IDLEIE) &&
+		   (USART_STAT0(hw_info->uart_periph) & USART_STAT0_IDLEF);
 #endif
 }
 
@@ -408,7 +455,7 @@ static inline bool uart_hw_get_it_idle_flag(const uart_hw_info_t *hw_info)
  * @brief	清除串口空闲中断标志
  * @param[in] hw_info uart_hw_info_t 结构体指针
  */
-static inline void uart_hw_clear_it_flag(const uart_hw_info_t *hw_info)
+DRV_RAMFUNC static void uart_hw_clear_it_flag(const uart_hw_info_t *hw_info)
 {
 #if DRV_UART_PLATFORM_STM32F1 || DRV_UART_PLATFORM_STM32F4
 	volatile uint8_t clear;
@@ -416,8 +463,9 @@ static inline void uart_hw_clear_it_flag(const uart_hw_info_t *hw_info)
 	clear = hw_info->uart_periph->DR;
 
 #elif DRV_UART_PLATFORM_GD32F1
-	usart_flag_get(hw_info->uart_periph, USART_FLAG_IDLEF);
-	usart_data_receive(hw_info->uart_periph);
+	volatile uint32_t clear;
+	clear = USART_STAT0(hw_info->uart_periph);
+	clear = USART_DATA(hw_info->uart_periph);
 #endif
 }
 
@@ -426,14 +474,14 @@ static inline void uart_hw_clear_it_flag(const uart_hw_info_t *hw_info)
  * @param[in] hw_info uart_hw_info_t 结构体指针
  * @return	DMA 缓冲区剩余未传输的字节数
  */
-static inline uint16_t uart_hw_dma_get_curr_data_counter(const uart_hw_info_t *hw_info)
+DRV_RAMFUNC static uint16_t uart_hw_dma_get_curr_data_counter(const uart_hw_info_t *hw_info)
 {
 #if DRV_UART_PLATFORM_STM32F1
-	return DMA_GetCurrDataCounter(hw_info->dma_channel);
+	return (uint16_t)hw_info->dma_channel->CNDTR;
 #elif DRV_UART_PLATFORM_STM32F4
-	return DMA_GetCurrDataCounter(hw_info->dma_stream);
+	return (uint16_t)hw_info->dma_stream->NDTR;
 #elif DRV_UART_PLATFORM_GD32F1
-	return dma_transfer_number_get(DMA0, hw_info->dma_channel);
+	return (uint16_t)DMA_CHCNT(DMA0, hw_info->dma_channel);
 #endif
 }
 
@@ -443,32 +491,36 @@ static inline uint16_t uart_hw_dma_get_curr_data_counter(const uart_hw_info_t *h
  * @param[in] buf_start 新的接收缓冲区起始地址
  * @param[in] buf_len   新的缓冲区长度
  */
-static inline void uart_hw_dma_rx_reconfig(const uart_hw_info_t *hw_info,
-                                           uint8_t *buf_start, uint16_t buf_len)
+DRV_RAMFUNC static void uart_hw_dma_rx_reconfig(const uart_hw_info_t *hw_info,
+                                                uint8_t *buf_start, uint16_t buf_len)
 {
 #if DRV_UART_PLATFORM_STM32F1
 	dma_channel_t channel = hw_info->dma_channel;
-	DMA_Cmd(channel, DISABLE);				// 关闭DMA
+	channel->CCR &= ~DMA_CCR1_EN;			// 关闭DMA
 	while(channel->CCR & DMA_CCR1_EN);		// 等待DMA真正关闭
 	channel->CNDTR = buf_len;				// 设置数据长度
 	channel->CMAR = (uint32_t)buf_start;	// 设置内存地址
-	DMA_Cmd(channel, ENABLE);				// 开启DMA
+	channel->CCR |= DMA_CCR1_EN;			// 开启DMA
 
 #elif DRV_UART_PLATFORM_STM32F4
 	dma_stream_t stream = hw_info->dma_stream;
-	DMA_Cmd(stream, DISABLE);						// 关闭DMA
+	DMA_TypeDef *dma = (stream < DMA2_Stream0) ? DMA1 : DMA2;
+	stream->CR &= ~DMA_SxCR_EN;						// 关闭DMA
 	while(stream->CR & DMA_SxCR_EN);				// 等待DMA真正关闭
 	stream->NDTR = buf_len;							// 设置数据长度
 	stream->M0AR = (uint32_t)buf_start;				// 设置内存地址
-	DMA_ClearFlag(stream, hw_info->dma_tcif_flag);	// 清除DMA传输完成中断标志位
-	DMA_Cmd(stream, ENABLE);						// 开启DMA
+	if (hw_info->dma_tcif_flag & UART_DMA_HIGH_ISR_MASK)	// 清除DMA传输完成中断标志位
+		dma->HIFCR = hw_info->dma_tcif_flag & UART_DMA_FLAG_MASK;
+	else
+		dma->LIFCR = hw_info->dma_tcif_flag & UART_DMA_FLAG_MASK;
+	stream->CR |= DMA_SxCR_EN;						// 开启DMA
 
 #elif DRV_UART_PLATFORM_GD32F1
 	dma_channel_t channel = hw_info->dma_channel;
-	dma_channel_disable(DMA0, channel);
-	dma_transfer_number_config(DMA0, channel, buf_len);
-	dma_memory_address_config(DMA0, channel, (uint32_t)buf_start);
-	dma_channel_enable(DMA0, channel);
+	DMA_CHCTL(DMA0, channel) &= ~DMA_CHXCTL_CHEN;
+	DMA_CHCNT(DMA0, channel) = buf_len;
+	DMA_CHMADDR(DMA0, channel) = (uint32_t)buf_start;
+	DMA_CHCTL(DMA0, channel) |= DMA_CHXCTL_CHEN;
 #endif
 }
 
@@ -510,9 +562,10 @@ typedef struct {
 
 /* 私有数据结构体 */
 typedef struct {
-	uart_rx_cb_t rx_cb;
-	uart_dev_t  *dev;
-	bool 		 in_use;
+	uart_rx_cb_t   rx_cb;
+	uart_dev_t    *dev;
+	uart_hw_info_t hw_info;		// 硬件信息副本，中断中使用，不读取 Flash 中的 uart_hw_info_table
+	bool 		   in_use;
 } uart_priv_t;
 
 static uart_priv_t g_uart_priv[MAX_UART_NUM];
@@ -525,18 +578,20 @@ static void uart_printf_impl(uart_dev_t *dev, const char *format, ...);
 static int uart_send_data_impl(uart_dev_t *dev, uint8_t *data, uint32_t len);
 static int uart_recv_str_impl(uart_dev_t *dev, char *str);
 static int uart_recv_data_impl(uart_dev_t *dev, uint8_t **data, uint32_t *len);
+static int uart_set_baudrate_impl(uart_dev_t *dev, uint32_t baudrate);
 static int uart_deinit_impl(uart_dev_t *dev);
 
-static void uart_idle_irq_handler(uart_periph_t uart_periph);
+DRV_RAMFUNC static void uart_idle_irq_handler(uart_periph_t uart_periph);
 
 /* 操作接口表 */
 static const uart_ops_t uart_ops = { 
-	.vprintf   = uart_vprintf_impl,
-    .printf    = uart_printf_impl,
-    .send_data = uart_send_data_impl,
-    .recv_str  = uart_recv_str_impl,
-    .recv_data = uart_recv_data_impl,
-    .deinit    = uart_deinit_impl
+	.vprintf      = uart_vprintf_impl,
+    .printf       = uart_printf_impl,
+    .send_data    = uart_send_data_impl,
+    .recv_str     = uart_recv_str_impl,
+    .recv_data    = uart_recv_data_impl,
+    .set_baudrate = uart_set_baudrate_impl,
+    .deinit       = uart_deinit_impl
 };
 
 /**
@@ -591,6 +646,7 @@ static uart_priv_t *uart_priv_alloc(uart_periph_t uart_periph)
     if (g_uart_priv[idx].in_use)
 		return NULL;
     
+    g_uart_priv[idx].hw_info = *hw_info;
     g_uart_priv[idx].in_use = true;
     return &g_uart_priv[idx];
 }
@@ -737,6 +793,26 @@ static int uart_recv_data_impl(uart_dev_t *dev, uint8_t **data, uint32_t *len)
     return 0;
 }
 
+/**
+ * @brief   运行时修改串口波特率
+ * @details 等待正在发送的数据发送完成后切换，环形缓冲区中未取出的数据段保留。
+ *          切换前后对端仍按旧波特率发送的数据会成为乱码段，由上层协议丢弃。
+ * @param[in] dev      uart_dev_t 结构体指针
+ * @param[in] baudrate 新的波特率
+ * @return	0 表示成功，其他值表示失败
+ */
+static int uart_set_baudrate_impl(uart_dev_t *dev, uint32_t baudrate)
+{
+	if (!dev || !baudrate)
+		return -EINVAL;
+
+	const uart_hw_info_t *hw_info = uart_get_hw_info(dev->cfg.uart_periph);
+
+	uart_hw_set_baudrate(hw_info, baudrate);
+	dev->cfg.baudrate = baudrate;
+	return 0;
+}
+
 /**
  * @brief   去初始化串口
  * @param[in] dev uart_dev_t 结构体指针
@@ -756,14 +832,28 @@ static int uart_deinit_impl(uart_dev_t *dev)
 
 /**
  * @brief   串口通用空闲中断函数，内部使用
+ * @details 与中断服务函数一起放在 SRAM 中执行，只访问 RAM 中的私有数据和寄存器
  * @param[in] uart_periph 串口外设
  */	
-static void uart_idle_irq_handler(uart_periph_t uart_periph)
+DRV_RAMFUNC static void uart_idle_irq_handler(uart_periph_t uart_periph)
 {
-	const uart_hw_info_t *hw_info = uart_get_hw_info(uart_periph);
-    uart_priv_t *priv = &g_uart_priv[hw_info->idx];
-	uart_dev_t *dev = priv->dev;
-	uint16_t rx_single_max = dev->cfg.rx_single_max;
+	uart_priv_t *priv = NULL;
+	const uart_hw_info_t *hw_info;
+	uart_dev_t *dev;
+	uint16_t rx_single_max;
+
+	for (uint8_t i = 0; i < MAX_UART_NUM; i++) {
+		if (g_uart_priv[i].in_use && g_uart_priv[i].hw_info.uart_periph == uart_periph) {
+			priv = &g_uart_priv[i];
+			break;
+		}
+	}
+	if (!priv)
+		return;
+
+	hw_info = &priv->hw_info;
+	dev = priv->dev;
+	rx_single_max = dev->cfg.rx_single_max;
 
     if (uart_hw_get_it_idle_flag(hw_info)) {	// 检查空闲中断标志
 		uart_hw_clear_it_flag(hw_info);			// 清除空闲中断标志
@@ -795,33 +885,33 @@ static void uart_idle_irq_handler(uart_periph_t uart_periph)
 	}
 }
 
-/* 各串口中断服务函数 */
+/* 各串口中断服务函数，放在 SRAM 中执行 */
 #if defined(USART0)
-void USART0_IRQHandler(void) { uart_idle_irq_handler(USART0); }
+DRV_RAMFUNC void USART0_IRQHandler(void) { uart_idle_irq_handler(USART0); }
 #endif
 
 #if defined(USART1)
-void USART1_IRQHandler(void) { uart_idle_irq_handler(USART1); }
+DRV_RAMFUNC void USART1_IRQHandler(void) { uart_idle_irq_handler(USART1); }
 #endif
 
 #if defined(USART2)
-void USART2_IRQHandler(void) { uart_idle_irq_handler(USART2); }
+DRV_RAMFUNC void USART2_IRQHandler(void) { uart_idle_irq_handler(USART2); }
 #endif
 
 #if defined(USART3)
-void USART3_IRQHandler(void) { uart_idle_irq_handler(USART3); }
+DRV_RAMFUNC void USART3_IRQHandler(void) { uart_idle_irq_handler(USART3); }
 #endif
 
 #if defined(UART4)
-void UART4_IRQHandler(void)  { uart_idle_irq_handler(UART4);  }
+DRV_RAMFUNC void UART4_IRQHandler(void)  { uart_idle_irq_handler(UART4);  }
 #endif
 
 #if defined(UART5)
-void UART5_IRQHandler(void)  { uart_idle_irq_handler(UART5);  }
+DRV_RAMFUNC void UART5_IRQHandler(void)  { uart_idle_irq_handler(UART5);  }
 #endif
 
 #if defined(USART6)
-void USART6_IRQHandler(void) { uart_idle_irq_handler(USART6); }
+DRV_RAMFUNC void USART6_IRQHandler(void) { uart_idle_irq_handler(USART6); }
 #endif
 
 /* ------------------------------- 核心驱动层结束 ------------------------------- */
@@ -0,0 +1,127 @@
+#include <stdint.h>
+#include <string.h>
+#include "bsp_console.h"
+#include "bsp_delay.h"
+#include "boot_config.h"
+#include "boot_core.h"
+#include "boot_cmd.h"
+#include "boot_baud.h"
+#include "log.h"
+
+typedef struct {
+    uint32_t baudrate;              // 当前切换到的波特率，0 表示默认波特率
+    uint32_t confirm_deadline;      // 等待确认的截止时刻（毫秒时基）
+} boot_baud_ctx_t;
+
+static boot_baud_ctx_t boot_baud_ctx;
+
+/* 可切换的波特率，USB 转串口芯片（CH340、FT232 等）常用的速率 */
+static const uint32_t boot_baud_table[] = {
+    115200, 230400, 460800, 921600, 1000000, 1500000, 2000000
+};
+
+/**
+ * @brief   检查波特率是否支持
+ * @param[in] baudrate 波特率
+ * @return  true 表示支持
+ */
+static bool boot_baud_is_supported(uint32_t baudrate)
+{
+    uint8_t i;
+
+    if (baudrate > BOOT_BAUD_MAX)
+        return false;
+
+    for (i = 0; i < sizeof(boot_baud_table) / sizeof(boot_baud_table[0]); i++) {
+        if (boot_baud_table[i] == baudrate)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief   处理输入的波特率，切换串口并等待上位机确认
+ * @details 提示信息在旧波特率下发送完成后才切换，上位机收到提示后再切换本地波特率
+ * @param[in] data 接收数据的首地址
+ * @param[in] len  接收数据的长度
+ */
+void boot_baud_request(uint8_t *data, uint32_t len)
+{
+    bsp_console_t *console = bsp_console_get();
+    uint32_t baudrate = 0;
+    uint32_t i;
+
+    /* 无论输入是否有效都退出请求状态，无效输入保持当前波特率并回到菜单 */
+    boot_clear_flag(BOOT_FLAG_BAUD_REQUEST);
+
+    for (i = 0; i < len && i < 8; i++) {
+        if (data[i] < '0' || data[i] > '9')
+            break;
+        baudrate = baudrate * 10 + (data[i] - '0');
+    }
+
+    if (len == 0 || i != len || !boot_baud_is_supported(baudrate)) {
+        log_warn("Unsupported baud rate: %.*s", len, (char *)data);
+        boot_cmd_print_menu();
+        return;
+    }
+
+    log_info("Switching to %d baud, send \"%s\" within %d ms to confirm.",
+             baudrate, BOOT_BAUD_SYNC_STR, BOOT_BAUD_CONFIRM_TIMEOUT_MS);
+
+    if (console->ops->set_baudrate(console, baudrate)) {
+        log_error("Failed to switch baud rate");
+        boot_cmd_print_menu();
+        return;
+    }
+
+    boot_baud_ctx.baudrate = baudrate;
+    boot_baud_ctx.confirm_deadline = bsp_delay_get_tick_ms() + BOOT_BAUD_CONFIRM_TIMEOUT_MS;
+    boot_set_flag(BOOT_FLAG_BAUD_CONFIRM);
+}
+
+/**
+ * @brief   等待确认期间的超时计时，超时后恢复默认波特率
+ */
+void boot_baud_confirm_poll(void)
+{
+    if ((int32_t)(bsp_delay_get_tick_ms() - boot_baud_ctx.confirm_deadline) < 0)
+        return;
+
+    boot_clear_flag(BOOT_FLAG_BAUD_CONFIRM);
+    boot_baud_restore();
+
+    log_warn("Baud rate switch not confirmed, fall back to default baud rate.");
+    boot_cmd_print_menu();
+}
+
+/**
+ * @brief   处理上位机在新波特率下发送的确认字符串
+ * @details 切换瞬间对端按旧波特率发送的数据会成为乱码段，不匹配时忽略，继续等待直到超时
+ * @param[in] data 接收数据的首地址
+ * @param[in] len  接收数据的长度
+ */
+void boot_baud_confirm(uint8_t *data, uint32_t len)
+{
+    if (len != strlen(BOOT_BAUD_SYNC_STR) || memcmp(data, BOOT_BAUD_SYNC_STR, len) != 0)
+        return;
+
+    boot_clear_flag(BOOT_FLAG_BAUD_CONFIRM);
+    log_info("Baud rate %d confirmed.", boot_baud_ctx.baudrate);
+    boot_cmd_print_menu();
+}
+
+/**
+ * @brief   恢复默认波特率，当前已是默认波特率时不做任何操作
+ * @details 在下载会话结束时调用，最后的应答已经发出（驱动等待发送完成后才切换）
+ */
+void boot_baud_restore(void)
+{
+    bsp_console_t *console = bsp_console_get();
+
+    if (!boot_baud_ctx.baudrate)
+        return;
+
+    console->ops->set_baudrate(console, 0);
+    boot_baud_ctx.baudrate = 0;
+}
@@ -0,0 +1,41 @@
+#ifndef BOOT_BAUD_H
+#define BOOT_BAUD_H
+
+#include <stdint.h>
+
+/*
+ * 传输阶段切换串口波特率
+ *
+ * 1. 菜单选择切换波特率，输入新的波特率（十进制 ASCII，如 "921600"）；
+ * 2. BootLoader 在旧波特率下回复提示后切换到新波特率；
+ * 3. 上位机切换到新波特率，在 BOOT_BAUD_CONFIRM_TIMEOUT_MS 内发送 BOOT_BAUD_SYNC_STR，
+ *    BootLoader 回复 "Baud rate ... confirmed"；超时未确认则恢复默认波特率；
+ * 4. 之后的下载会话结束（成功或失败）时自动恢复默认波特率。
+ */
+#define BOOT_BAUD_SYNC_STR  "SYNC"
+
+/**
+ * @brief   处理输入的波特率，切换串口并等待上位机确认
+ * @param[in] data 接收数据的首地址
+ * @param[in] len  接收数据的长度
+ */
+void boot_baud_request(uint8_t *data, uint32_t len);
+
+/**
+ * @brief   等待确认期间的超时计时，超时后恢复默认波特率
+ */
+void boot_baud_confirm_poll(void);
+
+/**
+ * @brief   处理上位机在新波特率下发送的确认字符串
+ * @param[in] data 接收数据的首地址
+ * @param[in] len  接收数据的长度
+ */
+void boot_baud_confirm(uint8_t *data, uint32_t len);
+
+/**
+ * @brief   恢复默认波特率，当前已是默认波特率时不做任何操作
+ */
+void boot_baud_restore(void);
+
+#endif
@@ -12,18 +12,19 @@
 
 #endif
 
-/* 内部 Flash (B 区: BootLoader, A 区: APP) */
+/* 内部 Flash (B 区: BootLoader, A 区: APP)，实际容量和页大小由 boot_flash_geometry_init 运行时读取 */
 #if BOOT_PLATFORM_STM32F1 || BOOT_PLATFORM_GD32F1
-#define BOOT_FLASH_BASE_ADDR        (0x08000000UL)  // Flash 起始地址
-#define BOOT_FLASH_PAGE_SIZE        (1024UL)        // Flash 页大小
-#define BOOT_FLASH_PAGE_COUNT       (64UL)          // Flash 总页数
-#define BOOT_FLASH_BOOT_PAGE_COUNT  (24UL)          // B 区 Flash 页数
-#define BOOT_FLASH_APP_PAGE_COUNT   (BOOT_FLASH_PAGE_COUNT - BOOT_FLASH_BOOT_PAGE_COUNT)    // A 区 Flash 页数
-#define BOOT_FLASH_APP_START_PAGE   (BOOT_FLASH_BOOT_PAGE_COUNT)                            // A 区 Flash 起始页编号
-#define BOOT_FLASH_APP_START_ADDR   (BOOT_FLASH_BASE_ADDR + BOOT_FLASH_APP_START_PAGE * BOOT_FLASH_PAGE_SIZE)  // A 区 Flash 起始地址
+#define BOOT_FLASH_BASE_ADDR        (0x08000000UL)      // Flash 起始地址
+#define BOOT_FLASH_SIZE_MAX         (512UL * 1024UL)    // 支持的最大 Flash 容量（F103xE），更大的器件只使用前 512KB
+#define BOOT_FLASH_PAGE_SIZE_MIN    (1024UL)            // 最小页大小（小/中容量 1KB，大容量/互联型 2KB）
+#define BOOT_FLASH_PAGE_COUNT_MAX   (BOOT_FLASH_SIZE_MAX / BOOT_FLASH_PAGE_SIZE_MIN)       // 最大页数
+#define BOOT_FLASH_BOOT_SIZE        (32UL * 1024UL)     // B 区字节数，须为 2KB 的整数倍，与 project/boot.sct 中 ER_IROM1 的大小一致
+#define BOOT_FLASH_APP_START_ADDR   (BOOT_FLASH_BASE_ADDR + BOOT_FLASH_BOOT_SIZE)          // A 区 Flash 起始地址
+#define BOOT_FLASH_APP_MAX_SIZE     (BOOT_FLASH_SIZE_MAX - BOOT_FLASH_BOOT_SIZE)           // A 区 Flash 最大字节数上限（静态数组大小）
+#define BOOT_FLASH_SIZE_DEFAULT     (64UL * 1024UL)     // 运行时读取前的缺省容量（F103C8）
 
 /* RAM 地址范围 */
-#define BOOT_RAM_SIZE       (20UL * 1024UL) // STM32F103C8T6 RAM: 20KB
+#define BOOT_RAM_SIZE       (20UL * 1024UL) // STM32F103C8T6 RAM: 20KB，RAM 容量无法运行时读取，换用更大 RAM 的器件时修改
 #define BOOT_RAM_BASE_ADDR  (0x20000000UL)
 #define BOOT_RAM_END_ADDR   (BOOT_RAM_BASE_ADDR + BOOT_RAM_SIZE - 1UL)
 
@@ -31,10 +32,13 @@
 
 #define BOOT_FLASH_BASE_ADDR            (0x08000000UL)  // Flash 起始地址
 #define BOOT_FLASH_SECOTR_COUNT         (12UL)          // Flash 总扇区数
-#define BOOT_FLASH_BOOT_SECOTR_COUNT    (2UL)           // B 区 Flash 扇区数
+#define BOOT_FLASH_BOOT_SECOTR_COUNT    (3UL)           // B 区 Flash 扇区数（扇区 0~2，共 48KB）
 #define BOOT_FLASH_APP_SECOTR_COUNT     (BOOT_FLASH_SECOTR_COUNT - BOOT_FLASH_BOOT_SECOTR_COUNT)    // A 区 Flash 扇区数
 #define BOOT_FLASH_APP_START_SECOTR     (BOOT_FLASH_BOOT_SECOTR_COUNT)                              // A 区 Flash 起始扇区编号
-#define BOOT_FLASH_APP_START_ADDR       (BOOT_FLASH_BASE_ADDR + 0x8000UL)   // A 区 Flash 起始地址
+#define BOOT_FLASH_APP_START_ADDR       (BOOT_FLASH_BASE_ADDR + 0xC000UL)   // A 区 Flash 起始地址
+#define BOOT_FLASH_APP_MAX_SIZE         ((1024UL - 48UL) * 1024UL)          // A 区 Flash 最大字节数（1MB 减去 B 区 48KB）
+#define BOOT_FLASH_SIZE_MAX             (1024UL * 1024UL)   // 支持的最大 Flash 容量，扇区表只覆盖单 Bank 1MB
+#define BOOT_FLASH_SIZE_DEFAULT         (1024UL * 1024UL)   // 运行时读取前的缺省容量（F405RG）
 
 /* RAM 地址范围 */
 #define BOOT_RAM_SIZE       (128UL * 1024UL)    // STM32F405RGT6 RAM: 128KB+64KB
@@ -42,11 +46,33 @@
 #define BOOT_RAM_END_ADDR   (BOOT_RAM_BASE_ADDR + BOOT_RAM_SIZE - 1UL)
 #endif
 
+/* CRC16 slice-by-4 查表（多占用 1.5KB Flash），F1 的 B 区较小默认关闭 */
+#if BOOT_PLATFORM_STM32F4
+#define BOOT_CRC16_SLICE_BY_4       (1)
+#else
+#define BOOT_CRC16_SLICE_BY_4       (0)
+#endif
+
+/* 流式传输窗口块数（每块 1KB），一个窗口必须能放进控制台串口的 rx_single_max */
+#if BOOT_PLATFORM_STM32F4
+#define BOOT_STREAM_WINDOW          (8)
+#else
+#define BOOT_STREAM_WINDOW          (1)
+#endif
+
+/* 传输阶段切换波特率：最高波特率，新波特率下等待上位机确认的超时时间 */
+#define BOOT_BAUD_MAX                   (2000000)
+#define BOOT_BAUD_CONFIRM_TIMEOUT_MS    (2000)
+
 /* APP 更新块大小 */
 #define BOOT_APP_UPDATE_CHUNK_SIZE  (1024)
+#define BOOT_APP_UPDATE_CHUNK_NUM   (2 * BOOT_STREAM_WINDOW)    // 一个窗口的数据块等待写 Flash 时，下一个窗口继续接收，至少两个（乒乓）
+#define BOOT_UPDATE_RESUME_INTERVAL (8)     // 已知固件大小时，每连续写入多少个数据块向 EEPROM 保存一次断点，0 表示不保存
 
 /* 外部Flash */
 #define BOOT_EXT_FLASH_BLOCK_SIZE       (64UL * 1024UL) // 外部 Flash 块大小
+#define BOOT_EXT_FLASH_HALF_BLOCK_SIZE  (32UL * 1024UL) // 外部 Flash 半块大小
+#define BOOT_EXT_FLASH_SECTOR_SIZE      (4UL * 1024UL)  // 外部 Flash 扇区大小，最小擦除单元
 #define BOOT_EXT_FLASH_PAGE_SIZE        (256UL)         // 外部 Flash 页大小
 #define BOOT_EXT_FLASH_APP_BLOCK_COUNT  (16UL)          // 外部 Flash 存储的每个 APP 的块数
 #define BOOT_EXT_FLASH_APP_MAX_SIZE     (BOOT_EXT_FLASH_BLOCK_SIZE * \
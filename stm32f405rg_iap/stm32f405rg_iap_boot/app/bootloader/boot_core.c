@@ -1,4 +1,5 @@
 #include <stdbool.h>
+#include <string.h>
 #include "bsp_delay.h"
 #include "boot_core.h"
 #include "boot_config.h"
@@ -7,6 +8,7 @@
 #include "boot_store.h"
 #include "boot_ota.h"
 #include "boot_ext_flash.h"
+#include "boot_flash.h"
 #include "log.h"
 
 #if BOOT_PLATFORM_STM32F1
@@ -23,12 +25,16 @@
 typedef void (*app_entry_t)(void);
 
 typedef struct {
-    uint8_t  update_chunk[BOOT_APP_UPDATE_CHUNK_SIZE];  // 更新 APP 时，每次搬运的数据块（内部 Flash 页大小）
+    uint8_t  update_chunk[BOOT_APP_UPDATE_CHUNK_NUM][BOOT_APP_UPDATE_CHUNK_SIZE];  // 更新 APP 时，每次搬运的数据块（内部 Flash 页大小），轮流使用
     uint32_t flag;  // 标志位
 } boot_ctx_t;
 
 static boot_ctx_t g_boot_ctx;
 
+/* SRAM 中的中断向量表，128 项覆盖 F103/F405/GD32F103 的全部向量，VTOR 要求按表大小向上取 2 的幂对齐 */
+#define BOOT_RAM_VECTOR_NUM     128
+static uint32_t boot_ram_vector[BOOT_RAM_VECTOR_NUM] __attribute__((aligned(BOOT_RAM_VECTOR_NUM * 4)));
+
 /**
  * @brief   设置目标应用程序的主堆栈指针（MSP）
  * @param[in] addr 启动向量表第 0 项的值（APP 初始 MSP）
@@ -44,7 +50,10 @@ __asm static void boot_set_msp(uint32_t addr)
  */
 static void boot_reset_periph(void)
 {
+    bsp_delay_t *delay = bsp_delay_get();
 
+    /* 停止 SysTick 时基，避免切换向量表后进入 APP 的 SysTick_Handler */
+    delay->ops->deinit(delay);
 }
 
 /**
@@ -74,18 +83,35 @@ static void boot_jump_to_app(uint32_t addr)
     reset_handler = *(uint32_t *)(addr + 4);
     app_entry = (app_entry_t)reset_handler;
 
+    /* 关闭外设，恢复系统状态 */
+    boot_reset_periph();
+
     /* 切换中断向量表到 APP 区 */
     SCB->VTOR = addr;
     __DSB();
     __ISB();
 
-    /* 关闭外设，恢复系统状态 */
-    boot_reset_periph();
-
     /* 跳转到 APP reset handler */
     app_entry();
 }
 
+/**
+ * @brief   把中断向量表拷贝到 SRAM 并切换 VTOR
+ * @details 擦写内部 Flash 期间从 Flash 取指/读数会被挂起到操作结束，向量表在 Flash 中时，
+ *          串口空闲中断要等擦除完成（F1 页约 20~40ms，F4 扇区可达秒级）才能取到入口地址。
+ *          向量表、串口中断和 SysTick 中断放在 SRAM 后，DMA 接收的分段处理不再被 Flash 操作推迟。
+ *          跳转 APP 时 VTOR 会重新指向 APP 向量表。
+ */
+static void boot_relocate_vector_table(void)
+{
+    __disable_irq();
+    memcpy(boot_ram_vector, (const void *)SCB->VTOR, sizeof(boot_ram_vector));
+    SCB->VTOR = (uint32_t)boot_ram_vector;
+    __DSB();
+    __ISB();
+    __enable_irq();
+}
+
 /**
  * @brief   BootLoader 检查是否进入命令行
  * @param[in] timeout_ms 超时时间（毫秒）
@@ -113,6 +139,9 @@ void boot_process_entry(void)
 {
     const uint16_t timeout_ms = 2000;
 
+    boot_relocate_vector_table();
+    boot_flash_geometry_init();
+
     log_info("Bootloader: Press 'w' within %d seconds to enter command line.", timeout_ms / 1000);
 
     /* 不进入命令行 */
@@ -178,9 +207,12 @@ uint32_t boot_get_flag(void)
 
 /**
  * @brief   BootLoader 获取 APP 更新块
+ * @details 第 chunk_idx 个数据块固定暂存在 chunk_idx % BOOT_APP_UPDATE_CHUNK_NUM 号缓冲区，
+ *          相邻数据块使用不同的缓冲区
+ * @param[in] chunk_idx 数据块索引（从 0 开始）
  * @return  APP 更新块首地址
  */
-uint8_t* boot_get_update_chunk(void)
+uint8_t* boot_get_update_chunk(uint32_t chunk_idx)
 {
-    return g_boot_ctx.update_chunk;
+    return g_boot_ctx.update_chunk[chunk_idx % BOOT_APP_UPDATE_CHUNK_NUM];
 }
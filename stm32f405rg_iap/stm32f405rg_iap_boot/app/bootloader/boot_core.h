@@ -13,6 +13,13 @@ typedef enum {
     BOOT_FLAG_EXT_LOAD_REQUEST     = 0x00000010,    // 请求加载外部 Flash 程序到内部 Flash（选择）
     BOOT_FLAG_EXT_LOAD             = 0x00000020,    // 执行加载外部 Flash 程序到内部 Flash
     BOOT_FLAG_OTA_VERSION_INIT     = 0x00000040,    // 初始化 OTA 版本号
+    BOOT_FLAG_IAP_YMODEM_SEND_C    = 0x00000080,    // 串口 IAP Ymodem 协议发 C
+    BOOT_FLAG_IAP_YMODEM_RECV_DATA = 0x00000100,    // 串口 IAP Ymodem 协议接收数据
+    BOOT_FLAG_EXT_DOWNLOAD_YMODEM  = 0x00000200,    // 外部 Flash 下载 Ymodem 协议传输
+    BOOT_FLAG_IAP_STREAM_RECV_DATA = 0x00000400,    // 串口 IAP 流式传输协议接收数据
+    BOOT_FLAG_EXT_DOWNLOAD_STREAM  = 0x00000800,    // 外部 Flash 下载流式传输协议传输
+    BOOT_FLAG_BAUD_REQUEST         = 0x00001000,    // 请求切换串口波特率（输入波特率）
+    BOOT_FLAG_BAUD_CONFIRM         = 0x00002000,    // 等待上位机在新波特率下确认
 } boot_flag_t;
 
 /**
@@ -52,8 +59,11 @@ uint32_t boot_get_flag(void);
 
 /**
  * @brief   BootLoader 获取 APP 更新块
+ * @details 第 chunk_idx 个数据块固定暂存在 chunk_idx % BOOT_APP_UPDATE_CHUNK_NUM 号缓冲区，
+ *          相邻数据块使用不同的缓冲区
+ * @param[in] chunk_idx 数据块索引（从 0 开始）
  * @return  APP 更新块首地址
  */
-uint8_t* boot_get_update_chunk(void);
+uint8_t* boot_get_update_chunk(uint32_t chunk_idx);
 
 #endif
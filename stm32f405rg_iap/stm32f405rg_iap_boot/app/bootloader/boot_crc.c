@@ -0,0 +1,120 @@
+#include <stdint.h>
+#include "boot_config.h"
+#include "boot_crc.h"
+
+/*
+ * CRC16/XMODEM 查表
+ *
+ * CRC 对输入按位线性（GF(2)），因此 table[b] 等于 b 中每个置位比特对应基值的异或：
+ *   table[b] = (b & 0x01 ? B0 : 0) ^ (b & 0x02 ? B1 : 0) ^ ... ^ (b & 0x80 ? B7 : 0)
+ * 只需给出 8 个基值，256 项表由宏在编译期展开生成，不占用 RAM，也不需要启动时初始化。
+ *
+ * 切片表 table_k[b] 表示字节 b 之后再跟 k 个 0x00 字节的 CRC，
+ * 用于 slice-by-4 一次处理 4 个字节。
+ */
+#define CRC16_ENTRY(b, B0, B1, B2, B3, B4, B5, B6, B7)   \
+    (uint16_t)(((b) & 0x01 ? (B0) : 0) ^ ((b) & 0x02 ? (B1) : 0) ^  \
+               ((b) & 0x04 ? (B2) : 0) ^ ((b) & 0x08 ? (B3) : 0) ^  \
+               ((b) & 0x10 ? (B4) : 0) ^ ((b) & 0x20 ? (B5) : 0) ^  \
+               ((b) & 0x40 ? (B6) : 0) ^ ((b) & 0x80 ? (B7) : 0))
+
+#define CRC_R4(b, T)        T(b), T((b) + 1), T((b) + 2), T((b) + 3)
+#define CRC_R16(b, T)       CRC_R4(b, T), CRC_R4((b) + 4, T), CRC_R4((b) + 8, T), CRC_R4((b) + 12, T)
+#define CRC_R64(b, T)       CRC_R16(b, T), CRC_R16((b) + 16, T), CRC_R16((b) + 32, T), CRC_R16((b) + 48, T)
+#define CRC_R256(T)         CRC_R64(0, T), CRC_R64(64, T), CRC_R64(128, T), CRC_R64(192, T)
+
+/* 基值：单个比特 (1 << i) 之后跟 k 个 0x00 字节的 CRC */
+#define CRC16_T0(b) CRC16_ENTRY(b, 0x1021, 0x2042, 0x4084, 0x8108, 0x1231, 0x2462, 0x48C4, 0x9188)
+#define CRC16_T1(b) CRC16_ENTRY(b, 0x3331, 0x6662, 0xCCC4, 0x89A9, 0x0373, 0x06E6, 0x0DCC, 0x1B98)
+#define CRC16_T2(b) CRC16_ENTRY(b, 0x3730, 0x6E60, 0xDCC0, 0xA9A1, 0x4363, 0x86C6, 0x1DAD, 0x3B5A)
+#define CRC16_T3(b) CRC16_ENTRY(b, 0x76B4, 0xED68, 0xCAF1, 0x85C3, 0x1BA7, 0x374E, 0x6E9C, 0xDD38)
+
+static const uint16_t crc16_table[256] = { CRC_R256(CRC16_T0) };
+
+#if BOOT_CRC16_SLICE_BY_4
+static const uint16_t crc16_table1[256] = { CRC_R256(CRC16_T1) };
+static const uint16_t crc16_table2[256] = { CRC_R256(CRC16_T2) };
+static const uint16_t crc16_table3[256] = { CRC_R256(CRC16_T3) };
+#endif
+
+/* CRC32/MPEG-2（多项式 0x04C11DB7，与 STM32 硬件 CRC 单元一致），同样由基值展开 */
+#define CRC32_ENTRY(b, B0, B1, B2, B3, B4, B5, B6, B7)   \
+    (uint32_t)(((b) & 0x01 ? (B0) : 0) ^ ((b) & 0x02 ? (B1) : 0) ^  \
+               ((b) & 0x04 ? (B2) : 0) ^ ((b) & 0x08 ? (B3) : 0) ^  \
+               ((b) & 0x10 ? (B4) : 0) ^ ((b) & 0x20 ? (B5) : 0) ^  \
+               ((b) & 0x40 ? (B6) : 0) ^ ((b) & 0x80 ? (B7) : 0))
+
+#define CRC32_T0(b) CRC32_ENTRY(b, 0x04C11DB7UL, 0x09823B6EUL, 0x130476DCUL, 0x2608EDB8UL, \
+                                   0x4C11DB70UL, 0x9823B6E0UL, 0x34867077UL, 0x690CE0EEUL)
+
+static const uint32_t crc32_table[256] = { CRC_R256(CRC32_T0) };
+
+/**
+ * @brief   计算 CRC16/XMODEM 校验值（多项式 0x1021，不反转，无输出异或）
+ * @details 默认逐字节查表；开启 BOOT_CRC16_SLICE_BY_4 后每次处理 4 个字节，
+ *          多占用 1.5KB Flash 存放 3 张切片表
+ * @param[in] crc  初始值
+ * @param[in] data 待校验的数据
+ * @param[in] len  数据长度
+ * @return	CRC16 校验值
+ */
+uint16_t boot_crc16(uint16_t crc, const uint8_t *data, uint32_t len)
+{
+#if BOOT_CRC16_SLICE_BY_4
+    while (len >= 4) {
+        crc ^= (data[0] << 8) | data[1];
+        crc = crc16_table3[crc >> 8] ^ crc16_table2[crc & 0xFF] ^
+              crc16_table1[data[2]] ^ crc16_table[data[3]];
+        data += 4;
+        len  -= 4;
+    }
+#endif
+
+    while (len--)
+        crc = (crc << 8) ^ crc16_table[(crc >> 8) ^ *data++];
+
+    return crc;
+}
+
+/**
+ * @brief   计算 CRC32/MPEG-2 校验值（多项式 0x04C11DB7，不反转，无输出异或）
+ * @details 支持分段计算：首段传入 crc = 0xFFFFFFFF，后续段传入上一段的返回值
+ * @param[in] crc  初始值
+ * @param[in] data 待校验的数据
+ * @param[in] len  数据长度
+ * @return	CRC32 校验值
+ */
+uint32_t boot_crc32(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+    while (len--)
+        crc = (crc << 8) ^ crc32_table[(crc >> 24) ^ *data++];
+
+    return crc;
+}
+
+/**
+ * @brief   按硬件 CRC 单元的顺序计算 CRC32/MPEG-2
+ * @details 每 4 个字节按小端组成一个字，从最高位开始处理，对 4 字节对齐的数据与 bsp_crc 的计算结果相同，
+ *          用于与硬件 CRC 校验 Flash 的结果比较。len 不是 4 的倍数时，最后不足一个字的部分按补 0xFF 计算
+ *          （与内部 Flash 尾部的填充一致），因此分段计算时只有最后一段可以不是 4 的倍数。
+ * @param[in] crc  初始值，首段传入 0xFFFFFFFF
+ * @param[in] data 待校验的数据，不要求对齐
+ * @param[in] len  数据长度
+ * @return	CRC32 校验值
+ */
+uint32_t boot_crc32_word(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+    uint8_t word[4];
+    uint8_t i;
+
+    while (len) {
+        for (i = 0; i < 4; i++)
+            word[i] = i < len ? data[i] : 0xFF;
+        for (i = 4; i > 0; i--)
+            crc = (crc << 8) ^ crc32_table[(crc >> 24) ^ word[i - 1]];
+        data += len < 4 ? len : 4;
+        len  -= len < 4 ? len : 4;
+    }
+
+    return crc;
+}
@@ -0,0 +1,37 @@
+#ifndef BOOT_CRC_H
+#define BOOT_CRC_H
+
+#include <stdint.h>
+
+/**
+ * @brief   计算 CRC16/XMODEM 校验值（多项式 0x1021，不反转，无输出异或）
+ * @details 支持分段计算：首段传入 crc = 0，后续段传入上一段的返回值
+ * @param[in] crc  初始值
+ * @param[in] data 待校验的数据
+ * @param[in] len  数据长度
+ * @return	CRC16 校验值
+ */
+uint16_t boot_crc16(uint16_t crc, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief   计算 CRC32/MPEG-2 校验值（多项式 0x04C11DB7，不反转，无输出异或）
+ * @details 支持分段计算：首段传入 crc = 0xFFFFFFFF，后续段传入上一段的返回值
+ * @param[in] crc  初始值
+ * @param[in] data 待校验的数据
+ * @param[in] len  数据长度
+ * @return	CRC32 校验值
+ */
+uint32_t boot_crc32(uint32_t crc, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief   按硬件 CRC 单元的顺序计算 CRC32/MPEG-2（每 4 字节按小端组成一个字，从最高位开始处理）
+ * @details 结果与 bsp_crc 对同一段数据的计算结果相同。不足一个字的尾部按补 0xFF 计算，
+ *          分段计算时只有最后一段可以不是 4 的倍数，首段传入 crc = 0xFFFFFFFF
+ * @param[in] crc  初始值
+ * @param[in] data 待校验的数据
+ * @param[in] len  数据长度
+ * @return	CRC32 校验值
+ */
+uint32_t boot_crc32_word(uint32_t crc, const uint8_t *data, uint32_t len);
+
+#endif
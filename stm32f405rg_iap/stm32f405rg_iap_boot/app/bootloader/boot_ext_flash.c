@@ -1,4 +1,6 @@
 
+#include <errno.h>
+#include <stdbool.h>
 #include "bsp_flash.h"
 #include "bsp_ext_flash.h"
 #include "boot_config.h"
@@ -6,48 +8,256 @@
 #include "boot_flash.h"
 #include "boot_ext_flash.h"
 #include "boot_cmd.h"
+#include "boot_crc.h"
 #include "boot_store.h"
 #include "boot_xmodem.h"
+#include "boot_ymodem.h"
+#include "boot_stream.h"
 #include "log.h"
 
 typedef struct {
-    uint8_t slot_idx;  // 外部 Flash 程序索引，判断更新第几个程序到 A 区（第 0 个保留）
+    uint8_t  slot_idx;      // 外部 Flash 程序索引，判断更新第几个程序到 A 区（第 0 个保留）
+    uint32_t erased;        // 当前槽位从起始处已擦除的字节数，按扇区对齐
+    uint32_t erase_size;    // 当前槽位预计写入的字节数，按扇区向上取整，决定擦除单元的大小
+    uint8_t *wr_data;       // 后台写入的下一页数据
+    uint32_t wr_offset;     // 后台写入的下一页在槽位内的偏移
+    uint32_t wr_end;        // 后台写入的结束偏移，wr_offset 到达 wr_end 且外部 Flash 空闲时写入完成
 } boot_ext_flash_ctx_t;
 
 static boot_ext_flash_ctx_t boot_ext_flash_ctx;
 
 /**
- * @brief   将完整 update_chunk 数据块写入外部 Flash
+ * @brief   发出擦除当前槽位中下一个未擦除扇区/块的指令，不等待擦除完成
+ * @details 擦除位置只向前推进，已写入数据的区域不会再被擦除。每次选择对齐且不超过剩余预计大小的
+ *          最大擦除单元：64KB 块（0xD8）、32KB 半块（0x52）或 4KB 扇区（0x20）
+ * @param[in] ext_flash 指向外部 Flash BSP 对象的指针
+ * @return	0 表示成功，其他值表示失败
+ */
+static int boot_ext_flash_erase_next(bsp_ext_flash_t *ext_flash)
+{
+    uint32_t base = boot_ext_flash_ctx.slot_idx * BOOT_EXT_FLASH_APP_MAX_SIZE;
+    uint32_t erased = boot_ext_flash_ctx.erased;
+    uint32_t remain = boot_ext_flash_ctx.erase_size > erased ? boot_ext_flash_ctx.erase_size - erased : 0;
+    uint32_t unit;
+    int ret;
+
+    if (erased % BOOT_EXT_FLASH_BLOCK_SIZE == 0 && remain >= BOOT_EXT_FLASH_BLOCK_SIZE) {
+        unit = BOOT_EXT_FLASH_BLOCK_SIZE;
+        ret = ext_flash->ops->erase_block_start(ext_flash, (base + erased) / BOOT_EXT_FLASH_BLOCK_SIZE);
+    } else if (erased % BOOT_EXT_FLASH_HALF_BLOCK_SIZE == 0 && remain >= BOOT_EXT_FLASH_HALF_BLOCK_SIZE) {
+        unit = BOOT_EXT_FLASH_HALF_BLOCK_SIZE;
+        ret = ext_flash->ops->erase_block_32k_start(ext_flash, base + erased);
+    } else {
+        unit = BOOT_EXT_FLASH_SECTOR_SIZE;
+        ret = ext_flash->ops->erase_sector_start(ext_flash, base + erased);
+    }
+    if (ret)
+        return ret;
+
+    boot_ext_flash_ctx.erased = erased + unit;
+    return 0;
+}
+
+/**
+ * @brief   开始按需擦除当前槽位，之后由 boot_ext_flash_write_chunk 在写指针进入新的扇区/块时擦除
+ * @details 选择槽位时不再擦除整个槽位，擦除时间分摊到传输过程中，且只与固件大小有关。
+ *          已知固件大小时只擦除固件覆盖的范围（按 4KB 扇区向上取整），未知时按 64KB 块推进
+ * @param[in] size 固件字节数，0 表示未知（如 Xmodem），按槽位最大容量
+ */
+void boot_ext_flash_erase_begin(uint32_t size)
+{
+    if (size == 0 || size > BOOT_EXT_FLASH_APP_MAX_SIZE)
+        size = BOOT_EXT_FLASH_APP_MAX_SIZE;
+
+    boot_ext_flash_ctx.erased = 0;
+    boot_ext_flash_ctx.wr_offset = 0;
+    boot_ext_flash_ctx.wr_end = 0;
+    boot_ext_flash_ctx.erase_size = (size + BOOT_EXT_FLASH_SECTOR_SIZE - 1) / BOOT_EXT_FLASH_SECTOR_SIZE *
+                                    BOOT_EXT_FLASH_SECTOR_SIZE;
+}
+
+/**
+ * @brief   从断点继续下载：当前槽位前 size 字节已经写入，它们所在的扇区不再擦除
+ * @details 断点所在的扇区在中断前的下载中已经擦除，其中断点之后的部分只可能写过本固件的相同数据，
+ *          可以直接继续写入。在 boot_ext_flash_erase_begin 之后调用。
+ * @param[in] size 已写入的字节数
+ */
+void boot_ext_flash_resume(uint32_t size)
+{
+    boot_ext_flash_ctx.erased = (size + BOOT_EXT_FLASH_SECTOR_SIZE - 1) / BOOT_EXT_FLASH_SECTOR_SIZE *
+                                BOOT_EXT_FLASH_SECTOR_SIZE;
+}
+
+/**
+ * @brief   启动将 update_chunk 数据块写入外部 Flash，之后由 boot_ext_flash_write_poll 在后台逐页写入
+ * @details 只记录写入范围，不访问外部 Flash。写入完成前 update_chunk 中还未写入的页不能修改
+ * @param[in] ext_flash 指向外部 Flash BSP 对象的指针
+ * @param[in] chunk_idx update_chunk 的块索引（从 0 开始），表示从应用起始地址起要写入的第几个块
+ * @param[in] len       chunk 内的有效字节数，只写入有效字节覆盖的页
+ * @return	0 表示已启动，-EBUSY 表示上一个数据块还未写完
+ */
+int boot_ext_flash_write_chunk_start(bsp_ext_flash_t *ext_flash, uint32_t chunk_idx, uint32_t len)
+{
+    (void)ext_flash;
+
+    if (boot_ext_flash_ctx.wr_offset < boot_ext_flash_ctx.wr_end)
+        return -EBUSY;
+
+    boot_ext_flash_ctx.wr_data   = boot_get_update_chunk(chunk_idx);
+    boot_ext_flash_ctx.wr_offset = chunk_idx * BOOT_APP_UPDATE_CHUNK_SIZE;
+    boot_ext_flash_ctx.wr_end    = boot_ext_flash_ctx.wr_offset + len;
+    return 0;
+}
+
+/**
+ * @brief   推进后台写入：外部 Flash 空闲时发出下一条擦除或页编程指令后立即返回
+ * @details 写指针进入还未擦除的扇区/块时先擦除，之后按页写入。每次调用最多发出一条指令，
+ *          64KB 块擦除等耗时的操作在外部 Flash 内部进行，期间主循环可以继续接收数据
+ * @param[in] ext_flash 指向外部 Flash BSP 对象的指针
+ * @return	0 表示写入完成，-EBUSY 表示写入中，其他值表示失败（此时放弃剩余的页）
+ */
+int boot_ext_flash_write_poll(bsp_ext_flash_t *ext_flash)
+{
+    uint32_t base = boot_ext_flash_ctx.slot_idx * BOOT_EXT_FLASH_APP_MAX_SIZE;
+    uint32_t page_len;
+    int ret;
+
+    ret = ext_flash->ops->busy_poll(ext_flash);
+    if (ret == 0 && boot_ext_flash_ctx.wr_offset < boot_ext_flash_ctx.wr_end) {
+        if (boot_ext_flash_ctx.erased <= boot_ext_flash_ctx.wr_offset) {
+            ret = boot_ext_flash_erase_next(ext_flash);
+        } else {
+            /* 外部 Flash 必须按页写，块内的页都按页对齐 */
+            page_len = boot_ext_flash_ctx.wr_end - boot_ext_flash_ctx.wr_offset;
+            if (page_len > BOOT_EXT_FLASH_PAGE_SIZE)
+                page_len = BOOT_EXT_FLASH_PAGE_SIZE;
+
+            ret = ext_flash->ops->write_page_start(ext_flash, base + boot_ext_flash_ctx.wr_offset,
+                                                   page_len, boot_ext_flash_ctx.wr_data);
+            boot_ext_flash_ctx.wr_data   += page_len;
+            boot_ext_flash_ctx.wr_offset += page_len;
+        }
+        if (ret == 0)
+            ret = -EBUSY;
+    }
+
+    if (ret && ret != -EBUSY)
+        boot_ext_flash_ctx.wr_offset = boot_ext_flash_ctx.wr_end;
+    return ret;
+}
+
+/**
+ * @brief   将 update_chunk 数据块写入外部 Flash，写入完成后返回
+ * @details 写入前擦除数据覆盖的、还未擦除的扇区/块
  * @param[in] ext_flash 指向外部 Flash BSP 对象的指针
  * @param[in] chunk_idx update_chunk 的块索引（从 0 开始），表示从应用起始地址起要写入的第几个块
+ * @param[in] len       chunk 内的有效字节数，只写入有效字节覆盖的页
+ * @return	0 表示成功，其他值表示失败
  */
-void boot_ext_flash_write_chunk(bsp_ext_flash_t *ext_flash, uint32_t chunk_idx)
+int boot_ext_flash_write_chunk(bsp_ext_flash_t *ext_flash, uint32_t chunk_idx, uint32_t len)
 {
-	uint8_t i;
-	uint32_t base_addr = boot_ext_flash_ctx.slot_idx * BOOT_EXT_FLASH_APP_MAX_SIZE +
-                    	 chunk_idx * BOOT_APP_UPDATE_CHUNK_SIZE;
-    uint8_t *update_chunk = boot_get_update_chunk();
-	
-	/* 外部 Flash 必须按页写，按页循环写入 update_chunk 中的数据 */
-	for (i = 0; i < BOOT_APP_UPDATE_CHUNK_SIZE / BOOT_EXT_FLASH_PAGE_SIZE; i++) {
-		ext_flash->ops->write_page(ext_flash, 
-								   base_addr + i * BOOT_EXT_FLASH_PAGE_SIZE, 
-								   BOOT_EXT_FLASH_PAGE_SIZE, 
-								   &update_chunk[i * BOOT_EXT_FLASH_PAGE_SIZE]);
-	}
+	int ret;
+
+	ret = boot_ext_flash_write_chunk_start(ext_flash, chunk_idx, len);
+	if (ret)
+		return ret;
+
+	while ((ret = boot_ext_flash_write_poll(ext_flash)) == -EBUSY);
+	return ret;
+}
+
+/**
+ * @brief   等待外部 Flash 异步读取完成
+ * @param[in] ext_flash 指向外部 Flash BSP 对象的指针
+ * @return	0 表示成功，其他值表示读取失败
+ */
+static int boot_ext_flash_read_wait(bsp_ext_flash_t *ext_flash)
+{
+    int ret;
+
+    while ((ret = ext_flash->ops->read_data_poll(ext_flash)) == -EBUSY);
+    return ret;
+}
+
+/**
+ * @brief   计算外部 Flash 槽位中一段数据的 CRC32
+ * @details 分段读入栈上的两个小缓冲区交替使用，不占用 update_chunk；SPI 使用 DMA 时，
+ *          计算当前一段的 CRC 的同时读取下一段。每段 64 字节，按字计算时只有最后一段不足一个字
+ * @param[in] slot_idx 槽位索引
+ * @param[in] offset   槽位内的起始偏移
+ * @param[in] len      字节数
+ * @param[in] crc      CRC 初值（续算时传入上一段的结果）
+ * @param[in] word     true 表示按硬件 CRC 单元的字顺序计算（boot_crc32_word），false 表示逐字节计算
+ * @return  CRC32 值，读外部 Flash 失败时返回 ~crc（与正确值必然不同）
+ */
+static uint32_t boot_ext_flash_calc(uint8_t slot_idx, uint32_t offset, uint32_t len, uint32_t crc, bool word)
+{
+    uint8_t buf[2][64];
+    uint8_t cur = 0;
+    uint32_t piece;
+    uint32_t next;
+    uint32_t addr = slot_idx * BOOT_EXT_FLASH_APP_MAX_SIZE + offset;
+    bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
+
+    if (len == 0)
+        return crc;
+
+    piece = len > sizeof(buf[0]) ? sizeof(buf[0]) : len;
+    if (ext_flash->ops->read_data_start(ext_flash, addr, piece, buf[cur]))
+        return ~crc;
+
+    while (len) {
+        if (boot_ext_flash_read_wait(ext_flash))
+            return ~crc;
+        addr += piece;
+        len  -= piece;
+
+        /* 先启动下一段读取，再计算当前一段 */
+        next = len > sizeof(buf[0]) ? sizeof(buf[0]) : len;
+        if (next && ext_flash->ops->read_data_start(ext_flash, addr, next, buf[cur ^ 1]))
+            return ~crc;
+
+        crc = word ? boot_crc32_word(crc, buf[cur], piece) : boot_crc32(crc, buf[cur], piece);
+        piece = next;
+        cur ^= 1;
+    }
+    return crc;
+}
+
+/**
+ * @brief   计算外部 Flash 槽位中一段数据的 CRC32/MPEG-2
+ * @param[in] slot_idx 槽位索引
+ * @param[in] offset   槽位内的起始偏移
+ * @param[in] len      字节数
+ * @param[in] crc      CRC 初值（续算时传入上一段的结果）
+ * @return  CRC32 值，读外部 Flash 失败时返回 ~crc（与正确值必然不同）
+ */
+uint32_t boot_ext_flash_calc_crc(uint8_t slot_idx, uint32_t offset, uint32_t len, uint32_t crc)
+{
+    return boot_ext_flash_calc(slot_idx, offset, len, crc, false);
+}
+
+/**
+ * @brief   按硬件 CRC 单元的字顺序计算外部 Flash 槽位中整个固件的 CRC32，用于 boot_flash_verify
+ * @param[in] slot_idx 槽位索引
+ * @param[in] size     固件字节数
+ * @return  CRC32 值，读外部 Flash 失败时返回与正确值不同的值
+ */
+uint32_t boot_ext_flash_calc_image_crc(uint8_t slot_idx, uint32_t size)
+{
+    return boot_ext_flash_calc(slot_idx, 0, size, 0xFFFFFFFF, true);
 }
 
 /**
  * @brief   请求下载程序到外部 Flash
+ * @details 根据 BOOT_FLAG_EXT_DOWNLOAD_YMODEM / BOOT_FLAG_EXT_DOWNLOAD_STREAM 决定使用的协议，
+ *          Ymodem 批量传输时从所选槽位开始，每个文件依次写入下一个槽位
  * @param[in] data 接收数据的首地址
  * @param[in] len  接收数据的长度
  */
 void boot_ext_flash_download_request(uint8_t *data, uint32_t len)
 {
-    uint8_t i;
-    int ret;
     boot_app_info_t boot_app_info;
-    bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
 
     if (len != 1) {
         log_warn("Invalid input length: %d", len);
@@ -62,26 +272,38 @@ void boot_ext_flash_download_request(uint8_t *data, uint32_t len)
 
     boot_ext_flash_ctx.slot_idx = data[0] - '0';
     boot_clear_flag(BOOT_FLAG_EXT_DOWNLOAD_REQUEST);
+
+    /* Ymodem 在收到文件头后按文件大小规划擦除，支持一次会话写入多个槽位 */
+    if (boot_has_flag(BOOT_FLAG_EXT_DOWNLOAD_YMODEM)) {
+        boot_set_flag(BOOT_FLAG_IAP_YMODEM_SEND_C);
+        boot_set_flag(BOOT_FLAG_IAP_YMODEM_RECV_DATA);
+        boot_ymodem_init();
+
+        log_info("Use Ymodem to download BIN file(s) to external Flash, starting at slot %d.",
+                 boot_ext_flash_ctx.slot_idx);
+        return;
+    }
+
+    /* 流式传输在 START 帧中给出固件大小，收到后按大小规划擦除 */
+    if (boot_has_flag(BOOT_FLAG_EXT_DOWNLOAD_STREAM)) {
+        boot_set_flag(BOOT_FLAG_IAP_STREAM_RECV_DATA);
+        boot_stream_init();
+
+        log_info("Use stream protocol to download a BIN file to external Flash slot %d.",
+                 boot_ext_flash_ctx.slot_idx);
+        return;
+    }
+
     boot_set_flag(BOOT_FLAG_IAP_XMODEM_SEND_C);
     boot_set_flag(BOOT_FLAG_IAP_XMODEM_RECV_DATA);
     boot_set_flag(BOOT_FLAG_EXT_DOWNLOAD_XMODEM);
     boot_xmodem_init();
 
+    /* 槽位按需擦除，写入数据时擦除写指针进入的块 */
     boot_app_info_load(&boot_app_info);
     boot_app_info.app_size[boot_ext_flash_ctx.slot_idx] = 0;
     boot_app_info_save(&boot_app_info);
 
-    /* 擦除要写入程序的块 */
-    log_info("Erasing the %dth firmware of external Flash...", boot_ext_flash_ctx.slot_idx);
-    for (i = 0; i < BOOT_EXT_FLASH_APP_BLOCK_COUNT; i++) {
-        ret = ext_flash->ops->erase_block(ext_flash, 
-                                          boot_ext_flash_ctx.slot_idx * BOOT_EXT_FLASH_APP_BLOCK_COUNT + i);
-        if (ret) {
-            log_error("Failed to erase block (err=%d)", ret);
-        }
-        log_info("Erased block %d/%d", i + 1, BOOT_EXT_FLASH_APP_BLOCK_COUNT);
-    }
-
     log_info("Use Xmodem to download a BIN file to external Flash slot %d.",
              boot_ext_flash_ctx.slot_idx);
 }
@@ -118,54 +340,106 @@ void boot_ext_flash_load(void)
     bsp_flash_t *flash = bsp_flash_get();
     bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
     boot_app_info_t boot_app_info;
-    uint8_t *update_chunk = boot_get_update_chunk();
+    uint8_t *update_chunk = boot_get_update_chunk(0);
     uint8_t ext_flash_slot_idx = boot_ext_flash_ctx.slot_idx;
     uint32_t app_size;
+    uint32_t remaining_bytes;
+    uint32_t chunk_cnt;
     uint32_t chunk_idx;
     uint32_t i;
+    int ret;
     
     boot_app_info_load(&boot_app_info);
     app_size = boot_app_info.app_size[ext_flash_slot_idx];
 
     log_info("Loading firmware from slot %d (size=%d bytes)", ext_flash_slot_idx, app_size);
-    
-    /* 判断下载长度是否为4字节对齐 */
-    if (app_size % 4 != 0) {
-		log_error("Invalid firmware size (must be 4-byte aligned): %d", app_size);
+
+    /* 内部 Flash A 区按需擦除，只擦除固件实际占用且内容有变化的页/扇区 */
+    boot_flash_erase_begin();
+    ret = boot_flash_erase_plan(flash, app_size);
+    if (ret) {
+        log_error("Failed to prepare APP area for slot %d (err=%d)", ext_flash_slot_idx, ret);
         boot_clear_flag(BOOT_FLAG_EXT_LOAD);
         return;
     }
 
-    /* 擦除内部Flash A区 */
-    boot_flash_erase_app();
+    /*
+     * 先写完整的页：第 i 块和第 i+1 块交替使用两个 update_chunk，SPI 使用 DMA 时，
+     * 第 i 块写入内部 Flash 的同时读取第 i+1 块
+     */
+    chunk_cnt = app_size / BOOT_APP_UPDATE_CHUNK_SIZE;
+    if (chunk_cnt)
+        ext_flash->ops->read_data_start(ext_flash, 
+                                        ext_flash_slot_idx * BOOT_EXT_FLASH_APP_MAX_SIZE, 
+                                        BOOT_APP_UPDATE_CHUNK_SIZE, 
+                                        boot_get_update_chunk(0));
+    for (i = 0; i < chunk_cnt; i++) {
+        chunk_idx = i;
+        ret = boot_ext_flash_read_wait(ext_flash);
+        if (ret) {
+            log_error("Failed to read chunk %d from slot %d (err=%d)", chunk_idx, ext_flash_slot_idx, ret);
+            boot_clear_flag(BOOT_FLAG_EXT_LOAD);
+            return;
+        }
 
-    /* 下载长度为4字节对齐，先写完整的页 */
-    for (i = 0; i < app_size / BOOT_APP_UPDATE_CHUNK_SIZE; i++) {
-        /* 从W25QX中搬运出一次数据到update_buf */
-        ext_flash->ops->read_data(ext_flash, 
-                                  ext_flash_slot_idx * BOOT_EXT_FLASH_APP_MAX_SIZE + i * BOOT_APP_UPDATE_CHUNK_SIZE, 
-                                  BOOT_APP_UPDATE_CHUNK_SIZE, 
-                                  update_chunk);
+        /* 启动下一块的读取 */
+        if (i + 1 < chunk_cnt)
+            ext_flash->ops->read_data_start(ext_flash, 
+                                            ext_flash_slot_idx * BOOT_EXT_FLASH_APP_MAX_SIZE + (i + 1) * BOOT_APP_UPDATE_CHUNK_SIZE, 
+                                            BOOT_APP_UPDATE_CHUNK_SIZE, 
+                                            boot_get_update_chunk(i + 1));
 
         /* 将本次数据写入内部 Flash */
-        chunk_idx = i;
-        boot_flash_write_chunk(flash, chunk_idx);
-        log_info("Updated %d/%d chunks", i, app_size / BOOT_APP_UPDATE_CHUNK_SIZE);
+        if (boot_flash_write_chunk(flash, chunk_idx) != 0) {
+            boot_ext_flash_read_wait(ext_flash);
+            log_error("Failed to write chunk %d", chunk_idx);
+            boot_clear_flag(BOOT_FLAG_EXT_LOAD);
+            return;
+        }
+        log_info("Updated %d/%d chunks", i, chunk_cnt);
     }
+    update_chunk = boot_get_update_chunk(i);
 
     /* 处理剩余不足一页的字节 */
-    if (app_size % BOOT_APP_UPDATE_CHUNK_SIZE != 0) {
+    remaining_bytes = app_size % BOOT_APP_UPDATE_CHUNK_SIZE;
+    if (remaining_bytes != 0) {
         /* 从W25QX中搬运出剩余数据 */
-        ext_flash->ops->read_data(ext_flash, 
-                                  ext_flash_slot_idx * BOOT_EXT_FLASH_APP_MAX_SIZE + i * BOOT_APP_UPDATE_CHUNK_SIZE, 
-                                  app_size % BOOT_APP_UPDATE_CHUNK_SIZE, 
-                                  update_chunk);
+        ret = ext_flash->ops->read_data(ext_flash, 
+                                        ext_flash_slot_idx * BOOT_EXT_FLASH_APP_MAX_SIZE + i * BOOT_APP_UPDATE_CHUNK_SIZE, 
+                                        remaining_bytes, 
+                                        update_chunk);
+        if (ret) {
+            log_error("Failed to read chunk %d from slot %d (err=%d)", i, ext_flash_slot_idx, ret);
+            boot_clear_flag(BOOT_FLAG_EXT_LOAD);
+            return;
+        }
+
+        /* 内部 Flash 按字写入，不足 4 字节的尾部补 0xFF（与擦除值一致） */
+        while (remaining_bytes % 4 != 0)
+            update_chunk[remaining_bytes++] = 0xFF;
 
         /* 将剩余数据写入内部 Flash */
-        flash->ops->write(flash, 
-                          BOOT_FLASH_APP_START_ADDR + i * BOOT_APP_UPDATE_CHUNK_SIZE, 
-                          app_size % BOOT_APP_UPDATE_CHUNK_SIZE, 
-                          (uint32_t *)update_chunk);
+        ret = boot_flash_program(flash, 
+                                 BOOT_FLASH_APP_START_ADDR + i * BOOT_APP_UPDATE_CHUNK_SIZE, 
+                                 remaining_bytes, 
+                                 update_chunk);
+        if (ret) {
+            log_error("Failed to write chunk %d (err=%d)", i, ret);
+            boot_clear_flag(BOOT_FLAG_EXT_LOAD);
+            return;
+        }
+    }
+    log_info("%d chunks identical to Flash skipped", boot_flash_get_skipped());
+
+    /*
+     * 硬件 CRC 校验内部 Flash 中的整个固件，参考值从槽位重新读出计算，与中转的 update_chunk 无关。
+     * 失败时不清除 OTA 标志，下次上电重新加载
+     */
+    ret = boot_flash_verify(app_size, boot_ext_flash_calc_image_crc(ext_flash_slot_idx, app_size));
+    if (ret) {
+        log_error("Firmware verify failed for slot %d (err=%d)", ext_flash_slot_idx, ret);
+        boot_clear_flag(BOOT_FLAG_EXT_LOAD);
+        return;
     }
     
     /* 如果是 OTA 升级，清除 OTA 标志位 */
@@ -190,6 +464,15 @@ uint8_t boot_ext_flash_get_cur_slot_idx(void)
     return boot_ext_flash_ctx.slot_idx;
 }
 
+/**
+ * @brief   设置当前外部 Flash 程序索引
+ * @param[in] slot_idx 外部 Flash 程序索引
+ */
+void boot_ext_flash_set_cur_slot_idx(uint8_t slot_idx)
+{
+    boot_ext_flash_ctx.slot_idx = slot_idx;
+}
+
 /**
  * @brief   外部 Flash OTA 初始化
  */
@@ -5,11 +5,59 @@
 #include "bsp_ext_flash.h"
 
 /**
- * @brief   将完整 update_chunk 数据块写入外部 Flash
+ * @brief   将 update_chunk 数据块写入外部 Flash
  * @param[in] ext_flash 指向外部 Flash BSP 对象的指针
  * @param[in] chunk_idx update_chunk 的块索引（从 0 开始），表示从应用起始地址起要写入的第几个块
+ * @param[in] len       chunk 内的有效字节数，只写入有效字节覆盖的页
+ * @return	0 表示成功，其他值表示失败
  */
-void boot_ext_flash_write_chunk(bsp_ext_flash_t *ext_flash, uint32_t chunk_idx);
+int boot_ext_flash_write_chunk(bsp_ext_flash_t *ext_flash, uint32_t chunk_idx, uint32_t len);
+
+/**
+ * @brief   启动将 update_chunk 数据块写入外部 Flash，之后由 boot_ext_flash_write_poll 在后台逐页写入
+ * @param[in] ext_flash 指向外部 Flash BSP 对象的指针
+ * @param[in] chunk_idx update_chunk 的块索引（从 0 开始）
+ * @param[in] len       chunk 内的有效字节数
+ * @return	0 表示已启动，-EBUSY 表示上一个数据块还未写完
+ */
+int boot_ext_flash_write_chunk_start(bsp_ext_flash_t *ext_flash, uint32_t chunk_idx, uint32_t len);
+
+/**
+ * @brief   推进后台写入，外部 Flash 空闲时发出下一条擦除或页编程指令后立即返回
+ * @param[in] ext_flash 指向外部 Flash BSP 对象的指针
+ * @return	0 表示写入完成，-EBUSY 表示写入中，其他值表示失败
+ */
+int boot_ext_flash_write_poll(bsp_ext_flash_t *ext_flash);
+
+/**
+ * @brief   开始按需擦除当前槽位，之后由 boot_ext_flash_write_chunk 在写指针进入新的扇区/块时擦除
+ * @param[in] size 固件字节数，0 表示未知（如 Xmodem），按槽位最大容量
+ */
+void boot_ext_flash_erase_begin(uint32_t size);
+
+/**
+ * @brief   从断点继续下载：当前槽位前 size 字节已经写入，它们所在的扇区不再擦除
+ * @param[in] size 已写入的字节数
+ */
+void boot_ext_flash_resume(uint32_t size);
+
+/**
+ * @brief   计算外部 Flash 槽位中一段数据的 CRC32/MPEG-2
+ * @param[in] slot_idx 槽位索引
+ * @param[in] offset   槽位内的起始偏移
+ * @param[in] len      字节数
+ * @param[in] crc      CRC 初值（续算时传入上一段的结果）
+ * @return  CRC32 值
+ */
+uint32_t boot_ext_flash_calc_crc(uint8_t slot_idx, uint32_t offset, uint32_t len, uint32_t crc);
+
+/**
+ * @brief   按硬件 CRC 单元的字顺序计算外部 Flash 槽位中整个固件的 CRC32，用于 boot_flash_verify
+ * @param[in] slot_idx 槽位索引
+ * @param[in] size     固件字节数
+ * @return  CRC32 值
+ */
+uint32_t boot_ext_flash_calc_image_crc(uint8_t slot_idx, uint32_t size);
 
 /**
  * @brief   请求下载程序到外部 Flash
@@ -36,6 +84,12 @@ void boot_ext_flash_load(void);
  */
 uint8_t boot_ext_flash_get_cur_slot_idx(void);
 
+/**
+ * @brief   设置当前外部 Flash 程序索引
+ * @param[in] slot_idx 外部 Flash 程序索引
+ */
+void boot_ext_flash_set_cur_slot_idx(uint8_t slot_idx);
+
 /**
  * @brief   外部 Flash OTA 初始化
  */
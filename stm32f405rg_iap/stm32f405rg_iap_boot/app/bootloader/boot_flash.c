@@ -1,45 +1,151 @@
+#include <errno.h>
+#include <string.h>
+#include <stdbool.h>
 #include "bsp_flash.h"
+#include "bsp_crc.h"
 #include "boot_config.h"
 #include "boot_core.h"
 #include "boot_flash.h"
 #include "log.h"
 
+#if BOOT_PLATFORM_STM32F1 || BOOT_PLATFORM_GD32F1
+#define BOOT_FLASH_UNIT_COUNT   BOOT_FLASH_PAGE_COUNT_MAX   // 擦除单位为页
+#define BOOT_FLASH_UNIT_NAME    "pages"
+#define BOOT_FLASH_PAGE_ERASE_MS    20                      // 页擦除典型时间（数据手册 tERASE 20~40ms）
+#elif BOOT_PLATFORM_STM32F4
+#define BOOT_FLASH_UNIT_COUNT   BOOT_FLASH_SECOTR_COUNT     // 擦除单位为扇区
+#define BOOT_FLASH_UNIT_NAME    "sectors"
+#endif
+
+/* 数据块和 B 区都要按页对齐，页大小运行时确定 */
+#if (BOOT_PLATFORM_STM32F1 || BOOT_PLATFORM_GD32F1) && (BOOT_APP_UPDATE_CHUNK_SIZE % BOOT_FLASH_PAGE_SIZE_MIN != 0)
+#error boot_flash.c: BOOT_APP_UPDATE_CHUNK_SIZE must be a multiple of BOOT_FLASH_PAGE_SIZE_MIN!
+#endif
+
+/* 按需擦除：记录本次下载中每个页/扇区是否已可直接写入（已擦除，或内容相同被保留） */
+typedef struct {
+    uint32_t unit_ready[(BOOT_FLASH_UNIT_COUNT + 31) / 32];    // 每个页/扇区占 1 位
+    uint32_t skipped;       // 与 Flash 现有内容相同、跳过写入的数据块数
+} boot_flash_ctx_t;
+
+static boot_flash_ctx_t boot_flash_ctx;
+
+/* 运行时 Flash 几何信息，boot_flash_geometry_init 之前为编译时的缺省器件 */
+typedef struct {
+    uint32_t flash_size;    // Flash 总字节数（不超过 BOOT_FLASH_SIZE_MAX）
+    uint32_t page_size;     // 页字节数，F4 按扇区表擦除，为 0
+    uint16_t unit_count;    // 页/扇区总数
+    uint32_t app_size;      // A 区字节数
+} boot_flash_geo_t;
+
+#if BOOT_PLATFORM_STM32F1 || BOOT_PLATFORM_GD32F1
+static boot_flash_geo_t boot_flash_geo = {
+    BOOT_FLASH_SIZE_DEFAULT, BOOT_FLASH_PAGE_SIZE_MIN,
+    BOOT_FLASH_SIZE_DEFAULT / BOOT_FLASH_PAGE_SIZE_MIN, BOOT_FLASH_SIZE_DEFAULT - BOOT_FLASH_BOOT_SIZE,
+};
+#elif BOOT_PLATFORM_STM32F4
+static boot_flash_geo_t boot_flash_geo = {
+    BOOT_FLASH_SIZE_DEFAULT, 0, BOOT_FLASH_SECOTR_COUNT, BOOT_FLASH_APP_MAX_SIZE,
+};
+#endif
+
+#if BOOT_PLATFORM_STM32F4
+/* 扇区几何信息 */
+typedef struct {
+    uint32_t addr;          // 扇区起始地址
+    uint32_t size;          // 扇区字节数
+    uint16_t erase_ms;      // 扇区擦除典型时间（数据手册 x32 并行度，最大值约为 2 倍）
+} boot_flash_sector_t;
+
+/* 扇区几何表，扇区 0~3 为 16KB，扇区 4 为 64KB，扇区 5~11 为 128KB */
+static const boot_flash_sector_t boot_flash_sector_tbl[BOOT_FLASH_SECOTR_COUNT] = {
+    { 0x08000000,  16 * 1024,  250 }, { 0x08004000,  16 * 1024,  250 },
+    { 0x08008000,  16 * 1024,  250 }, { 0x0800C000,  16 * 1024,  250 },
+    { 0x08010000,  64 * 1024,  550 }, { 0x08020000, 128 * 1024, 1000 },
+    { 0x08040000, 128 * 1024, 1000 }, { 0x08060000, 128 * 1024, 1000 },
+    { 0x08080000, 128 * 1024, 1000 }, { 0x080A0000, 128 * 1024, 1000 },
+    { 0x080C0000, 128 * 1024, 1000 }, { 0x080E0000, 128 * 1024, 1000 },
+};
+#endif
+
+static void boot_flash_get_unit(uint32_t addr, uint16_t *unit, uint32_t *start, uint32_t *size);
+static void boot_flash_set_ready(uint16_t unit);
+static bool boot_flash_is_ready(uint16_t unit);
+static bool boot_flash_is_blank(uint32_t addr, uint32_t len);
+static int boot_flash_prepare(bsp_flash_t *flash, uint32_t addr, uint32_t len);
+
 /**
- * @brief   擦除 Flash APP 程序
+ * @brief   读取 Flash 容量和页大小，建立运行时几何信息
+ * @details 同一个 BootLoader 可用于不同容量的器件（F103C8/CB/RC/ZE），页大小、页数和 A 区大小都按实际器件计算，
+ *          A 区起始地址固定为 BOOT_FLASH_APP_START_ADDR。超过 BOOT_FLASH_SIZE_MAX 的部分不使用。
+ *          读取失败或信息不合理时保留编译时的缺省器件。
  * @return	0 表示成功，其他值表示失败
  */
-int boot_flash_erase_app(void)
+int boot_flash_geometry_init(void)
 {
     bsp_flash_t *flash = bsp_flash_get();
+    bsp_flash_info_t info;
+    uint32_t size;
 
-    log_info("Erase APP.");
+    if (flash->ops->get_info(flash, &info) != 0)
+        return -EIO;
+
+    size = info.size;
+    if (size > BOOT_FLASH_SIZE_MAX)
+        size = BOOT_FLASH_SIZE_MAX;
+    if (size <= BOOT_FLASH_APP_START_ADDR - BOOT_FLASH_BASE_ADDR)
+        return -EINVAL;
 
-    /* 擦除 APP 区 */
 #if BOOT_PLATFORM_STM32F1 || BOOT_PLATFORM_GD32F1
-    if (flash->ops->erase(flash, BOOT_FLASH_APP_PAGE_COUNT, BOOT_FLASH_APP_START_PAGE) != 0) {
+    if (info.page_size < BOOT_FLASH_PAGE_SIZE_MIN || BOOT_FLASH_BOOT_SIZE % info.page_size != 0)
+        return -EINVAL;
+
+    boot_flash_geo.page_size  = info.page_size;
+    boot_flash_geo.unit_count = size / info.page_size;
 #elif BOOT_PLATFORM_STM32F4
-    if (flash->ops->erase(flash, BOOT_FLASH_APP_SECOTR_COUNT, BOOT_FLASH_APP_START_SECOTR) != 0) {
+    boot_flash_geo.page_size  = 0;
+    boot_flash_geo.unit_count = 0;
+    while (boot_flash_geo.unit_count < BOOT_FLASH_SECOTR_COUNT &&
+           boot_flash_sector_tbl[boot_flash_geo.unit_count].addr < BOOT_FLASH_BASE_ADDR + size)
+        boot_flash_geo.unit_count++;
 #endif
-        log_error("Flash erase operation failed!");
+    boot_flash_geo.flash_size = size;
+    boot_flash_geo.app_size   = size - (BOOT_FLASH_APP_START_ADDR - BOOT_FLASH_BASE_ADDR);
+
+    log_info("Flash: dev 0x%03X, %d KB, %d %s, APP 0x%X (%d KB)",
+             info.dev_id, size / 1024, boot_flash_geo.unit_count, BOOT_FLASH_UNIT_NAME,
+             BOOT_FLASH_APP_START_ADDR, boot_flash_geo.app_size / 1024);
+    return 0;
+}
+
+/**
+ * @brief   获取 A 区字节数（按实际器件容量）
+ * @return  A 区字节数
+ */
+uint32_t boot_flash_get_app_size(void)
+{
+    return boot_flash_geo.app_size;
+}
+
+/**
+ * @brief   擦除 Flash APP 程序
+ * @details 按页/扇区检查，已经是空白的页/扇区不再擦除。F4 APP 区有 10 个扇区共 992KB，全部擦除约 9s，
+ *          APP 只占前几个扇区时只擦除这几个扇区。
+ * @return	0 表示成功，其他值表示失败
+ */
+int boot_flash_erase_app(void)
+{
+    bsp_flash_t *flash = bsp_flash_get();
+
+    log_info("Erase APP.");
+
+    boot_flash_erase_begin();
+    if (boot_flash_erase_plan(flash, boot_flash_geo.app_size) != 0 ||
+        boot_flash_prepare(flash, BOOT_FLASH_APP_START_ADDR, boot_flash_geo.app_size) != 0) {
+        log_error("Failed to erase APP!");
         return -1;
     }
 
-#if BOOT_PLATFORM_STM32F1 || BOOT_PLATFORM_GD32F1
-    /* 验证擦除是否成功 */
-    int32_t i;
-    uint32_t error_cnt = 0;
-    volatile uint32_t *p;
-    p = (volatile uint32_t *)BOOT_FLASH_APP_START_ADDR;
-    for (i = 0; i < BOOT_FLASH_APP_PAGE_COUNT * BOOT_FLASH_PAGE_SIZE / 4; i++) {
-        if (p[i] != 0xFFFFFFFF)
-            error_cnt++;
-    }
-    if (error_cnt != 0) {
-        log_error("Failed to erase APP (err=%d)!", error_cnt);
-        return -2;
-    }
-#endif
-    
     log_info("APP erased successfully!\r\n");
     return 0;
 }
@@ -53,9 +159,298 @@ int boot_flash_erase_app(void)
 int boot_flash_write_chunk(bsp_flash_t *flash, uint32_t chunk_idx)
 {
     uint32_t addr = BOOT_FLASH_APP_START_ADDR + chunk_idx * BOOT_APP_UPDATE_CHUNK_SIZE;
-    uint8_t *update_chunk = boot_get_update_chunk();
+    uint8_t *update_chunk = boot_get_update_chunk(chunk_idx);
+
+    return boot_flash_program(flash, addr, BOOT_APP_UPDATE_CHUNK_SIZE, update_chunk);
+}
+
+/**
+ * @brief   开始按需擦除 APP 区，之后由 boot_flash_program 在写入前擦除数据所在的页/扇区
+ * @details 下载开始时不再整片擦除 APP 区，擦除时间分摊到传输过程中，且只与固件大小有关。
+ *          APP 区中超出本次固件的部分保留原内容。
+ */
+void boot_flash_erase_begin(void)
+{
+    memset(boot_flash_ctx.unit_ready, 0, sizeof(boot_flash_ctx.unit_ready));
+    boot_flash_ctx.skipped = 0;
+}
+
+/**
+ * @brief   从断点继续下载：APP 区前 size 字节已经写入，覆盖它们的页/扇区不再擦除
+ * @details 断点所在的页/扇区在中断前的下载中已经擦除，其余部分只写过本固件的数据，可以直接继续写入。
+ *          在 boot_flash_erase_begin 之后调用。
+ * @param[in] size 已写入的字节数
+ */
+void boot_flash_resume(uint32_t size)
+{
+    uint32_t addr = BOOT_FLASH_APP_START_ADDR;
+    uint32_t end = BOOT_FLASH_APP_START_ADDR + size;
+    uint32_t start;
+    uint32_t unit_size;
+    uint16_t unit;
 
-    return flash->ops->write(flash, addr,
-                             BOOT_APP_UPDATE_CHUNK_SIZE,
-                             (uint32_t *)update_chunk);
+    while (addr < end) {
+        boot_flash_get_unit(addr, &unit, &start, &unit_size);
+        boot_flash_set_ready(unit);
+        addr = start + unit_size;
+    }
+}
+
+/**
+ * @brief   获取页/扇区的典型擦除时间
+ * @param[in] unit 页/扇区编号
+ * @return  擦除时间（毫秒）
+ */
+static uint32_t boot_flash_get_erase_ms(uint16_t unit)
+{
+#if BOOT_PLATFORM_STM32F1 || BOOT_PLATFORM_GD32F1
+    (void)unit;
+    return BOOT_FLASH_PAGE_ERASE_MS;
+#elif BOOT_PLATFORM_STM32F4
+    return boot_flash_sector_tbl[unit].erase_ms;
+#endif
+}
+
+/**
+ * @brief   按固件大小规划擦除，只处理覆盖 APP 区前 size 字节的页/扇区
+ * @details 在 boot_flash_erase_begin 之后、写入数据之前调用，日志中给出计划擦除的页/扇区范围、
+ *          其中需要擦除（非空白）的数量和预计擦除时间。
+ *          F4 扇区最大 128KB，擦除一个扇区约 1s，放在传输中途会让某一包的应答超过发送端超时，
+ *          因此在应答首包之前一次擦完；F1/GD32 页擦除只有约 20ms，仍由 boot_flash_program 在写入时按需擦除，
+ *          与新固件内容相同的页不擦除，预计时间为上限。从断点继续时在 boot_flash_resume 之后调用，
+ *          已写入的页/扇区已标记为可直接写入，只擦除断点之后的部分。
+ * @param[in] flash 指向内部 Flash BSP 对象的指针
+ * @param[in] size  固件字节数（来自文件头或外部 Flash 槽位记录的 app_size）
+ * @return	0 表示成功，其他值表示失败
+ */
+int boot_flash_erase_plan(bsp_flash_t *flash, uint32_t size)
+{
+    uint32_t addr = BOOT_FLASH_APP_START_ADDR;
+    uint32_t end = BOOT_FLASH_APP_START_ADDR + size;
+    uint32_t start;
+    uint32_t unit_size;
+    uint32_t plan_bytes = 0;
+    uint32_t erase_ms = 0;
+    uint16_t erase_cnt = 0;
+    uint16_t first;
+    uint16_t unit;
+
+    if (size == 0 || size > boot_flash_geo.app_size)
+        return -EINVAL;
+
+    boot_flash_get_unit(addr, &first, &start, &unit_size);
+    unit = first;
+    while (addr < end) {
+        boot_flash_get_unit(addr, &unit, &start, &unit_size);
+        if (!boot_flash_is_ready(unit) && !boot_flash_is_blank(start, unit_size)) {
+            erase_cnt++;
+            erase_ms += boot_flash_get_erase_ms(unit);
+        }
+        plan_bytes += unit_size;
+        addr = start + unit_size;
+    }
+
+    log_info("Erase plan: %d bytes -> %s %d~%d (%d KB), %d to erase, about %d ms",
+             size, BOOT_FLASH_UNIT_NAME, first, unit, plan_bytes / 1024, erase_cnt, erase_ms);
+
+#if BOOT_PLATFORM_STM32F4
+    return boot_flash_prepare(flash, BOOT_FLASH_APP_START_ADDR, size);
+#else
+    (void)flash;
+    return 0;
+#endif
+}
+
+/**
+ * @brief   获取地址所在的页/扇区
+ * @param[in]  addr  Flash 地址
+ * @param[out] unit  页/扇区编号
+ * @param[out] start 页/扇区起始地址
+ * @param[out] size  页/扇区字节数
+ */
+static void boot_flash_get_unit(uint32_t addr, uint16_t *unit, uint32_t *start, uint32_t *size)
+{
+#if BOOT_PLATFORM_STM32F1 || BOOT_PLATFORM_GD32F1
+    *unit  = (addr - BOOT_FLASH_BASE_ADDR) / boot_flash_geo.page_size;
+    *start = BOOT_FLASH_BASE_ADDR + *unit * boot_flash_geo.page_size;
+    *size  = boot_flash_geo.page_size;
+#elif BOOT_PLATFORM_STM32F4
+    uint16_t i;
+
+    for (i = 0; i < boot_flash_geo.unit_count - 1; i++) {
+        if (addr < boot_flash_sector_tbl[i].addr + boot_flash_sector_tbl[i].size)
+            break;
+    }
+    *unit  = i;
+    *start = boot_flash_sector_tbl[i].addr;
+    *size  = boot_flash_sector_tbl[i].size;
+#endif
+}
+
+/**
+ * @brief   获取地址所在的页/扇区编号
+ * @details 编号相同的地址位于同一页/扇区，写入其中任一数据块时整个页/扇区一起擦除
+ * @param[in] addr Flash 地址
+ * @return  页/扇区编号
+ */
+uint16_t boot_flash_get_unit_index(uint32_t addr)
+{
+    uint32_t start;
+    uint32_t size;
+    uint16_t unit;
+
+    boot_flash_get_unit(addr, &unit, &start, &size);
+    return unit;
+}
+
+/**
+ * @brief   标记页/扇区在本次下载中已可直接写入
+ * @param[in] unit 页/扇区编号
+ */
+static void boot_flash_set_ready(uint16_t unit)
+{
+    boot_flash_ctx.unit_ready[unit / 32] |= 1UL << (unit % 32);
+}
+
+/**
+ * @brief   检查页/扇区在本次下载中是否已可直接写入
+ * @param[in] unit 页/扇区编号
+ * @return  true 表示已擦除或内容已保留
+ */
+static bool boot_flash_is_ready(uint16_t unit)
+{
+    return (boot_flash_ctx.unit_ready[unit / 32] & (1UL << (unit % 32))) != 0;
+}
+
+/**
+ * @brief   检查 Flash 区域是否全部为擦除值 0xFF
+ * @param[in] addr 起始地址（4 字节对齐）
+ * @param[in] len  字节数（4 的倍数）
+ * @return  true 表示全部为 0xFF
+ */
+static bool boot_flash_is_blank(uint32_t addr, uint32_t len)
+{
+    volatile uint32_t *p = (volatile uint32_t *)addr;
+    uint32_t i;
+
+    for (i = 0; i < len / 4; i++) {
+        if (p[i] != 0xFFFFFFFF)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief   确保 [addr, addr + len) 所在的页/扇区已擦除
+ * @details 本次下载中尚未处理过的页/扇区才擦除，已经是空白的页/扇区跳过擦除。
+ *          擦除后不再逐字回读检查空白，擦除是否成功由驱动检查状态标志，写入内容由 boot_flash_verify 统一校验。
+ * @param[in] flash 指向内部 Flash BSP 对象的指针
+ * @param[in] addr  写入起始地址
+ * @param[in] len   写入字节数
+ * @return	0 表示成功，其他值表示失败
+ */
+static int boot_flash_prepare(bsp_flash_t *flash, uint32_t addr, uint32_t len)
+{
+    uint32_t end = addr + len;
+    uint32_t start;
+    uint32_t size;
+    uint16_t unit;
+
+    while (addr < end) {
+        boot_flash_get_unit(addr, &unit, &start, &size);
+
+        if (!boot_flash_is_ready(unit) && !boot_flash_is_blank(start, size)) {
+            if (flash->ops->erase(flash, 1, unit) != 0) {
+                log_error("Flash erase operation failed at 0x%X!", start);
+                return -EIO;
+            }
+        }
+
+        boot_flash_set_ready(unit);
+        addr = start + size;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   将数据写入 APP 区，写入前按需擦除，内容与 Flash 现有数据相同时跳过
+ * @details F1 中小容量一个数据块就是一页，整页相同时既不擦除也不写入，重复下载相近的固件时只改写变化的页；
+ *          F4 扇区和 F1 大容量 2KB 页在第一次写入前整体擦除，擦除后只能跳过与擦除值相同的数据块。
+ * @param[in] flash 指向内部 Flash BSP 对象的指针
+ * @param[in] addr  写入起始地址（4 字节对齐）
+ * @param[in] len   写入字节数（4 的倍数）
+ * @param[in] data  要写入的数据
+ * @return	0 表示成功，其他值表示失败
+ */
+int boot_flash_program(bsp_flash_t *flash, uint32_t addr, uint32_t len, const uint8_t *data)
+{
+    int ret;
+
+    if (addr < BOOT_FLASH_APP_START_ADDR || addr + len > BOOT_FLASH_APP_START_ADDR + boot_flash_geo.app_size)
+        return -EINVAL;
+
+#if BOOT_PLATFORM_STM32F1 || BOOT_PLATFORM_GD32F1
+    /* 一个数据块恰好是一页时整页跳过；2KB 页的器件一页跨两个数据块，按 F4 的方式先擦除再跳过相同的块 */
+    if (boot_flash_geo.page_size == BOOT_APP_UPDATE_CHUNK_SIZE && memcmp((const void *)addr, data, len) == 0) {
+        uint32_t start;
+        uint32_t size;
+        uint16_t unit;
+
+        boot_flash_get_unit(addr, &unit, &start, &size);
+        boot_flash_set_ready(unit);     // 保留该页现有内容，后续不再擦除
+        boot_flash_ctx.skipped++;
+        return 0;
+    }
+#endif
+
+    ret = boot_flash_prepare(flash, addr, len);
+    if (ret)
+        return ret;
+
+    if (memcmp((const void *)addr, data, len) == 0)
+        boot_flash_ctx.skipped++;
+    else
+        ret = flash->ops->write(flash, addr, len, (uint32_t *)data);
+
+    return ret;
+}
+
+/**
+ * @brief   获取本次下载中与 Flash 内容相同、跳过写入的数据块数
+ * @return  跳过的数据块数
+ */
+uint32_t boot_flash_get_skipped(void)
+{
+    return boot_flash_ctx.skipped;
+}
+
+/**
+ * @brief   用硬件 CRC 校验 APP 区中的整个固件
+ * @details 对 Flash 中固件覆盖的范围算一遍 CRC，与数据来源给出的整个固件的 CRC 比较：
+ *          顺序接收时为收到的数据在拷贝进 update_chunk 之前累计的 CRC，流式传输为上位机在 START/DELTA 中给出的 CRC，
+ *          从外部 Flash 加载时为槽位中固件的 CRC。参考值与 update_chunk 中转的副本无关，
+ *          中转时被覆盖、写失败、漏写的块（包括增量更新中被擦除却没有重写的块）都会使 CRC 不一致。
+ *          替代擦除后逐字回读检查空白，CPU 只负责把字送入 CRC 单元（或由 DMA 送入），不再逐字比较。
+ * @param[in] size 固件字节数
+ * @param[in] crc  整个固件的 CRC32，按 boot_crc32_word 的方式计算（尾部补 0xFF 到 4 字节）
+ * @return	0 表示成功，-EIO 表示 Flash 内容与固件不一致
+ */
+int boot_flash_verify(uint32_t size, uint32_t crc)
+{
+    bsp_crc_t *bsp_crc = bsp_crc_get();
+    uint32_t len = (size + 3) & ~3UL;   // 内部 Flash 按字写入，尾部补齐到 4 字节
+    uint32_t calc;
+
+    if (size == 0 || size > boot_flash_geo.app_size)
+        return -EINVAL;
+
+    calc = bsp_crc->ops->calc(bsp_crc, (const uint32_t *)BOOT_FLASH_APP_START_ADDR, len);
+    if (calc != crc) {
+        log_error("Flash verify failed: CRC 0x%08X, expected 0x%08X (%d bytes)!", calc, crc, size);
+        return -EIO;
+    }
+
+    log_info("Flash verify: %d bytes CRC 0x%08X OK", size, calc);
+    return 0;
 }
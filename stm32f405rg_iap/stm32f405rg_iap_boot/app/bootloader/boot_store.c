@@ -1,10 +1,12 @@
 #include <string.h>
 #include "bsp_delay.h"
 #include "bsp_eeprom.h"
+#include "boot_crc.h"
 #include "boot_store.h"
 #include "log.h"
 
 #define BOOT_APP_INFO_ADDR     0x0000
+#define BOOT_RESUME_INFO_ADDR  0x0040   // 紧跟在 boot_app_info_t（64 字节）之后
 
 /**
  * @brief   读取 APP 信息
@@ -65,3 +67,88 @@ int boot_app_info_save(boot_app_info_t *boot_app_info)
     log_info("  Pages     : %d", sizeof(boot_app_info_t) / EEPROM_PAGE_SIZE);
     return 0;
 }
+
+/**
+ * @brief   按页写入 EEPROM
+ * @param[in] addr EEPROM 地址（页对齐）
+ * @param[in] data 数据首地址
+ * @param[in] len  字节数（页大小的整数倍）
+ * @return	0 表示成功，其他值表示失败
+ */
+static int boot_store_write_pages(uint8_t addr, uint8_t *data, uint16_t len)
+{
+    int ret;
+    uint16_t i;
+    bsp_eeprom_t *eeprom = bsp_eeprom_get();
+
+    for (i = 0; i < len; i += EEPROM_PAGE_SIZE) {
+        ret = eeprom->ops->write_page(eeprom, addr + i, data + i);
+        if (ret) {
+            log_error("Failed to write eeprom page: %d", ret);
+            return ret;
+        }
+
+        bsp_delay_ms(5);
+    }
+    return 0;
+}
+
+/**
+ * @brief   读取下载断点记录
+ * @param[out] info boot_resume_info_t 结构体指针
+ * @return	0 表示成功，-ENOENT 表示没有有效记录，其他值表示失败
+ */
+int boot_resume_info_load(boot_resume_info_t *info)
+{
+    int ret;
+    bsp_eeprom_t *eeprom = bsp_eeprom_get();
+
+    ret = eeprom->ops->read_data(eeprom,
+                                 BOOT_RESUME_INFO_ADDR,
+                                 sizeof(boot_resume_info_t),
+                                 (uint8_t *)info);
+    if (ret) {
+        log_error("Failed to read eeprom data: %d", ret);
+        return ret;
+    }
+
+    if (info->magic != BOOT_RESUME_MAGIC ||
+        info->check != boot_crc32(0xFFFFFFFF, (uint8_t *)info, sizeof(boot_resume_info_t) - 4))
+        return -ENOENT;
+    return 0;
+}
+
+/**
+ * @brief   保存下载断点记录，自动填写 magic 和 check
+ * @details 下载过程中周期性调用，不输出日志
+ * @param[in] info boot_resume_info_t 结构体指针
+ * @return	0 表示成功，其他值表示失败
+ */
+int boot_resume_info_save(boot_resume_info_t *info)
+{
+    if (sizeof(boot_resume_info_t) % EEPROM_PAGE_SIZE != 0) {
+        log_error("Invalid resume info size (must be %d-byte aligned): %d",
+                  EEPROM_PAGE_SIZE, sizeof(boot_resume_info_t));
+        return -1;
+    }
+
+    info->magic = BOOT_RESUME_MAGIC;
+    info->check = boot_crc32(0xFFFFFFFF, (uint8_t *)info, sizeof(boot_resume_info_t) - 4);
+    return boot_store_write_pages(BOOT_RESUME_INFO_ADDR, (uint8_t *)info, sizeof(boot_resume_info_t));
+}
+
+/**
+ * @brief   清除下载断点记录，没有有效记录时不写 EEPROM
+ * @details 只改写 magic 所在的第一页
+ * @return	0 表示成功，其他值表示失败
+ */
+int boot_resume_info_clear(void)
+{
+    boot_resume_info_t info;
+
+    if (boot_resume_info_load(&info) != 0)
+        return 0;
+
+    info.magic = 0;
+    return boot_store_write_pages(BOOT_RESUME_INFO_ADDR, (uint8_t *)&info, EEPROM_PAGE_SIZE);
+}
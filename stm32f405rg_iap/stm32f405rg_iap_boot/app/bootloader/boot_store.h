@@ -4,6 +4,12 @@
 #include <stdint.h>
 #include "boot_config.h"
 
+#ifndef ENOENT
+#define ENOENT      2
+#endif
+
+#define BOOT_RESUME_MAGIC   (0x52534D31)    // "RSM1"，断点记录有效标志
+
 /* 此结构体大小要为 EEPROM 页大小的整数倍 */
 typedef struct {
     uint32_t app_size[BOOT_EXT_FLASH_APP_SLOT_COUNT];   // 外部 Flash 中存储的应用程序字节数，0 号位预留给 OTA
@@ -11,6 +17,18 @@ typedef struct {
     uint32_t ota_flag;
 } boot_app_info_t;
 
+/* 下载断点记录，此结构体大小要为 EEPROM 页大小的整数倍 */
+typedef struct {
+    uint32_t magic;         // BOOT_RESUME_MAGIC 表示记录有效
+    uint8_t  target;        // 写入目标（boot_update_target_t）
+    uint8_t  slot_idx;      // 外部 Flash 槽位，写入内部 Flash 时为 0
+    uint16_t reserved;
+    uint32_t file_size;     // 固件总字节数
+    uint32_t chunk_cnt;     // 从头开始连续写入 Flash 的数据块数
+    uint32_t data_crc;      // Flash 中前 chunk_cnt 个数据块的 CRC32/MPEG-2
+    uint32_t check;         // 以上字段的 CRC32，防止读到写了一半的记录
+} boot_resume_info_t;
+
 /**
  * @brief   读取 IAP 信息
  * @param[out] boot_app_info boot_app_info_t 结构体指针
@@ -25,4 +43,24 @@ int boot_app_info_load(boot_app_info_t *boot_app_info);
  */
 int boot_app_info_save(boot_app_info_t *boot_app_info);
 
+/**
+ * @brief   读取下载断点记录
+ * @param[out] info boot_resume_info_t 结构体指针
+ * @return	0 表示成功，-ENOENT 表示没有有效记录，其他值表示失败
+ */
+int boot_resume_info_load(boot_resume_info_t *info);
+
+/**
+ * @brief   保存下载断点记录，自动填写 magic 和 check
+ * @param[in] info boot_resume_info_t 结构体指针
+ * @return	0 表示成功，其他值表示失败
+ */
+int boot_resume_info_save(boot_resume_info_t *info);
+
+/**
+ * @brief   清除下载断点记录，没有有效记录时不写 EEPROM
+ * @return	0 表示成功，其他值表示失败
+ */
+int boot_resume_info_clear(void);
+
 #endif
@@ -0,0 +1,721 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include "boot_config.h"
+#include "boot_core.h"
+#include "boot_cmd.h"
+#include "boot_comm.h"
+#include "boot_crc.h"
+#include "boot_store.h"
+#include "boot_ext_flash.h"
+#include "boot_flash.h"
+#include "boot_update.h"
+#include "boot_baud.h"
+#include "boot_stream.h"
+#include "log.h"
+
+/* 流式传输协议 */
+#define STREAM_SYNC0            0xA5
+#define STREAM_SYNC1            0x5A
+#define STREAM_HEADER_LEN       7       // sync(2) + type(1) + seq(2) + len(2)
+#define STREAM_CRC_LEN          4
+#define STREAM_MAX_PAYLOAD      BOOT_APP_UPDATE_CHUNK_SIZE  // 一个 DATA 帧恰好对应一个 update_chunk
+#define STREAM_WRITE_HDR_LEN    4       // WRITE 帧数据前的块 CRC32
+#define STREAM_PCRC_MAX_BLOCKS  32      // 一个 PCRC_ACK 最多携带的块数
+#define STREAM_PCRC_ENTRY_LEN   6       // 每块：crc32(4) + 擦除单元编号(2)
+#define STREAM_REPLY_MAX_LEN    (4 + STREAM_PCRC_MAX_BLOCKS * STREAM_PCRC_ENTRY_LEN)   // 应答帧最大有效数据长度
+#define STREAM_START_LEN        8       // START / DELTA / RESUME：固件总字节数(4) + 整个固件的 CRC32(4)
+#define STREAM_FRAME_MAX_LEN    (STREAM_HEADER_LEN + STREAM_WRITE_HDR_LEN + STREAM_MAX_PAYLOAD + STREAM_CRC_LEN)
+
+#define STREAM_TYPE_START       0x01
+#define STREAM_TYPE_DATA        0x02
+#define STREAM_TYPE_END         0x03
+#define STREAM_TYPE_ABORT       0x04
+#define STREAM_TYPE_PCRC        0x05
+#define STREAM_TYPE_DELTA       0x06
+#define STREAM_TYPE_WRITE       0x07
+#define STREAM_TYPE_RESUME      0x08
+#define STREAM_TYPE_ACK         0x80
+#define STREAM_TYPE_START_ACK   0x81
+#define STREAM_TYPE_END_ACK     0x82
+#define STREAM_TYPE_PCRC_ACK    0x83
+#define STREAM_TYPE_WRITE_ACK   0x84
+#define STREAM_TYPE_RESUME_ACK  0x85
+
+#if (BOOT_STREAM_WINDOW < 1) || (BOOT_STREAM_WINDOW > 32)
+#error boot_stream.c: BOOT_STREAM_WINDOW must be in range 1-32!
+#endif
+
+/* 跨串口数据段的帧拼接 */
+typedef struct {
+    uint8_t  buf[STREAM_FRAME_MAX_LEN];
+    uint16_t len;                   // 已拼接的字节数，0 表示没有未完成的帧
+    uint16_t expect_len;            // 整帧字节数，收齐帧头前为 0
+} boot_stream_framer_t;
+
+/* 处理一段串口数据的结果 */
+typedef struct {
+    bool     need_ack;              // 收到 DATA 帧或损坏的帧，处理完本段后回复 ACK
+    bool     end_req;               // 收到 END 帧
+    bool     aborted;               // 收到 ABORT 帧，会话已结束
+} boot_stream_rx_t;
+
+typedef struct {
+    boot_update_target_t target;    // 写入目标
+    bool     started;               // 是否已收到 START 或 DELTA
+    bool     delta;                 // 增量会话：只写入 WRITE 帧指定的块
+    uint32_t file_size;             // 固件总字节数
+    uint32_t frame_cnt;             // 固件总块数
+    uint32_t first_seq;             // 本次会话的起始块，从断点继续时不为 0
+    uint32_t next_seq;              // 期望的下一个块序号，之前的块都已收到
+    uint32_t sack;                  // bit i 表示块 next_seq + i 已收到
+    int      status;                // 写 Flash 的错误码
+} boot_stream_ctx_t;
+
+static boot_stream_ctx_t boot_stream_ctx;
+static boot_stream_framer_t boot_stream_framer;
+
+/**
+ * @brief   读取小端 16 位数
+ */
+static inline uint16_t boot_stream_get_le16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+/**
+ * @brief   读取小端 32 位数
+ */
+static inline uint32_t boot_stream_get_le32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief   写入小端 32 位数
+ */
+static inline void boot_stream_put_le32(uint8_t *p, uint32_t val)
+{
+    p[0] = val;
+    p[1] = val >> 8;
+    p[2] = val >> 16;
+    p[3] = val >> 24;
+}
+
+/**
+ * @brief   发送一帧
+ * @param[in] type    帧类型
+ * @param[in] seq     序号
+ * @param[in] payload 有效数据
+ * @param[in] len     有效数据长度（不超过 STREAM_REPLY_MAX_LEN）
+ * @note    帧缓冲区为静态变量，不占用栈。串口发送是阻塞的，返回前缓冲区已发送完毕
+ */
+static void boot_stream_send_frame(uint8_t type, uint16_t seq, const uint8_t *payload, uint16_t len)
+{
+    static uint8_t frame[STREAM_HEADER_LEN + STREAM_REPLY_MAX_LEN + STREAM_CRC_LEN];
+    uint32_t crc;
+    uint16_t i;
+
+    frame[0] = STREAM_SYNC0;
+    frame[1] = STREAM_SYNC1;
+    frame[2] = type;
+    frame[3] = seq;
+    frame[4] = seq >> 8;
+    frame[5] = len;
+    frame[6] = len >> 8;
+    for (i = 0; i < len; i++)
+        frame[STREAM_HEADER_LEN + i] = payload[i];
+
+    crc = boot_crc32(0xFFFFFFFF, &frame[2], STREAM_HEADER_LEN - 2 + len);
+    boot_stream_put_le32(&frame[STREAM_HEADER_LEN + len], crc);
+
+    boot_send_data(frame, STREAM_HEADER_LEN + len + STREAM_CRC_LEN);
+}
+
+/**
+ * @brief   发送累计确认 + SACK 位图
+ */
+static void boot_stream_send_ack(void)
+{
+    uint8_t payload[8];
+
+    boot_stream_put_le32(&payload[0], boot_stream_ctx.sack);
+    boot_stream_put_le32(&payload[4], (uint32_t)boot_stream_ctx.status);
+    boot_stream_send_frame(STREAM_TYPE_ACK, boot_stream_ctx.next_seq, payload, sizeof(payload));
+}
+
+/**
+ * @brief   填写 START_ACK / RESUME_ACK 共有的窗口参数和状态
+ * @param[out] payload 至少 8 字节
+ * @param[in]  status  0 表示可以开始传输，其他值表示拒绝
+ */
+static void boot_stream_fill_start_ack(uint8_t *payload, int status)
+{
+    payload[0] = BOOT_STREAM_WINDOW;
+    payload[1] = 0;
+    payload[2] = STREAM_MAX_PAYLOAD & 0xFF;
+    payload[3] = STREAM_MAX_PAYLOAD >> 8;
+    boot_stream_put_le32(&payload[4], (uint32_t)status);
+}
+
+/**
+ * @brief   发送 START_ACK
+ * @param[in] status 0 表示可以开始传输，其他值表示拒绝
+ */
+static void boot_stream_send_start_ack(int status)
+{
+    uint8_t payload[8];
+
+    boot_stream_fill_start_ack(payload, status);
+    boot_stream_send_frame(STREAM_TYPE_START_ACK, 0, payload, sizeof(payload));
+}
+
+/**
+ * @brief   发送 RESUME_ACK
+ * @param[in] status    0 表示从断点继续，其他值表示没有可用的断点
+ * @param[in] chunk_cnt 已写入的块数，上位机从这一块开始发送
+ * @param[in] crc       已写入块的 CRC32，上位机用来确认与它的固件一致
+ */
+static void boot_stream_send_resume_ack(int status, uint32_t chunk_cnt, uint32_t crc)
+{
+    uint8_t payload[16];
+
+    boot_stream_fill_start_ack(payload, status);
+    boot_stream_put_le32(&payload[8], chunk_cnt);
+    boot_stream_put_le32(&payload[12], crc);
+    boot_stream_send_frame(STREAM_TYPE_RESUME_ACK, chunk_cnt, payload, sizeof(payload));
+}
+
+/**
+ * @brief   会话是否刚从断点恢复、还没有收到数据，此时上位机可以改为重新 START
+ * @return  true 表示刚从断点恢复
+ */
+static bool boot_stream_resume_pending(void)
+{
+    return boot_stream_ctx.started && !boot_stream_ctx.delta && boot_stream_ctx.first_seq != 0 &&
+           boot_stream_ctx.next_seq == boot_stream_ctx.first_seq && boot_stream_ctx.sack == 0;
+}
+
+/**
+ * @brief   流式传输会话结束，清除标志位
+ * @param[in] ok true 表示固件已全部写入，false 表示传输被取消或写 Flash 失败
+ */
+static void boot_stream_end_session(bool ok)
+{
+    boot_app_info_t boot_app_info;
+
+    boot_clear_flag(BOOT_FLAG_IAP_STREAM_RECV_DATA);
+    boot_clear_flag(BOOT_FLAG_EXT_DOWNLOAD_STREAM);
+    boot_baud_restore();
+
+    if (!ok) {
+        log_error("Stream transfer aborted (err=%d)!\r\n", boot_stream_ctx.status);
+        boot_cmd_print_menu();
+        return;
+    }
+
+    if (boot_stream_ctx.target == BOOT_UPDATE_TARGET_EXT_FLASH) {
+        boot_app_info_load(&boot_app_info);
+        boot_app_info.app_size[boot_ext_flash_get_cur_slot_idx()] = boot_stream_ctx.file_size;
+        boot_app_info_save(&boot_app_info);
+
+        log_info("Download completed!\r\n");
+        boot_cmd_print_menu();
+    } else {
+        log_info("IAP update completed (%d chunks identical to Flash skipped), restart!\r\n", boot_flash_get_skipped());
+        boot_system_reset();
+    }
+}
+
+/**
+ * @brief   处理 START 帧：检查固件大小，外部 Flash 按大小擦除槽位
+ * @details payload = 固件总字节数(4) + 整个固件的 CRC32(4)，传输结束时用该 CRC 校验写入的固件
+ * @param[in] payload 有效数据首地址
+ * @param[in] len     有效数据长度
+ */
+static void boot_stream_process_start(const uint8_t *payload, uint16_t len)
+{
+    boot_app_info_t boot_app_info;
+    uint8_t slot_idx = boot_ext_flash_get_cur_slot_idx();
+    uint32_t max_size;
+    uint32_t size;
+
+    if (len != STREAM_START_LEN) {
+        boot_stream_send_start_ack(-EINVAL);
+        return;
+    }
+
+    size = boot_stream_get_le32(payload);
+
+    /* START_ACK 丢失后上位机重发 START，不再重复擦除 */
+    if (boot_stream_ctx.started && !boot_stream_ctx.delta &&
+        boot_stream_ctx.next_seq == 0 && boot_stream_ctx.file_size == size) {
+        boot_stream_send_start_ack(0);
+        return;
+    }
+
+    max_size = (boot_stream_ctx.target == BOOT_UPDATE_TARGET_EXT_FLASH) ?
+               BOOT_EXT_FLASH_APP_MAX_SIZE : boot_flash_get_app_size();
+    if (size == 0 || size > max_size || (boot_stream_ctx.started && !boot_stream_resume_pending())) {
+        boot_stream_send_start_ack(-EINVAL);
+        return;
+    }
+
+    if (boot_stream_ctx.target == BOOT_UPDATE_TARGET_EXT_FLASH) {
+        boot_app_info_load(&boot_app_info);
+        boot_app_info.app_size[slot_idx] = 0;
+        boot_app_info_save(&boot_app_info);
+    }
+
+    boot_update_begin(boot_stream_ctx.target, size);
+    boot_update_set_resumable();
+    boot_update_set_image_crc(size, boot_stream_get_le32(&payload[4]));
+    boot_stream_ctx.started = true;
+    boot_stream_ctx.delta = false;
+    boot_stream_ctx.file_size = size;
+    boot_stream_ctx.frame_cnt = (size + STREAM_MAX_PAYLOAD - 1) / STREAM_MAX_PAYLOAD;
+    boot_stream_ctx.first_seq = 0;
+    boot_stream_ctx.next_seq = 0;
+    boot_stream_ctx.sack = 0;
+    boot_stream_ctx.status = 0;
+
+    boot_stream_send_start_ack(0);
+}
+
+/**
+ * @brief   处理 RESUME 帧：按 EEPROM 中的断点从中断的位置继续下载
+ * @details payload = 固件总字节数(4) + 整个固件的 CRC32(4)。写入目标、槽位、固件大小与断点一致且 Flash 内容校验通过时，
+ *          回复已写入的块数和它们的 CRC32，不擦除，之后的 DATA 帧从该块开始。
+ *          没有可用的断点时回复 -ENOENT，上位机改发 START 重新下载。
+ * @param[in] payload 有效数据首地址
+ * @param[in] len     有效数据长度
+ */
+static void boot_stream_process_resume(const uint8_t *payload, uint16_t len)
+{
+    uint32_t size = len == STREAM_START_LEN ? boot_stream_get_le32(payload) : 0;
+    uint32_t chunk_cnt = 0;
+    uint32_t crc = 0;
+    int ret;
+
+    if (size == 0 || (boot_stream_ctx.started && !boot_stream_resume_pending())) {
+        boot_stream_send_resume_ack(-EINVAL, 0, 0);
+        return;
+    }
+
+    ret = boot_update_resume(boot_stream_ctx.target, size, &chunk_cnt, &crc);
+    if (ret) {
+        boot_stream_send_resume_ack(ret, 0, 0);
+        return;
+    }
+    boot_update_set_image_crc(size, boot_stream_get_le32(&payload[4]));
+
+    boot_stream_ctx.started = true;
+    boot_stream_ctx.delta = false;
+    boot_stream_ctx.file_size = size;
+    boot_stream_ctx.frame_cnt = (size + STREAM_MAX_PAYLOAD - 1) / STREAM_MAX_PAYLOAD;
+    boot_stream_ctx.first_seq = chunk_cnt;
+    boot_stream_ctx.next_seq = chunk_cnt;
+    boot_stream_ctx.sack = 0;
+    boot_stream_ctx.status = 0;
+
+    boot_stream_send_resume_ack(0, chunk_cnt, crc);
+}
+
+/**
+ * @brief   检查 DATA 帧是否在接收窗口内且未收到过
+ * @param[in] seq 块序号
+ * @param[in] len 有效数据长度
+ * @return  true 表示需要写入 Flash，false 表示丢弃（重复、超出窗口或长度错误）
+ */
+static bool boot_stream_accept_data(uint16_t seq, uint16_t len)
+{
+    uint32_t offset;
+    uint32_t expect_len;
+
+    if (!boot_stream_ctx.started || boot_stream_ctx.delta ||
+        seq >= boot_stream_ctx.frame_cnt || seq < boot_stream_ctx.next_seq)
+        return false;
+
+    offset = seq - boot_stream_ctx.next_seq;
+    if (offset >= BOOT_STREAM_WINDOW || (boot_stream_ctx.sack & (1UL << offset)))
+        return false;
+
+    /* 除最后一块外都必须是完整的 1KB */
+    expect_len = boot_stream_ctx.file_size - seq * STREAM_MAX_PAYLOAD;
+    if (expect_len > STREAM_MAX_PAYLOAD)
+        expect_len = STREAM_MAX_PAYLOAD;
+    return len == expect_len;
+}
+
+/**
+ * @brief   处理 DATA 帧：拷贝进 update_chunk 后才记录到 SACK 位图
+ * @details 帧数据位于串口接收环形缓冲区中，回复 ACK 之前先拷贝出来，之后上位机发送的数据覆盖缓冲区也不影响。
+ *          写 Flash 由 boot_update_poll 在等待下一窗口时进行，写失败的错误码在之后的 ACK / END_ACK 中上报
+ * @param[in] seq     块序号
+ * @param[in] payload 有效数据首地址
+ * @param[in] len     有效数据长度
+ */
+static void boot_stream_process_data(uint16_t seq, const uint8_t *payload, uint16_t len)
+{
+    if (boot_stream_ctx.status || !boot_stream_accept_data(seq, len))
+        return;
+
+    boot_stream_ctx.status = boot_update_write_chunk_at(seq, payload, len);
+    if (!boot_stream_ctx.status)
+        boot_stream_ctx.sack |= 1UL << (seq - boot_stream_ctx.next_seq);
+}
+
+/**
+ * @brief   处理 PCRC 帧：回复 APP 区中一段块的 CRC32 和所在擦除单元
+ * @details 块大小与 DATA 帧相同（1KB），CRC 与帧校验相同（CRC32/MPEG-2），按 Flash 中的完整块计算。
+ *          擦除单元编号相同的块位于同一页/扇区，擦除时一起擦除，增量写入时上位机要重发整个擦除单元的块。
+ *          payload = 起始块(2) + 块数(2)，PCRC_ACK 的 seq 为起始块，payload = 状态(4) + 每块 crc32(4) + 擦除单元(2)
+ * @param[in] payload 有效数据首地址
+ * @param[in] len     有效数据长度
+ */
+static void boot_stream_process_pcrc(const uint8_t *payload, uint16_t len)
+{
+    static uint8_t reply[STREAM_REPLY_MAX_LEN];     // 静态变量，不占用栈
+    uint32_t app_size = boot_flash_get_app_size();
+    uint32_t addr;
+    uint32_t blk_len;
+    uint32_t crc;
+    uint16_t unit;
+    uint16_t first;
+    uint16_t cnt;
+    uint16_t i;
+    int status = 0;
+
+    first = len == 4 ? boot_stream_get_le16(&payload[0]) : 0;
+    cnt   = len == 4 ? boot_stream_get_le16(&payload[2]) : 0;
+
+    if (len != 4 || boot_stream_ctx.target != BOOT_UPDATE_TARGET_FLASH ||
+        (uint32_t)first * STREAM_MAX_PAYLOAD >= app_size)
+        status = -EINVAL;
+
+    if (status)
+        cnt = 0;
+    else if (cnt > STREAM_PCRC_MAX_BLOCKS)
+        cnt = STREAM_PCRC_MAX_BLOCKS;
+
+    for (i = 0; i < cnt; i++) {
+        addr = (uint32_t)(first + i) * STREAM_MAX_PAYLOAD;
+        if (addr >= app_size)
+            break;
+        blk_len = app_size - addr;
+        if (blk_len > STREAM_MAX_PAYLOAD)
+            blk_len = STREAM_MAX_PAYLOAD;
+
+        addr += BOOT_FLASH_APP_START_ADDR;
+        crc  = boot_crc32(0xFFFFFFFF, (const uint8_t *)addr, blk_len);
+        unit = boot_flash_get_unit_index(addr);
+        boot_stream_put_le32(&reply[4 + i * STREAM_PCRC_ENTRY_LEN], crc);
+        reply[4 + i * STREAM_PCRC_ENTRY_LEN + 4] = unit;
+        reply[4 + i * STREAM_PCRC_ENTRY_LEN + 5] = unit >> 8;
+    }
+
+    boot_stream_put_le32(&reply[0], (uint32_t)status);
+    boot_stream_send_frame(STREAM_TYPE_PCRC_ACK, first, reply, 4 + i * STREAM_PCRC_ENTRY_LEN);
+}
+
+/**
+ * @brief   处理 DELTA 帧：开始增量会话，之后只写入 WRITE 帧指定的块
+ * @details 不规划擦除，页/扇区在第一次写入时擦除。payload = 新固件总字节数(4) + 新固件的 CRC32(4)，回复 START_ACK。
+ *          上位机只发送内容不同的块，结束时用新固件的 CRC 校验整个 APP 区，
+ *          同一页/扇区中上位机漏发的块（擦除后留空）也能发现
+ * @param[in] payload 有效数据首地址
+ * @param[in] len     有效数据长度
+ */
+static void boot_stream_process_delta(const uint8_t *payload, uint16_t len)
+{
+    uint32_t size = len == STREAM_START_LEN ? boot_stream_get_le32(payload) : 0;
+
+    /* START_ACK 丢失后上位机重发 DELTA */
+    if (boot_stream_ctx.started && boot_stream_ctx.delta && boot_stream_ctx.file_size == size) {
+        boot_stream_send_start_ack(0);
+        return;
+    }
+
+    if (size == 0 || size > boot_flash_get_app_size() || boot_stream_ctx.started ||
+        boot_stream_ctx.target != BOOT_UPDATE_TARGET_FLASH) {
+        boot_stream_send_start_ack(-EINVAL);
+        return;
+    }
+
+    boot_update_begin(BOOT_UPDATE_TARGET_FLASH, 0);
+    boot_update_set_image_crc(size, boot_stream_get_le32(&payload[4]));
+    boot_stream_ctx.started = true;
+    boot_stream_ctx.delta = true;
+    boot_stream_ctx.file_size = size;
+    boot_stream_ctx.frame_cnt = (size + STREAM_MAX_PAYLOAD - 1) / STREAM_MAX_PAYLOAD;
+    boot_stream_ctx.first_seq = 0;
+    boot_stream_ctx.next_seq = 0;
+    boot_stream_ctx.sack = 0;
+    boot_stream_ctx.status = 0;
+
+    boot_stream_send_start_ack(0);
+}
+
+/**
+ * @brief   处理 WRITE 帧：把一个块写入 APP 区，写完立即回读校验
+ * @details seq = 块序号（地址为 APP 起始地址 + seq * 1KB），payload = 块数据的 CRC32(4) + 块数据，
+ *          块长度由帧长度给出，除最后一块外必须是完整的 1KB。写入后对 Flash 中的数据再算一次 CRC32，
+ *          与帧中携带的 CRC 一致才回复成功。WRITE_ACK 的 seq 为块序号，payload = 状态(4)。
+ *          同一块重复写入时内容相同，boot_flash_program 会跳过，WRITE_ACK 丢失后上位机可以直接重发。
+ * @param[in] seq     块序号
+ * @param[in] payload 有效数据首地址
+ * @param[in] len     有效数据长度
+ */
+static void boot_stream_process_write(uint16_t seq, const uint8_t *payload, uint16_t len)
+{
+    uint8_t reply[4];
+    const uint8_t *data = &payload[STREAM_WRITE_HDR_LEN];
+    uint32_t data_len = len - STREAM_WRITE_HDR_LEN;
+    uint32_t expect_len;
+    uint32_t crc = 0;
+    int status = 0;
+
+    if (!boot_stream_ctx.started || !boot_stream_ctx.delta || len <= STREAM_WRITE_HDR_LEN ||
+        seq >= boot_stream_ctx.frame_cnt) {
+        status = -EINVAL;
+    } else {
+        expect_len = boot_stream_ctx.file_size - (uint32_t)seq * STREAM_MAX_PAYLOAD;
+        if (expect_len > STREAM_MAX_PAYLOAD)
+            expect_len = STREAM_MAX_PAYLOAD;
+
+        crc = boot_stream_get_le32(payload);
+        if (data_len != expect_len || boot_crc32(0xFFFFFFFF, data, data_len) != crc)
+            status = -EINVAL;
+    }
+
+    if (!status && !boot_stream_ctx.status) {
+        boot_stream_ctx.status = boot_update_write_chunk_at(seq, data, data_len);
+        if (!boot_stream_ctx.status)
+            boot_stream_ctx.status = boot_update_flush();   // 停等写入，回复前写入 Flash
+        if (!boot_stream_ctx.status &&
+            boot_crc32(0xFFFFFFFF, (const uint8_t *)(BOOT_FLASH_APP_START_ADDR + (uint32_t)seq * STREAM_MAX_PAYLOAD),
+                       data_len) != crc)
+            boot_stream_ctx.status = -EIO;
+    }
+    if (!status)
+        status = boot_stream_ctx.status;
+
+    boot_stream_put_le32(reply, (uint32_t)status);
+    boot_stream_send_frame(STREAM_TYPE_WRITE_ACK, seq, reply, sizeof(reply));
+}
+
+/**
+ * @brief   处理 END 帧：所有块都已收到时写完剩余数据并结束会话
+ * @details 增量会话中已写入的块都已单独确认，直接结束。两种会话最后都按 START / DELTA 给出的 CRC 校验整个固件
+ */
+static void boot_stream_process_end(void)
+{
+    uint8_t payload[4];
+
+    if (!boot_stream_ctx.started ||
+        (!boot_stream_ctx.delta && boot_stream_ctx.next_seq != boot_stream_ctx.frame_cnt)) {
+        boot_stream_send_ack();     // 还有块未收到，回复当前确认状态
+        return;
+    }
+
+    if (!boot_stream_ctx.status)
+        boot_stream_ctx.status = boot_update_finish();
+
+    boot_stream_put_le32(payload, (uint32_t)boot_stream_ctx.status);
+    boot_stream_send_frame(STREAM_TYPE_END_ACK, boot_stream_ctx.next_seq, payload, sizeof(payload));
+
+    boot_stream_end_session(boot_stream_ctx.status == 0);
+}
+
+/**
+ * @brief   流式传输协议初始化
+ */
+void boot_stream_init(void)
+{
+    boot_stream_ctx.started = false;
+    boot_stream_ctx.delta = false;
+    boot_stream_ctx.first_seq = 0;
+    boot_stream_ctx.next_seq = 0;
+    boot_stream_ctx.sack = 0;
+    boot_stream_ctx.status = 0;
+    boot_stream_framer.len = 0;
+
+    if (boot_has_flag(BOOT_FLAG_EXT_DOWNLOAD_STREAM))
+        boot_stream_ctx.target = BOOT_UPDATE_TARGET_EXT_FLASH;
+    else
+        boot_stream_ctx.target = BOOT_UPDATE_TARGET_FLASH;
+}
+
+/**
+ * @brief   根据帧头计算整帧长度
+ * @param[in] frame 帧首地址，至少 STREAM_HEADER_LEN 字节
+ * @return  整帧字节数，0 表示帧头无效
+ */
+static uint16_t boot_stream_frame_len(const uint8_t *frame)
+{
+    uint16_t plen = boot_stream_get_le16(&frame[5]);
+
+    if (frame[0] != STREAM_SYNC0 || frame[1] != STREAM_SYNC1 || plen > STREAM_MAX_PAYLOAD + STREAM_WRITE_HDR_LEN)
+        return 0;
+    return STREAM_HEADER_LEN + plen + STREAM_CRC_LEN;
+}
+
+/**
+ * @brief   校验并处理一个完整的帧
+ * @param[in]     frame     帧首地址
+ * @param[in]     frame_len 整帧字节数
+ * @param[in,out] rx        本段数据的处理结果
+ * @return  true 表示帧校验通过，false 表示帧损坏
+ */
+static bool boot_stream_handle_frame(uint8_t *frame, uint16_t frame_len, boot_stream_rx_t *rx)
+{
+    uint16_t plen = frame_len - STREAM_HEADER_LEN - STREAM_CRC_LEN;
+    uint16_t seq = boot_stream_get_le16(&frame[3]);
+    uint8_t *payload = &frame[STREAM_HEADER_LEN];
+
+    if (boot_crc32(0xFFFFFFFF, &frame[2], STREAM_HEADER_LEN - 2 + plen) !=
+        boot_stream_get_le32(&frame[STREAM_HEADER_LEN + plen])) {
+        rx->need_ack = true;    // 帧损坏，尽快回复 ACK 让上位机补发
+        return false;
+    }
+
+    switch (frame[2]) {
+    case STREAM_TYPE_START:
+        boot_stream_process_start(payload, plen);
+        break;
+
+    case STREAM_TYPE_DATA:
+        rx->need_ack = true;
+        boot_stream_process_data(seq, payload, plen);
+        break;
+
+    case STREAM_TYPE_END:
+        rx->end_req = true;
+        break;
+
+    case STREAM_TYPE_PCRC:
+        boot_stream_process_pcrc(payload, plen);
+        break;
+
+    case STREAM_TYPE_DELTA:
+        boot_stream_process_delta(payload, plen);
+        break;
+
+    case STREAM_TYPE_WRITE:
+        boot_stream_process_write(seq, payload, plen);
+        break;
+
+    case STREAM_TYPE_RESUME:
+        boot_stream_process_resume(payload, plen);
+        break;
+
+    case STREAM_TYPE_ABORT:
+        boot_stream_ctx.status = -ECANCELED;
+        boot_stream_end_session(false);
+        rx->aborted = true;
+        break;
+
+    default:
+        break;
+    }
+    return true;
+}
+
+/**
+ * @brief   把一段串口数据拆分成帧，跨段的帧拷贝到拼接缓冲区，收齐后处理
+ * @details 一帧可能被空闲中断或接收环形缓冲区回卷分成两段，与 boot_xmodem_framer_feed 一样拼接。
+ *          拼接出的帧校验失败时整帧丢弃，段内的帧校验失败时跳过一个字节重新查找帧头
+ * @param[in]     data 接收数据的首地址
+ * @param[in]     len  接收数据的长度
+ * @param[in,out] rx   本段数据的处理结果
+ */
+static void boot_stream_framer_feed(uint8_t *data, uint32_t len, boot_stream_rx_t *rx)
+{
+    boot_stream_framer_t *framer = &boot_stream_framer;
+    uint32_t copy_len;
+    uint16_t frame_len;
+
+    while (len && !rx->aborted) {
+        /* 继续拼接上一段未完成的帧，先收齐帧头确定帧长度 */
+        if (framer->len) {
+            copy_len = (framer->expect_len ? framer->expect_len : STREAM_HEADER_LEN) - framer->len;
+            if (copy_len > len)
+                copy_len = len;
+
+            memcpy(&framer->buf[framer->len], data, copy_len);
+            framer->len += copy_len;
+            data += copy_len;
+            len  -= copy_len;
+
+            if (!framer->expect_len) {
+                if (framer->len < STREAM_HEADER_LEN)
+                    return;
+                framer->expect_len = boot_stream_frame_len(framer->buf);
+                if (!framer->expect_len)
+                    framer->len = 0;    // 帧头无效，从新数据重新查找帧头
+                continue;
+            }
+
+            if (framer->len < framer->expect_len)
+                return;
+
+            framer->len = 0;
+            boot_stream_handle_frame(framer->buf, framer->expect_len, rx);
+            continue;
+        }
+
+        /* 查找帧头，跳过无法识别的字节 */
+        if (data[0] != STREAM_SYNC0 || (len > 1 && data[1] != STREAM_SYNC1)) {
+            data++;
+            len--;
+            continue;
+        }
+
+        /* 帧不完整，拷贝到拼接缓冲区等待下一段 */
+        frame_len = len >= STREAM_HEADER_LEN ? boot_stream_frame_len(data) : 0;
+        if (len < STREAM_HEADER_LEN || (frame_len && len < frame_len)) {
+            memcpy(framer->buf, data, len);
+            framer->len = len;
+            framer->expect_len = frame_len;
+            return;
+        }
+
+        if (!frame_len || !boot_stream_handle_frame(data, frame_len, rx)) {
+            data++;
+            len--;
+            continue;
+        }
+        data += frame_len;
+        len  -= frame_len;
+    }
+}
+
+/**
+ * @brief   流式传输协议接收数据
+ * @details 一段串口数据中可能包含多个背靠背的帧，一帧也可能跨两段，逐帧拼接、解析并校验 CRC32。
+ *          DATA 帧拷贝进 update_chunk 后才在 ACK 中确认，之后由 boot_update_poll 在空闲时写入 Flash：
+ *          上位机收到 ACK 后立即发送下一窗口，写 Flash 的时间与串口传输重叠。
+ * @param[in] data 接收数据的首地址
+ * @param[in] len  接收数据的长度
+ */
+void boot_stream_recv_data(uint8_t *data, uint32_t len)
+{
+    boot_stream_rx_t rx = { false, false, false };
+
+    boot_stream_framer_feed(data, len, &rx);
+    if (rx.aborted)
+        return;
+
+    /* 窗口起始的块连续收到后滑动窗口 */
+    while (boot_stream_ctx.sack & 1) {
+        boot_stream_ctx.sack >>= 1;
+        boot_stream_ctx.next_seq++;
+    }
+
+    if (rx.need_ack)
+        boot_stream_send_ack();
+
+    if (rx.end_req)
+        boot_stream_process_end();
+}
@@ -0,0 +1,65 @@
+#ifndef BOOT_STREAM_H
+#define BOOT_STREAM_H
+
+#include <stdint.h>
+
+#ifndef ECANCELED
+#define ECANCELED   125
+#endif
+
+/*
+ * 滑动窗口流式传输协议，用于高波特率下替代停等式的 Xmodem
+ *
+ * 帧格式（多字节字段均为小端）：
+ *   | 0xA5 | 0x5A | type(1) | seq(2) | len(2) | payload(len) | crc32(4) |
+ *   crc32 为 CRC32/MPEG-2，校验范围为 type 到 payload 末尾。
+ *
+ * 上位机 -> BootLoader：
+ *   START (0x01)：payload = 固件总字节数(4) + 整个固件的 CRC32(4)，BootLoader 回复 START_ACK
+ *   DATA  (0x02)：seq = 块序号，payload = 固件第 seq 个 1KB 块（最后一块可以不足 1KB）
+ *   END   (0x03)：所有块都被确认后发送，BootLoader 写完剩余数据后回复 END_ACK
+ *   ABORT (0x04)：取消传输
+ *   PCRC  (0x05)：payload = 起始块(2) + 块数(2)，查询 APP 区现有内容每个 1KB 块的 CRC32（一次最多 32 块）
+ *   DELTA (0x06)：payload = 新固件总字节数(4) + 新固件的 CRC32(4)，开始增量会话（仅内部 Flash），BootLoader 回复 START_ACK
+ *   WRITE (0x07)：seq = 块序号，payload = 块数据 CRC32(4) + 块数据，增量会话中写入单个块，停等确认
+ *   RESUME(0x08)：payload = 与 START 相同，按 EEPROM 中的断点继续上次中断的下载，BootLoader 回复 RESUME_ACK
+ *   整个固件的 CRC32 按 STM32 CRC 单元的方式计算（逐个小端 32 位字，尾部不足一个字补 0xFF，
+ *   与 boot_crc32_word 相同），END 时 BootLoader 用它校验写入的整个固件，不一致时 END_ACK 状态非 0。
+ *
+ * BootLoader -> 上位机：
+ *   ACK       (0x80)：seq = 期望的下一个块序号（累计确认），payload = SACK 位图(4) + 状态(4)，
+ *                     位图 bit i 表示块 seq + i 已收到，用于选择性重传
+ *   START_ACK (0x81)：payload = 窗口块数(2) + 单块最大字节数(2) + 状态(4)
+ *   END_ACK   (0x82)：payload = 状态(4)，0 表示固件已全部写入 Flash
+ *   PCRC_ACK  (0x83)：seq = 起始块，payload = 状态(4) + 每块 CRC32(4) + 所在页/扇区编号(2)
+ *   WRITE_ACK (0x84)：seq = 块序号，payload = 状态(4)，0 表示该块已写入并回读校验通过
+ *   RESUME_ACK(0x85)：payload = 与 START_ACK 相同的 8 字节 + 已写入块数(4) + 已写入块的 CRC32(4)，
+ *                     状态非 0（如 -ENOENT）表示没有可用的断点
+ *
+ * 上位机最多连续发送窗口块数个未确认的 DATA 帧，收到 ACK 后补发位图中缺失的块并继续发送。
+ * ACK 中确认的块都已拷贝出串口接收缓冲区。一帧可以跨两次 DMA 接收，但一个窗口的数据
+ * 仍应放进串口单次 DMA 接收长度（rx_single_max），否则超出部分丢失，只能靠重传补齐。
+ *
+ * 增量更新：上位机先发 DELTA，再用 PCRC 读出 APP 区每块的 CRC，与新固件逐块比较，
+ * 只用 WRITE 发送内容不同的块。页/扇区在第一次写入时整体擦除，所以同一页/扇区内
+ * 新固件范围内的其他块也要一起发送（PCRC_ACK 中页/扇区编号相同的块）。全部写完后发 END。
+ *
+ * 断点续传：START 开始的下载每连续写入 BOOT_UPDATE_RESUME_INTERVAL 块，在 EEPROM 中记录写入目标、
+ * 已写入块数和这些块的 CRC。链路中断或复位后，上位机重新进入同一菜单并发 RESUME，
+ * 确认 RESUME_ACK 中的 CRC 与自己固件的前几块一致后，从已写入块数开始发 DATA；
+ * 不一致或没有断点时直接发 START 重新下载。
+ */
+
+/**
+ * @brief   流式传输协议初始化
+ */
+void boot_stream_init(void);
+
+/**
+ * @brief   流式传输协议接收数据
+ * @param[in] data 接收数据的首地址
+ * @param[in] len  接收数据的长度
+ */
+void boot_stream_recv_data(uint8_t *data, uint32_t len);
+
+#endif
@@ -3,6 +3,27 @@
 
 #include <stdint.h>
 
+#ifndef EBADMSG
+#define EBADMSG 74
+#endif
+
+#ifndef ECANCELED
+#define ECANCELED   125
+#endif
+
+/* Xmodem/Ymodem 协议 */
+#define XMODEM_PACKET_LEN           133     // 数据包总长度 SOH + pkt_no + ~pkt_no + 128 bytes + CRC(2 bytes) 
+#define XMODEM_PACKET_DATA_LEN      128     // 数据包有效数据长度
+#define XMODEM_1K_PACKET_LEN        1029    // Xmodem-1K 数据包总长度 STX + pkt_no + ~pkt_no + 1024 bytes + CRC(2 bytes)
+#define XMODEM_1K_PACKET_DATA_LEN   1024    // Xmodem-1K 数据包有效数据长度
+#define XMODEM_SOH                  0x01
+#define XMODEM_STX                  0x02
+#define XMODEM_EOT                  0x04
+#define XMODEM_ACK                  0x06
+#define XMODEM_NAK                  0x15
+#define XMODEM_CAN                  0x18
+#define XMODEM_C_INTERVAL_MS        1000    // 握手阶段发送 'C' 的间隔
+
 /**
  * @brief   Xmodem 协议初始化
  */
@@ -13,6 +34,38 @@ void boot_xmodem_init(void);
  */
 void boot_xmodem_send_c(void);
 
+/**
+ * @brief   Xmodem/Ymodem 完整帧处理函数
+ * @param[in] frame 帧首地址（SOH/STX 数据包，或单独成段的单字节 EOT/CAN）
+ * @param[in] len   帧长度
+ * @return  0 表示继续接收，负值表示丢弃本段剩余数据
+ */
+typedef int (*boot_xmodem_frame_handler_t)(uint8_t *frame, uint32_t len);
+
+/**
+ * @brief   复位 Xmodem/Ymodem 帧重组状态，丢弃未拼完的包
+ */
+void boot_xmodem_framer_reset(void);
+
+/**
+ * @brief   把一段串口数据送入 Xmodem/Ymodem 帧重组，拼出的完整帧交给 handler
+ * @param[in] data    接收数据的首地址
+ * @param[in] len     接收数据的长度
+ * @param[in] handler 完整帧处理函数
+ */
+void boot_xmodem_framer_feed(uint8_t *data, uint32_t len, boot_xmodem_frame_handler_t handler);
+
+/**
+ * @brief   解析一个 Xmodem/Ymodem 数据包
+ * @details 根据帧头和长度识别 SOH（133 字节）或 STX（1029 字节）数据包，并校验 CRC16
+ * @param[in]  data    接收数据的首地址
+ * @param[in]  len     接收数据的长度
+ * @param[out] seq     数据包序号
+ * @param[out] payload 有效数据首地址
+ * @return	有效数据长度（128 或 1024），0 表示不是数据包，-EBADMSG 表示 CRC 校验错误
+ */
+int boot_xmodem_parse_packet(uint8_t *data, uint32_t len, uint8_t *seq, uint8_t **payload);
+
 /**
  * @brief   Xmodem 协议接收数据
  * @param[in] data 接收数据的首地址
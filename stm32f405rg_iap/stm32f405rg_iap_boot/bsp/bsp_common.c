@@ -6,6 +6,7 @@
 #include "bsp_i2c_bus.h"
 #include "bsp_eeprom.h"
 #include "bsp_flash.h"
+#include "bsp_crc.h"
 #include "bsp_ext_flash.h"
 #include "log.h"
 
@@ -46,6 +47,13 @@ int bsp_common_init(void)
         log_error("Failed to init bsp flash: %d", ret);
         return ret;
     }
+
+    bsp_crc_t *crc = bsp_crc_get();
+    ret = crc->ops->init(crc);
+    if (ret) {
+        log_error("Failed to init bsp crc: %d", ret);
+        return ret;
+    }
     
     bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
     ret = ext_flash->ops->init(ext_flash);
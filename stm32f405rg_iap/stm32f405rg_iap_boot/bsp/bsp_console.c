@@ -6,7 +6,7 @@
 /* --- 驱动设备 --- */
 static uart_dev_t uart_console_dev;
 static uint8_t uart_console_tx_buf[256];
-static uint8_t uart_console_rx_buf[1024];
+static uint8_t uart_console_rx_buf[16640]; // 至少容纳两个流式传输窗口（rx_single_max + 1），处理一个窗口时下一个窗口写入另一段
 static const uart_cfg_t uart_console_cfg = {
     .uart_periph     = USART1,
     .baudrate        = 921600,
@@ -18,7 +18,7 @@ static const uart_cfg_t uart_console_cfg = {
     .rx_buf          = uart_console_rx_buf,
     .tx_buf_size     = sizeof(uart_console_tx_buf),
     .rx_buf_size     = sizeof(uart_console_rx_buf),
-    .rx_single_max   = 512,
+    .rx_single_max   = 8300,  // 必须 >= 一个流式传输窗口（8 x 1035 字节）及 Xmodem-1K 数据包长度，否则 DMA 提前停止导致丢包
     .rx_pre_priority = 0,
     .rx_sub_priority = 0
 };
@@ -94,13 +94,30 @@ static int bsp_console_recv_data_impl(bsp_console_t *self, uint8_t **data, uint3
     return dev->ops->recv_data(dev, data, len);
 }
 
+/**
+ * @brief   BSP 控制台修改波特率
+ * @param[in] self     指向 BSP 对象的指针
+ * @param[in] baudrate 新的波特率，0 表示恢复为 uart_console_cfg 中配置的默认波特率
+ * @return  0 表示成功，其他值表示失败
+ */
+static int bsp_console_set_baudrate_impl(bsp_console_t *self, uint32_t baudrate)
+{
+    uart_dev_t *dev = (uart_dev_t *)self->drv;
+
+    if (baudrate == 0)
+        baudrate = uart_console_cfg.baudrate;
+
+    return dev->ops->set_baudrate(dev, baudrate);
+}
+
 /* --- 操作表 --- */
 static const bsp_console_ops_t bsp_console_ops = {
-    .init      = bsp_console_init_impl,
-    .vprintf   = bsp_console_vprintf_impl,
-    .printf    = bsp_console_printf_impl,
-    .send_data = bsp_console_send_data_impl,
-    .recv_data = bsp_console_recv_data_impl
+    .init         = bsp_console_init_impl,
+    .vprintf      = bsp_console_vprintf_impl,
+    .printf       = bsp_console_printf_impl,
+    .send_data    = bsp_console_send_data_impl,
+    .recv_data    = bsp_console_recv_data_impl,
+    .set_baudrate = bsp_console_set_baudrate_impl
 };
 
 /* --- 单例对象 --- */
@@ -13,6 +13,7 @@ typedef struct {
     void (*printf)(bsp_console_t *self, const char *format, ...);
     int (*send_data)(bsp_console_t *self, uint8_t *data, uint32_t len);
     int (*recv_data)(bsp_console_t *self, uint8_t **data, uint32_t *len);
+    int (*set_baudrate)(bsp_console_t *self, uint32_t baudrate);
 } bsp_console_ops_t;
 
 /* 设备实例结构体 */
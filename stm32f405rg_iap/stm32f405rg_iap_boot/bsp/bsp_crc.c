@@ -0,0 +1,54 @@
+#include <stddef.h>
+#include <errno.h>
+#include "bsp_crc.h"
+#include "drv_crc.h"
+
+/* --- 驱动设备 --- */
+static crc_dev_t crc_dev;
+
+/**
+ * @brief   BSP 初始化硬件 CRC
+ * @param[in] self 指向 BSP 对象的指针
+ * @return  0 表示成功，其他值表示失败
+ */
+static int bsp_crc_init_impl(bsp_crc_t *self)
+{
+    return drv_crc_init((crc_dev_t *)self->drv);
+}
+
+/**
+ * @brief   BSP 计算一段数据的 CRC32
+ * @param[in] self 指向 BSP 对象的指针
+ * @param[in] data 数据首地址（4 字节对齐）
+ * @param[in] cnt  数据字节数（4 的倍数）
+ * @return	CRC32 值，驱动未初始化时返回 0
+ */
+static uint32_t bsp_crc_calc_impl(bsp_crc_t *self, const uint32_t *data, uint32_t cnt)
+{
+    crc_dev_t *dev = (crc_dev_t *)self->drv;
+    if (!dev || !dev->ops)
+        return 0;
+
+    return dev->ops->calc(dev, data, cnt);
+}
+
+/* --- 操作表 --- */
+static const bsp_crc_ops_t bsp_crc_ops = {
+    .init = bsp_crc_init_impl,
+    .calc = bsp_crc_calc_impl
+};
+
+/* --- 单例对象 --- */
+static bsp_crc_t bsp_crc = {
+    .ops = &bsp_crc_ops,
+    .drv = &crc_dev,
+};
+
+/**
+ * @brief   获取 BSP 单例对象
+ * @return  指向全局 BSP 对象的指针
+ */
+bsp_crc_t *bsp_crc_get(void)
+{
+    return &bsp_crc;
+}
@@ -8,6 +8,7 @@ typedef struct bsp_delay bsp_delay_t;
 /* 操作接口 */
 typedef struct {
     int (*init)(bsp_delay_t *self);
+    void (*deinit)(bsp_delay_t *self);
 } bsp_delay_ops_t;
 
 /* 设备实例结构体 */
@@ -20,5 +21,6 @@ struct bsp_delay {
 bsp_delay_t *bsp_delay_get(void);
 void bsp_delay_us(uint32_t us);
 void bsp_delay_ms(uint32_t ms);
+uint32_t bsp_delay_get_tick_ms(void);
 
 #endif  /* BSP_DELAY_H */
@@ -15,6 +15,7 @@ static const spi_cfg_t spi2_cfg = {
 	.mosi_pin   = GPIO_Pin_15,
 	.prescaler  = SPI_BaudRatePrescaler_2,
 	.mode       = SPI_MODE_0,
+	.dma        = true,		// SPI2 使用 DMA1 数据流 3（接收）/数据流 4（发送），与串口 USART1 的 DMA2 数据流 5 不冲突
 };
 
 static int spi2_start(gpio_port_t cs_port, gpio_pin_t cs_pin)
@@ -26,15 +27,46 @@ static int spi2_swap_byte(uint8_t send, uint8_t *recv)
 {
 	return spi2.ops->swap_byte(&spi2, send, recv);
 }
+
+static int spi2_transfer(const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+	return spi2.ops->transfer(&spi2, tx, rx, len);
+}
+
+static int spi2_write(const uint8_t *tx, uint32_t len)
+{
+	return spi2.ops->write(&spi2, tx, len);
+}
+
+static int spi2_read(uint8_t *rx, uint32_t len)
+{
+	return spi2.ops->read(&spi2, rx, len);
+}
+
+static int spi2_transfer_start(const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+	return spi2.ops->transfer_start(&spi2, tx, rx, len);
+}
+
+static int spi2_transfer_poll(void)
+{
+	return spi2.ops->transfer_poll(&spi2);
+}
+
 static int spi2_stop(gpio_port_t cs_port, gpio_pin_t cs_pin)
 {
 	return spi2.ops->stop(&spi2, cs_port, cs_pin);
 }
 
 static w25qx_spi_ops_t w25qx_spi_ops = {
-	.start     = spi2_start,
-	.swap_byte = spi2_swap_byte,
-	.stop      = spi2_stop	
+	.start          = spi2_start,
+	.swap_byte      = spi2_swap_byte,
+	.transfer       = spi2_transfer,
+	.write          = spi2_write,
+	.read           = spi2_read,
+	.transfer_start = spi2_transfer_start,
+	.transfer_poll  = spi2_transfer_poll,
+	.stop           = spi2_stop	
 };
 
 static w25qx_dev_t w25qx_dev;
@@ -44,6 +76,77 @@ static const w25qx_cfg_t w25qx_cfg = {
 	.cs_pin  = GPIO_Pin_12,
 };
 
+/* --- 擦除调度 --- */
+
+typedef struct {
+	uint32_t erase_addr;		// 最近一次擦除的起始地址
+	uint32_t erase_len;			// 最近一次擦除的字节数，0 表示没有可能进行中的擦除
+	bool     resume_pending;	// 擦除暂停期间启动了异步读取/页编程，完成后恢复擦除
+} bsp_ext_flash_sched_t;
+
+static bsp_ext_flash_sched_t bsp_ext_flash_sched;
+
+/**
+ * @brief   读写外部 Flash 前调度进行中的擦除
+ * @details 访问正在擦除的扇区/块以外的地址时暂停擦除，访问完成后由调用方恢复；
+ *          访问正在擦除的区域时先恢复擦除，由驱动等待擦除完成后再访问
+ * @param[in] dev  w25qx_dev_t 结构体指针
+ * @param[in] addr 访问的起始地址
+ * @param[in] cnt  访问的字节数
+ * @return  0 表示成功，其他值表示失败
+ */
+static int bsp_ext_flash_sched_access(w25qx_dev_t *dev, uint32_t addr, uint32_t cnt)
+{
+	if (bsp_ext_flash_sched.erase_len == 0)
+		return 0;
+	if (!dev->erasing) {
+		bsp_ext_flash_sched.erase_len = 0;		// 擦除已完成
+		return 0;
+	}
+
+	if (addr < bsp_ext_flash_sched.erase_addr + bsp_ext_flash_sched.erase_len &&
+		addr + cnt > bsp_ext_flash_sched.erase_addr) {
+		bsp_ext_flash_sched.resume_pending = false;
+		return dev->ops->erase_resume(dev);
+	}
+
+	return dev->ops->erase_suspend(dev);
+}
+
+/**
+ * @brief   开始新的擦除前恢复暂停的擦除，并记录新的擦除范围
+ * @param[in] dev  w25qx_dev_t 结构体指针
+ * @param[in] addr 擦除的起始地址
+ * @param[in] len  擦除的字节数
+ * @return  0 表示成功，其他值表示失败
+ */
+static int bsp_ext_flash_sched_erase(w25qx_dev_t *dev, uint32_t addr, uint32_t len)
+{
+	int ret;
+
+	bsp_ext_flash_sched.resume_pending = false;
+	ret = dev->ops->erase_resume(dev);
+	if (ret)
+		return ret;
+
+	bsp_ext_flash_sched.erase_addr = addr;
+	bsp_ext_flash_sched.erase_len = len;
+	return 0;
+}
+
+/**
+ * @brief   同步读写完成后恢复擦除，返回读写的结果
+ * @param[in] dev w25qx_dev_t 结构体指针
+ * @param[in] ret 读写的结果
+ * @return  0 表示成功，其他值表示失败
+ */
+static int bsp_ext_flash_sched_done(w25qx_dev_t *dev, int ret)
+{
+	int resume_ret = dev->ops->erase_resume(dev);
+
+	return ret ? ret : resume_ret;
+}
+
 /**
  * @brief   BSP 初始化外部 Flash
  * @param[in] self 指向 BSP 对象的指针
@@ -84,8 +187,39 @@ static int bsp_ext_flash_read_id_impl(bsp_ext_flash_t *self, uint8_t *mid, uint1
 static int bsp_ext_flash_write_page_impl(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data)
 {
     w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
+
+    ret = bsp_ext_flash_sched_access(dev, addr, cnt);
+    if (ret)
+        return ret;
+
+    return bsp_ext_flash_sched_done(dev, dev->ops->write_page(dev, addr, cnt, data));
+}
+
+/**
+ * @brief   BSP 外部 Flash 启动按页写入，发出页编程指令后立即返回，之后用 busy_poll 查询完成
+ * @details 写入正在擦除的区域以外的地址时暂停擦除，busy_poll 查询到页编程完成后恢复擦除
+ * @param[in] self 指向 BSP 对象的指针
+ * @param[in] addr 起始地址
+ * @param[in] cnt  要写入数据的数量
+ * @param[in] data 用于写入数据的数组，返回后可以立即复用
+ * @return  0 表示已启动，其他值表示失败
+ */
+static int bsp_ext_flash_write_page_start_impl(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data)
+{
+    w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
+
+    ret = bsp_ext_flash_sched_access(dev, addr, cnt);
+    if (ret)
+        return ret;
+
+    ret = dev->ops->write_page_start(dev, addr, cnt, data);
+    if (ret)
+        return bsp_ext_flash_sched_done(dev, ret);
 
-    return dev->ops->write_page(dev, addr, cnt, data);
+    bsp_ext_flash_sched.resume_pending = dev->suspended;
+    return 0;
 }
 
 /**
@@ -99,8 +233,13 @@ static int bsp_ext_flash_write_page_impl(bsp_ext_flash_t *self, uint32_t addr, u
 static int bsp_ext_flash_write_data_impl(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data)
 {
     w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
+
+    ret = bsp_ext_flash_sched_access(dev, addr, cnt);
+    if (ret)
+        return ret;
 
-    return dev->ops->write_data(dev, addr, cnt, data);
+    return bsp_ext_flash_sched_done(dev, dev->ops->write_data(dev, addr, cnt, data));
 }
 
 /**
@@ -112,8 +251,71 @@ static int bsp_ext_flash_write_data_impl(bsp_ext_flash_t *self, uint32_t addr, u
 static int bsp_ext_flash_erase_sector_impl(bsp_ext_flash_t *self, uint32_t addr)
 {
     w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
+
+    ret = bsp_ext_flash_sched_erase(dev, addr, 4 * 1024);
+    if (ret)
+        return ret;
+
+    ret = dev->ops->erase_sector_4kb(dev, addr);
+    bsp_ext_flash_sched.erase_len = 0;
+    return ret;
+}
+
+/**
+ * @brief   BSP 外部 Flash 启动扇区擦除（4KB），发出指令后立即返回，之后用 busy_poll 查询完成
+ * @param[in] self 指向 BSP 对象的指针
+ * @param[in] addr 指定扇区的地址
+ * @return  0 表示已启动，其他值表示失败
+ */
+static int bsp_ext_flash_erase_sector_start_impl(bsp_ext_flash_t *self, uint32_t addr)
+{
+    w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
+
+    ret = bsp_ext_flash_sched_erase(dev, addr, 4 * 1024);
+    if (ret)
+        return ret;
+
+    return dev->ops->erase_sector_4kb_start(dev, addr);
+}
+
+/**
+ * @brief   BSP 外部 Flash 半块擦除（32KB）
+ * @param[in] self 指向 BSP 对象的指针
+ * @param[in] addr 指定半块的地址（32KB 对齐）
+ * @return  0 表示成功，其他值表示失败
+ */
+static int bsp_ext_flash_erase_block_32k_impl(bsp_ext_flash_t *self, uint32_t addr)
+{
+    w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
+
+    ret = bsp_ext_flash_sched_erase(dev, addr, 32 * 1024);
+    if (ret)
+        return ret;
+
+    ret = dev->ops->erase_block_32kb(dev, addr);
+    bsp_ext_flash_sched.erase_len = 0;
+    return ret;
+}
+
+/**
+ * @brief   BSP 外部 Flash 启动半块擦除（32KB），发出指令后立即返回，之后用 busy_poll 查询完成
+ * @param[in] self 指向 BSP 对象的指针
+ * @param[in] addr 指定半块的地址（32KB 对齐）
+ * @return  0 表示已启动，其他值表示失败
+ */
+static int bsp_ext_flash_erase_block_32k_start_impl(bsp_ext_flash_t *self, uint32_t addr)
+{
+    w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
+
+    ret = bsp_ext_flash_sched_erase(dev, addr, 32 * 1024);
+    if (ret)
+        return ret;
 
-    return dev->ops->erase_sector_4kb(dev, addr);
+    return dev->ops->erase_block_32kb_start(dev, addr);
 }
 
 /**
@@ -126,8 +328,56 @@ static int bsp_ext_flash_erase_sector_impl(bsp_ext_flash_t *self, uint32_t addr)
 static int bsp_ext_flash_erase_block_impl(bsp_ext_flash_t *self, uint16_t idx)
 {
     w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
+
+    ret = bsp_ext_flash_sched_erase(dev, (uint32_t)idx * 64 * 1024, 64 * 1024);
+    if (ret)
+        return ret;
+
+    ret = dev->ops->erase_block_64kb(dev, idx);
+    bsp_ext_flash_sched.erase_len = 0;
+    return ret;
+}
+
+/**
+ * @brief   BSP 外部 Flash 启动块擦除（64KB），发出指令后立即返回，之后用 busy_poll 查询完成
+ * @param[in] self 指向 BSP 对象的指针
+ * @param[in] idx  指定擦除块的索引
+ * @return  0 表示已启动，其他值表示失败
+ */
+static int bsp_ext_flash_erase_block_start_impl(bsp_ext_flash_t *self, uint16_t idx)
+{
+    w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
+
+    ret = bsp_ext_flash_sched_erase(dev, (uint32_t)idx * 64 * 1024, 64 * 1024);
+    if (ret)
+        return ret;
+
+    return dev->ops->erase_block_64kb_start(dev, idx);
+}
+
+/**
+ * @brief   BSP 外部 Flash 查询编程/擦除是否完成
+ * @param[in] self 指向 BSP 对象的指针
+ * @return  0 表示已完成，-EBUSY 表示进行中，其他值表示失败
+ */
+static int bsp_ext_flash_busy_poll_impl(bsp_ext_flash_t *self)
+{
+    w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
 
-    return dev->ops->erase_block_64kb(dev, idx);
+    ret = dev->ops->busy_poll(dev);
+    if (ret == 0 && bsp_ext_flash_sched.resume_pending) {
+        /* 擦除暂停期间的页编程已完成，恢复擦除 */
+        bsp_ext_flash_sched.resume_pending = false;
+        ret = dev->ops->erase_resume(dev);
+        if (ret == 0)
+            ret = dev->ops->busy_poll(dev);
+    }
+    if (ret == 0 && !dev->erasing)
+        bsp_ext_flash_sched.erase_len = 0;	// 擦除已完成，之后的读写不再暂停/恢复
+    return ret;
 }
 
 /**
@@ -141,19 +391,76 @@ static int bsp_ext_flash_erase_block_impl(bsp_ext_flash_t *self, uint16_t idx)
 static int bsp_ext_flash_read_data_impl(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data)
 {
     w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
+
+    ret = bsp_ext_flash_sched_access(dev, addr, cnt);
+    if (ret)
+        return ret;
+
+    return bsp_ext_flash_sched_done(dev, dev->ops->read_data(dev, addr, cnt, data));
+}
+
+/**
+ * @brief   BSP 外部 Flash 启动异步读取数据，SPI 使用 DMA 时启动后立即返回
+ * @param[in]  self 指向 BSP 对象的指针
+ * @param[in]  addr 读取数据的起始地址
+ * @param[in]  cnt  要读取数据的数量
+ * @param[out] data 用于接收读取数据的数组，完成前不能修改
+ * @return  0 表示已启动，其他值表示失败
+ */
+static int bsp_ext_flash_read_data_start_impl(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data)
+{
+    w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
+
+    ret = bsp_ext_flash_sched_access(dev, addr, cnt);
+    if (ret)
+        return ret;
+
+    ret = dev->ops->read_data_start(dev, addr, cnt, data);
+    if (ret)
+        return bsp_ext_flash_sched_done(dev, ret);
+
+    bsp_ext_flash_sched.resume_pending = dev->suspended;
+    return 0;
+}
+
+/**
+ * @brief   BSP 外部 Flash 查询异步读取是否完成
+ * @param[in] self 指向 BSP 对象的指针
+ * @return  0 表示已完成，-EBUSY 表示读取中，其他值表示读取失败
+ */
+static int bsp_ext_flash_read_data_poll_impl(bsp_ext_flash_t *self)
+{
+    w25qx_dev_t *dev = (w25qx_dev_t *)self->drv;
+    int ret;
+
+    ret = dev->ops->read_data_poll(dev);
+    if (ret == -EBUSY || !bsp_ext_flash_sched.resume_pending)
+        return ret;
 
-    return dev->ops->read_data(dev, addr, cnt, data);
+    /* 擦除暂停期间的读取已完成，恢复擦除 */
+    bsp_ext_flash_sched.resume_pending = false;
+    return bsp_ext_flash_sched_done(dev, ret);
 }
 
 /* --- 操作表 --- */
 static const bsp_ext_flash_ops_t bsp_ext_flash_ops = {
-    .init         = bsp_ext_flash_init_impl,
-    .read_id      = bsp_ext_flash_read_id_impl,
-	.write_page   = bsp_ext_flash_write_page_impl,
-	.write_data   = bsp_ext_flash_write_data_impl,
-	.erase_sector = bsp_ext_flash_erase_sector_impl,
-	.erase_block  = bsp_ext_flash_erase_block_impl,
-	.read_data    = bsp_ext_flash_read_data_impl,
+    .init                  = bsp_ext_flash_init_impl,
+    .read_id               = bsp_ext_flash_read_id_impl,
+	.write_page            = bsp_ext_flash_write_page_impl,
+	.write_page_start      = bsp_ext_flash_write_page_start_impl,
+	.write_data            = bsp_ext_flash_write_data_impl,
+	.erase_sector          = bsp_ext_flash_erase_sector_impl,
+	.erase_sector_start    = bsp_ext_flash_erase_sector_start_impl,
+	.erase_block_32k       = bsp_ext_flash_erase_block_32k_impl,
+	.erase_block_32k_start = bsp_ext_flash_erase_block_32k_start_impl,
+	.erase_block           = bsp_ext_flash_erase_block_impl,
+	.erase_block_start     = bsp_ext_flash_erase_block_start_impl,
+	.busy_poll             = bsp_ext_flash_busy_poll_impl,
+	.read_data             = bsp_ext_flash_read_data_impl,
+	.read_data_start       = bsp_ext_flash_read_data_start_impl,
+	.read_data_poll        = bsp_ext_flash_read_data_poll_impl,
 };
 
 /* --- 单例对象 --- */
@@ -49,11 +49,63 @@ static int bsp_flash_write_impl(bsp_flash_t *self, uint32_t addr, uint32_t cnt,
     return dev->ops->write(dev, addr, cnt, data);
 }
 
+/**
+ * @brief   BSP 启动异步写内部 Flash，F1/GD32 启用 DMA 编程时启动后立即返回
+ * @param[in] self 指向 BSP 对象的指针
+ * @param[in] addr 起始地址（4 字节对齐）
+ * @param[in] cnt  写入字节数（4 的倍数）
+ * @param[in] data 要写入的数据，完成前不能修改
+ * @return	0 表示已启动，其他值表示失败
+ */
+static int bsp_flash_write_start_impl(bsp_flash_t *self, uint32_t addr, uint32_t cnt, const uint32_t *data)
+{
+    flash_dev_t *dev = (flash_dev_t *)self->drv;
+    if (!dev)
+        return -EINVAL;
+
+    return dev->ops->write_start(dev, addr, cnt, data);
+}
+
+/**
+ * @brief   BSP 查询异步写内部 Flash 是否完成
+ * @param[in] self 指向 BSP 对象的指针
+ * @return	0 表示已完成，-EBUSY 表示写入中，其他值表示写入失败
+ */
+static int bsp_flash_write_poll_impl(bsp_flash_t *self)
+{
+    flash_dev_t *dev = (flash_dev_t *)self->drv;
+    if (!dev)
+        return -EINVAL;
+
+    return dev->ops->write_poll(dev);
+}
+
+/**
+ * @brief   BSP 获取内部 Flash 几何信息（驱动初始化时读取容量寄存器和器件 ID）
+ * @param[in]  self 指向 BSP 对象的指针
+ * @param[out] info Flash 几何信息
+ * @return	0 表示成功，其他值表示失败
+ */
+static int bsp_flash_get_info_impl(bsp_flash_t *self, bsp_flash_info_t *info)
+{
+    flash_dev_t *dev = (flash_dev_t *)self->drv;
+    if (!dev || !dev->ops || !info)
+        return -EINVAL;
+
+    info->size      = dev->info.size;
+    info->page_size = dev->info.page_size;
+    info->dev_id    = dev->info.dev_id;
+    return 0;
+}
+
 /* --- 操作表 --- */
 static const bsp_flash_ops_t bsp_flash_ops = {
-    .init  = bsp_flash_init_impl,
-    .erase = bsp_flash_erase_impl,
-    .write = bsp_flash_write_impl
+    .init        = bsp_flash_init_impl,
+    .erase       = bsp_flash_erase_impl,
+    .write       = bsp_flash_write_impl,
+    .write_start = bsp_flash_write_start_impl,
+    .write_poll  = bsp_flash_write_poll_impl,
+    .get_info    = bsp_flash_get_info_impl
 };
 
 /* --- 单例对象 --- */
@@ -5,11 +5,21 @@
 
 typedef struct bsp_flash bsp_flash_t;
 
+/* 内部 Flash 几何信息 */
+typedef struct {
+    uint32_t size;          // Flash 总字节数
+    uint32_t page_size;     // 页字节数，F4 按扇区擦除，为 0
+    uint16_t dev_id;        // 器件 ID，读不到时为 0
+} bsp_flash_info_t;
+
 /* 操作接口 */
 typedef struct {
     int (*init)(bsp_flash_t *self);
     int (*erase)(bsp_flash_t *self, uint16_t cnt, uint16_t idx);
 	int (*write)(bsp_flash_t *self, uint32_t addr, uint32_t cnt, uint32_t *data);
+    int (*write_start)(bsp_flash_t *self, uint32_t addr, uint32_t cnt, const uint32_t *data);
+    int (*write_poll)(bsp_flash_t *self);
+    int (*get_info)(bsp_flash_t *self, bsp_flash_info_t *info);
 } bsp_flash_ops_t;
 
 /* 设备实例结构体 */
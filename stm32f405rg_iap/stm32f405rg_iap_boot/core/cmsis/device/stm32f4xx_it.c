@@ -29,6 +29,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f4xx_it.h"
+#include "drv_delay.h"
 //#include "main.h"
 
 /** @addtogroup Template_Project
@@ -139,10 +140,10 @@ void DebugMon_Handler(void)
   * @param  None
   * @retval None
   */
-//void SysTick_Handler(void)
-//{
-//  //TimingDelay_Decrement();
-//}
+DRV_RAMFUNC void SysTick_Handler(void)
+{
+  delay_tick_inc();
+}
 
 /******************************************************************************/
 /*                 STM32F4xx Peripherals Interrupt Handlers                   */
@@ -3,6 +3,16 @@
 
 #include <stdint.h>
 
+/* 放到 SRAM 中执行的函数，分散加载文件把 RAMCODE 段放到 RAM 执行域；未使用该分散加载文件的工程中仍在 Flash 中执行 */
+#ifndef DRV_RAMFUNC
+#define DRV_RAMFUNC __attribute__((section("RAMCODE")))
+#endif
+
+int delay_tick_init(void);
+void delay_tick_deinit(void);
+void delay_tick_inc(void);
+uint32_t delay_get_tick_ms(void);
+
 void delay_us(uint32_t us);
 void delay_ms(uint32_t ms);
 void delay_s(uint32_t s);
@@ -0,0 +1,1477 @@
+/*
+ * iap_uploader - BootLoader 上位机下载工具（Linux）
+ *
+ * 通过串口驱动 BootLoader 菜单，使用 Xmodem / Xmodem-1K / Ymodem / 流式传输协议下载固件，
+ * 或者读出 APP 区每个 1KB 块的 CRC，只发送与新固件不同的块（增量下载），
+ * 并统计各阶段耗时（擦除、传输、收尾）、吞吐量、重传次数和数据包往返延时。
+ * 串口只使用 termios 原始模式，也可以连接伪终端，配合主机上编译的 BootLoader 测试。
+ *
+ * 编译：gcc -O2 -Wall -o iap_uploader iap_uploader.c
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <libgen.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Xmodem/Ymodem 控制字符，与 boot_xmodem.h 一致 */
+#define XMODEM_SOH              0x01
+#define XMODEM_STX              0x02
+#define XMODEM_EOT              0x04
+#define XMODEM_ACK              0x06
+#define XMODEM_NAK              0x15
+#define XMODEM_CAN              0x18
+#define XMODEM_PAD              0x1A
+
+/* 流式传输协议，与 boot_stream.h 一致 */
+#define STREAM_SYNC0            0xA5
+#define STREAM_SYNC1            0x5A
+#define STREAM_HEADER_LEN       7
+#define STREAM_CRC_LEN          4
+#define STREAM_MAX_PAYLOAD      1024
+#define STREAM_MAX_WINDOW       32
+#define STREAM_PCRC_MAX_BLOCKS  32
+#define STREAM_PCRC_ENTRY_LEN   6
+#define STREAM_REPLY_MAX_LEN    (4 + STREAM_PCRC_MAX_BLOCKS * STREAM_PCRC_ENTRY_LEN)
+
+#define STREAM_TYPE_START       0x01
+#define STREAM_TYPE_DATA        0x02
+#define STREAM_TYPE_END         0x03
+#define STREAM_TYPE_ABORT       0x04
+#define STREAM_TYPE_PCRC        0x05
+#define STREAM_TYPE_DELTA       0x06
+#define STREAM_TYPE_WRITE       0x07
+#define STREAM_TYPE_RESUME      0x08
+#define STREAM_TYPE_ACK         0x80
+#define STREAM_TYPE_START_ACK   0x81
+#define STREAM_TYPE_END_ACK     0x82
+#define STREAM_TYPE_PCRC_ACK    0x83
+#define STREAM_TYPE_WRITE_ACK   0x84
+#define STREAM_TYPE_RESUME_ACK  0x85
+
+/* BootLoader 菜单按键，与 boot_cmd.c 中 menu_items 的顺序一致（第 10 项起为字母） */
+#define MENU_XMODEM_INT         '2'
+#define MENU_XMODEM_EXT         '3'
+#define MENU_YMODEM_INT         '8'
+#define MENU_YMODEM_EXT         '9'
+#define MENU_STREAM_INT         'a'
+#define MENU_STREAM_EXT         'b'
+#define MENU_SWITCH_BAUD        'c'
+
+#define BAUD_SYNC_STR           "SYNC"  // 与 boot_baud.h 中 BOOT_BAUD_SYNC_STR 一致
+#define BAUD_CONFIRM_TIMEOUT_MS 2000    // 与 BOOT_BAUD_CONFIRM_TIMEOUT_MS 一致
+
+#define MAX_RETRY               10      // 单个数据包最大重传次数
+#define CMD_GAP_MS              50      // 两次输入之间的间隔，BootLoader 按串口空闲中断分段
+#define READY_TIMEOUT_MS        60000   // 等待擦除完成（'C' 或 START_ACK）的超时时间
+#define ACK_TIMEOUT_MS          2000    // 等待数据包应答的超时时间
+#define FINISH_TIMEOUT_MS       10000   // 等待 EOT / END 应答的超时时间
+
+typedef enum {
+    PROTO_XMODEM,       // Xmodem-CRC，128 字节数据包
+    PROTO_XMODEM_1K,    // Xmodem-1K，1024 字节数据包
+    PROTO_YMODEM,       // Ymodem 批量传输
+    PROTO_STREAM,       // 滑动窗口流式传输
+    PROTO_DELTA,        // 增量下载，只写入与 APP 区现有内容不同的块
+} proto_t;
+
+/* 一次下载的统计数据 */
+typedef struct {
+    double   erase_ms;          // 发出命令到 BootLoader 可以接收数据（擦除 + 握手）
+    double   transfer_ms;       // 第一个数据包发出到最后一个数据包被确认
+    double   finalize_ms;       // EOT / END 发出到收到最终应答
+    uint64_t bytes;             // 固件字节数
+    uint32_t packets;           // 发送的数据包个数（不含重传）
+    uint32_t unchanged;         // 增量下载中与 APP 区内容相同、未发送的块数
+    uint32_t retransmits;       // 重传的数据包个数
+    uint32_t timeouts;          // 等待应答超时次数
+    uint32_t baudrate;          // 传输阶段的波特率
+    uint32_t rtt_cnt;           // 往返延时采样次数
+    double   rtt_min_ms;
+    double   rtt_max_ms;
+    double   rtt_sum_ms;
+} stats_t;
+
+typedef struct {
+    int      fd;
+    uint32_t baudrate;
+    bool     verbose;
+    uint8_t  rx_buf[4096];      // 串口接收缓存
+    size_t   rx_head;
+    size_t   rx_tail;
+    int      last_byte;         // 上一个收到的字节，用于从日志文本中区分 'C'
+} port_t;
+
+static port_t port = { .fd = -1, .last_byte = -1 };
+static stats_t stats;
+
+/**
+ * @brief   获取单调时钟时间
+ * @return  毫秒
+ */
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void sleep_ms(uint32_t ms)
+{
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief   记录一次数据包往返延时
+ * @param[in] ms 延时
+ */
+static void stats_add_rtt(double ms)
+{
+    if (!stats.rtt_cnt || ms < stats.rtt_min_ms)
+        stats.rtt_min_ms = ms;
+    if (!stats.rtt_cnt || ms > stats.rtt_max_ms)
+        stats.rtt_max_ms = ms;
+    stats.rtt_sum_ms += ms;
+    stats.rtt_cnt++;
+}
+
+/**
+ * @brief   CRC16/XMODEM，与 boot_crc16 一致
+ */
+static uint16_t crc16(const uint8_t *data, uint32_t len)
+{
+    uint16_t crc = 0;
+    uint8_t i;
+
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (i = 0; i < 8; i++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+/**
+ * @brief   CRC32/MPEG-2，与 boot_crc32 一致
+ */
+static uint32_t crc32_mpeg2(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+    uint8_t i;
+
+    while (len--) {
+        crc ^= (uint32_t)(*data++) << 24;
+        for (i = 0; i < 8; i++)
+            crc = (crc & 0x80000000UL) ? (crc << 1) ^ 0x04C11DB7UL : crc << 1;
+    }
+    return crc;
+}
+
+/**
+ * @brief   整个固件的 CRC32，与 STM32 CRC 单元和 boot_crc32_word 一致：
+ *          逐个小端 32 位字从最高位开始计算，尾部不足一个字补 0xFF
+ */
+static uint32_t crc32_image(const uint8_t *data, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    uint32_t word;
+    uint32_t i, j;
+    uint8_t b;
+
+    for (i = 0; i < len; i += 4) {
+        word = 0;
+        for (j = 0; j < 4; j++)
+            word |= (uint32_t)(i + j < len ? data[i + j] : 0xFF) << (8 * j);
+        crc ^= word;
+        for (b = 0; b < 32; b++)
+            crc = (crc & 0x80000000UL) ? (crc << 1) ^ 0x04C11DB7UL : crc << 1;
+    }
+    return crc;
+}
+
+static speed_t baud_to_speed(uint32_t baudrate)
+{
+    switch (baudrate) {
+    case 9600:    return B9600;
+    case 19200:   return B19200;
+    case 38400:   return B38400;
+    case 57600:   return B57600;
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+    case 460800:  return B460800;
+    case 921600:  return B921600;
+    case 1000000: return B1000000;
+    case 2000000: return B2000000;
+    default:      return 0;
+    }
+}
+
+/**
+ * @brief   修改本地串口波特率
+ * @return  0 表示成功，-1 表示失败
+ */
+static int port_set_baudrate(uint32_t baudrate)
+{
+    struct termios tio;
+    speed_t speed = baud_to_speed(baudrate);
+
+    if (!speed) {
+        fprintf(stderr, "unsupported baudrate %u\n", baudrate);
+        return -1;
+    }
+
+    port.baudrate = baudrate;
+    if (tcgetattr(port.fd, &tio) != 0)
+        return 0;   // 伪终端以外的非终端设备，没有波特率
+    tcdrain(port.fd);
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    return tcsetattr(port.fd, TCSANOW, &tio) ? -1 : 0;
+}
+
+/**
+ * @brief   打开串口并设置为原始模式
+ * @details 伪终端同样支持 termios，设置失败时（如普通文件）只给出警告
+ * @param[in] path     设备路径
+ * @param[in] baudrate 波特率
+ * @return  0 表示成功，-1 表示失败
+ */
+static int port_open(const char *path, uint32_t baudrate)
+{
+    struct termios tio;
+    speed_t speed = baud_to_speed(baudrate);
+
+    if (!speed) {
+        fprintf(stderr, "unsupported baudrate %u\n", baudrate);
+        return -1;
+    }
+
+    port.fd = open(path, O_RDWR | O_NOCTTY);
+    if (port.fd < 0) {
+        fprintf(stderr, "open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    port.baudrate = baudrate;
+
+    if (tcgetattr(port.fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+        tio.c_cc[VMIN]  = 0;
+        tio.c_cc[VTIME] = 0;
+        if (tcsetattr(port.fd, TCSANOW, &tio) != 0)
+            fprintf(stderr, "warning: tcsetattr %s: %s\n", path, strerror(errno));
+        tcflush(port.fd, TCIOFLUSH);
+    } else {
+        fprintf(stderr, "warning: %s is not a terminal\n", path);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   发送数据，等待全部写出
+ * @return  0 表示成功，-1 表示失败
+ */
+static int port_write(const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    ssize_t n;
+
+    while (len) {
+        n = write(port.fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            fprintf(stderr, "write: %s\n", strerror(errno));
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    tcdrain(port.fd);
+    return 0;
+}
+
+/**
+ * @brief   读取一个字节
+ * @param[in] timeout_ms 超时时间
+ * @return  0-255 表示收到的字节，-1 表示超时，-2 表示串口错误
+ */
+static int port_read_byte(int timeout_ms)
+{
+    struct pollfd pfd = { .fd = port.fd, .events = POLLIN };
+    double deadline = now_ms() + timeout_ms;
+    ssize_t n;
+    int left;
+
+    while (port.rx_head == port.rx_tail) {
+        left = (int)(deadline - now_ms());
+        if (left < 0)
+            return -1;
+        if (poll(&pfd, 1, left) < 0) {
+            if (errno == EINTR)
+                continue;
+            return -2;
+        }
+        if (pfd.revents & (POLLERR | POLLNVAL))
+            return -2;
+        if (!(pfd.revents & (POLLIN | POLLHUP)))
+            continue;
+        n = read(port.fd, port.rx_buf, sizeof(port.rx_buf));
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            return -2;
+        }
+        if (n == 0) {
+            /* 伪终端对端尚未打开时 POLLHUP 会一直置位，避免空转 */
+            sleep_ms(1);
+            continue;
+        }
+        port.rx_head = n;
+        port.rx_tail = 0;
+    }
+
+    port.last_byte = port.rx_buf[port.rx_tail++];
+    return port.last_byte;
+}
+
+/**
+ * @brief   丢弃串口中已收到的数据
+ */
+static void port_flush_input(void)
+{
+    while (port_read_byte(0) >= 0) {
+    }
+}
+
+/**
+ * @brief   打印 BootLoader 输出的日志字符（-v 时）
+ */
+static void echo_byte(int ch)
+{
+    if (!port.verbose || ch < 0)
+        return;
+    if (isprint(ch) || ch == '\n' || ch == '\r' || ch == '\t')
+        fputc(ch, stderr);
+}
+
+/**
+ * @brief   向 BootLoader 发送一段输入
+ * @details BootLoader 以串口空闲中断分段，输入前后留出间隔，避免与其他输入合并到一段
+ */
+static int send_input(const char *buf, int len)
+{
+    sleep_ms(CMD_GAP_MS);
+    if (port_write(buf, len))
+        return -1;
+    sleep_ms(CMD_GAP_MS);
+    return 0;
+}
+
+/**
+ * @brief   发送一个菜单按键
+ * @param[in] key 菜单按键
+ */
+static int send_menu(char key)
+{
+    return send_input(&key, 1);
+}
+
+/**
+ * @brief   发送一条数字输入（如槽位号）
+ * @param[in] num 数字
+ */
+static int send_cmd(uint32_t num)
+{
+    char buf[16];
+    int len = snprintf(buf, sizeof(buf), "%u", num);
+
+    return send_input(buf, len);
+}
+
+/**
+ * @brief   等待 BootLoader 输出指定的文本
+ * @param[in] text       要查找的文本
+ * @param[in] timeout_ms 超时时间
+ * @return  0 表示找到，-ETIMEDOUT 表示超时
+ */
+static int wait_text(const char *text, int timeout_ms)
+{
+    double deadline = now_ms() + timeout_ms;
+    size_t matched = 0, len = strlen(text);
+    int ch;
+
+    while (now_ms() < deadline) {
+        ch = port_read_byte((int)(deadline - now_ms()) + 1);
+        if (ch < 0)
+            break;
+        echo_byte(ch);
+        if (ch == text[matched])
+            matched++;
+        else
+            matched = (ch == text[0]) ? 1 : 0;
+        if (matched == len)
+            return 0;
+    }
+    return -ETIMEDOUT;
+}
+
+/**
+ * @brief   通过菜单把传输阶段的波特率切换到 baudrate
+ * @details BootLoader 在旧波特率下回复提示后切换，上位机随后切换本地波特率并发送确认字符串。
+ *          未收到确认时 BootLoader 超时后恢复默认波特率，上位机同样恢复，下载以默认波特率继续。
+ * @param[in] baudrate 传输阶段的波特率
+ * @return  0 表示已切换，-1 表示已回退到默认波特率
+ */
+static int switch_baudrate(uint32_t baudrate)
+{
+    uint32_t base = port.baudrate;
+    char buf[16];
+    int len = snprintf(buf, sizeof(buf), "%u", baudrate);
+
+    if (send_menu(MENU_SWITCH_BAUD))
+        return -1;
+    if (port_write(buf, len) || wait_text("to confirm.", 1000)) {
+        fprintf(stderr, "target does not support switching to %u baud\n", baudrate);
+        return -1;
+    }
+    wait_text("\n", 100);     // 提示行发送完成后 BootLoader 才切换
+
+    if (port_set_baudrate(baudrate) == 0) {
+        sleep_ms(CMD_GAP_MS);
+        port_flush_input();
+        if (port_write(BAUD_SYNC_STR, strlen(BAUD_SYNC_STR)) == 0 &&
+            wait_text("confirmed", BAUD_CONFIRM_TIMEOUT_MS) == 0) {
+            sleep_ms(CMD_GAP_MS);
+            port_flush_input();    // 丢弃确认后打印的菜单
+            return 0;
+        }
+    }
+
+    fprintf(stderr, "baud rate switch not confirmed, falling back to %u\n", base);
+    port_set_baudrate(base);
+    sleep_ms(BAUD_CONFIRM_TIMEOUT_MS);
+    port_flush_input();
+    return -1;
+}
+
+/**
+ * @brief   等待接收端发出的 'C'
+ * @details BootLoader 的日志与协议共用串口，只把前后都不是字母数字的 'C' 当作握手字符
+ * @param[in] timeout_ms 超时时间
+ * @return  0 表示收到 'C'，-ETIMEDOUT 表示超时，-ECANCELED 表示收到 CAN
+ */
+static int wait_c(int timeout_ms)
+{
+    double deadline = now_ms() + timeout_ms;
+    int prev, ch, next;
+
+    while (now_ms() < deadline) {
+        prev = port.last_byte;
+        ch = port_read_byte((int)(deadline - now_ms()) + 1);
+        if (ch < 0)
+            return -ETIMEDOUT;
+        if (ch == XMODEM_CAN)
+            return -ECANCELED;
+        if (ch != 'C' || (prev >= 0 && isalnum(prev))) {
+            echo_byte(ch);
+            continue;
+        }
+
+        /* 'C' 之后紧跟字母数字说明是日志文本 */
+        next = port_read_byte(20);
+        if (next < 0 || !isalnum(next))
+            return 0;
+        echo_byte(ch);
+        echo_byte(next);
+    }
+    return -ETIMEDOUT;
+}
+
+/**
+ * @brief   等待 ACK / NAK / CAN，忽略其他字符（日志、多余的 'C'）
+ * @param[in] timeout_ms 超时时间
+ * @return  收到的控制字符，-1 表示超时
+ */
+static int wait_ack(int timeout_ms)
+{
+    double deadline = now_ms() + timeout_ms;
+    int ch;
+
+    while (now_ms() < deadline) {
+        ch = port_read_byte((int)(deadline - now_ms()) + 1);
+        if (ch < 0)
+            return -1;
+        if (ch == XMODEM_ACK || ch == XMODEM_NAK || ch == XMODEM_CAN)
+            return ch;
+        echo_byte(ch);
+    }
+    return -1;
+}
+
+/**
+ * @brief   发送一个 Xmodem/Ymodem 数据包并等待 ACK，NAK 或超时时重发
+ * @param[in] seq  包序号
+ * @param[in] data 有效数据
+ * @param[in] len  有效数据长度，不足 pkt_size 时补 0x1A
+ * @param[in] pkt_size 128 或 1024
+ * @return  0 表示成功，负值表示失败
+ */
+static int xmodem_send_packet(uint8_t seq, const uint8_t *data, uint32_t len, uint32_t pkt_size)
+{
+    uint8_t pkt[3 + 1024 + 2];
+    uint16_t crc;
+    double t0;
+    int retry, ch;
+
+    pkt[0] = (pkt_size == 1024) ? XMODEM_STX : XMODEM_SOH;
+    pkt[1] = seq;
+    pkt[2] = ~seq;
+    memcpy(&pkt[3], data, len);
+    memset(&pkt[3 + len], XMODEM_PAD, pkt_size - len);
+    crc = crc16(&pkt[3], pkt_size);
+    pkt[3 + pkt_size] = crc >> 8;
+    pkt[3 + pkt_size + 1] = crc & 0xFF;
+
+    stats.packets++;
+    for (retry = 0; retry < MAX_RETRY; retry++) {
+        if (retry)
+            stats.retransmits++;
+
+        t0 = now_ms();
+        if (port_write(pkt, 3 + pkt_size + 2))
+            return -EIO;
+
+        ch = wait_ack(ACK_TIMEOUT_MS);
+        if (ch == XMODEM_ACK) {
+            stats_add_rtt(now_ms() - t0);
+            return 0;
+        }
+        if (ch == XMODEM_CAN) {
+            fprintf(stderr, "\ntransfer cancelled by target (block %u)\n", seq);
+            return -ECANCELED;
+        }
+        if (ch < 0)
+            stats.timeouts++;
+    }
+
+    fprintf(stderr, "\nblock %u: too many retries\n", seq);
+    return -ETIMEDOUT;
+}
+
+/**
+ * @brief   发送 EOT 直到收到 ACK（接收端第一个 EOT 回 NAK）
+ * @return  0 表示成功，负值表示失败
+ */
+static int xmodem_send_eot(void)
+{
+    uint8_t eot = XMODEM_EOT;
+    int retry, ch;
+
+    for (retry = 0; retry < MAX_RETRY; retry++) {
+        if (port_write(&eot, 1))
+            return -EIO;
+        ch = wait_ack(FINISH_TIMEOUT_MS);
+        if (ch == XMODEM_ACK)
+            return 0;
+        if (ch == XMODEM_CAN)
+            return -ECANCELED;
+        if (ch < 0)
+            stats.timeouts++;
+    }
+    return -ETIMEDOUT;
+}
+
+/**
+ * @brief   打印进度
+ */
+static void show_progress(uint64_t done, uint64_t total)
+{
+    if (!isatty(STDOUT_FILENO))
+        return;
+    printf("\r  %llu / %llu bytes (%3u%%)", (unsigned long long)done, (unsigned long long)total,
+           total ? (unsigned)(done * 100 / total) : 100);
+    fflush(stdout);
+    if (done == total)
+        printf("\n");
+}
+
+/**
+ * @brief   发送固件数据（Xmodem/Ymodem 数据包，序号从 1 开始）
+ * @return  0 表示成功，负值表示失败
+ */
+static int xmodem_send_data(const uint8_t *data, uint32_t size, uint32_t pkt_size)
+{
+    uint32_t offset, len;
+    uint8_t seq = 1;
+    int ret;
+
+    for (offset = 0; offset < size; offset += len, seq++) {
+        len = size - offset;
+        if (len > pkt_size)
+            len = pkt_size;
+        ret = xmodem_send_packet(seq, &data[offset], len, pkt_size);
+        if (ret)
+            return ret;
+        show_progress(offset + len, size);
+    }
+    return 0;
+}
+
+/**
+ * @brief   Xmodem / Xmodem-1K 下载一个文件
+ * @param[in] t_start 发出菜单命令的时间，用于统计擦除阶段耗时
+ * @return  0 表示成功，负值表示失败
+ */
+static int upload_xmodem(const uint8_t *data, uint32_t size, uint32_t pkt_size, double t_start)
+{
+    double t;
+    int ret;
+
+    ret = wait_c(READY_TIMEOUT_MS);
+    if (ret) {
+        fprintf(stderr, "target not ready (no 'C' received)\n");
+        return ret;
+    }
+    t = now_ms();
+    stats.erase_ms += t - t_start;
+
+    ret = xmodem_send_data(data, size, pkt_size);
+    stats.transfer_ms += now_ms() - t;
+    if (ret)
+        return ret;
+
+    t = now_ms();
+    ret = xmodem_send_eot();
+    stats.finalize_ms += now_ms() - t;
+    stats.bytes += size;
+    return ret;
+}
+
+/**
+ * @brief   发送 Ymodem 0 号包（文件头），文件名为空表示批量传输结束
+ * @return  0 表示成功，负值表示失败
+ */
+static int ymodem_send_header(const char *name, uint32_t size)
+{
+    uint8_t hdr[1024];
+    uint32_t len = 0;
+    uint32_t pkt_size;
+
+    memset(hdr, 0, sizeof(hdr));
+    if (name) {
+        len = snprintf((char *)hdr, sizeof(hdr) - 16, "%s", name) + 1;
+        len += snprintf((char *)&hdr[len], 16, "%u", size) + 1;
+    }
+    pkt_size = (len > 128) ? 1024 : 128;
+
+    /* 文件头需要补 0 而不是 0x1A */
+    return xmodem_send_packet(0, hdr, pkt_size, pkt_size);
+}
+
+/**
+ * @brief   Ymodem 批量下载，多个文件写入外部 Flash 的连续槽位
+ * @return  0 表示成功，负值表示失败
+ */
+static int upload_ymodem(char **files, uint8_t **images, uint32_t *sizes, int file_num, double t_start)
+{
+    double t;
+    int i, ret;
+
+    for (i = 0; i < file_num; i++) {
+        ret = wait_c(READY_TIMEOUT_MS);
+        if (ret)
+            return ret;
+
+        /* 擦除阶段：菜单命令 / 上一个文件结束 -> 文件头应答后的 'C'（外部 Flash 在此期间按大小擦除） */
+        if (i)
+            t_start = now_ms();
+        ret = ymodem_send_header(basename(files[i]), sizes[i]);
+        if (ret)
+            return ret;
+        ret = wait_c(READY_TIMEOUT_MS);
+        if (ret)
+            return ret;
+        t = now_ms();
+        stats.erase_ms += t - t_start;
+
+        printf("  file %d: %s (%u bytes)\n", i + 1, files[i], sizes[i]);
+        ret = xmodem_send_data(images[i], sizes[i], 1024);
+        stats.transfer_ms += now_ms() - t;
+        if (ret)
+            return ret;
+
+        t = now_ms();
+        ret = xmodem_send_eot();
+        stats.finalize_ms += now_ms() - t;
+        if (ret)
+            return ret;
+        stats.bytes += sizes[i];
+    }
+
+    /* 空文件头结束批量传输 */
+    ret = wait_c(READY_TIMEOUT_MS);
+    if (ret)
+        return ret;
+    return ymodem_send_header(NULL, 0);
+}
+
+/**
+ * @brief   组一帧流式传输协议数据
+ * @param[out] frame 帧缓冲区，至少 STREAM_HEADER_LEN + len + STREAM_CRC_LEN 字节
+ * @return  帧长度
+ */
+static int stream_build_frame(uint8_t *frame, uint8_t type, uint16_t seq, const uint8_t *payload, uint16_t len)
+{
+    uint32_t crc;
+
+    frame[0] = STREAM_SYNC0;
+    frame[1] = STREAM_SYNC1;
+    frame[2] = type;
+    frame[3] = seq;
+    frame[4] = seq >> 8;
+    frame[5] = len;
+    frame[6] = len >> 8;
+    if (len)
+        memcpy(&frame[STREAM_HEADER_LEN], payload, len);
+    crc = crc32_mpeg2(0xFFFFFFFF, &frame[2], STREAM_HEADER_LEN - 2 + len);
+    frame[STREAM_HEADER_LEN + len]     = crc;
+    frame[STREAM_HEADER_LEN + len + 1] = crc >> 8;
+    frame[STREAM_HEADER_LEN + len + 2] = crc >> 16;
+    frame[STREAM_HEADER_LEN + len + 3] = crc >> 24;
+    return STREAM_HEADER_LEN + len + STREAM_CRC_LEN;
+}
+
+/**
+ * @brief   发送一帧流式传输协议数据
+ * @return  0 表示成功，负值表示失败
+ */
+static int stream_send_frame(uint8_t type, uint16_t seq, const uint8_t *payload, uint16_t len)
+{
+    uint8_t frame[STREAM_HEADER_LEN + 4 + STREAM_MAX_PAYLOAD + STREAM_CRC_LEN];
+
+    return port_write(frame, stream_build_frame(frame, type, seq, payload, len)) ? -EIO : 0;
+}
+
+/**
+ * @brief   接收一帧应答，跳过日志和损坏的帧
+ * @param[out] type    帧类型
+ * @param[out] seq     序号
+ * @param[out] payload 有效数据
+ * @param[in]  max_len payload 缓冲区字节数，更长的帧丢弃
+ * @param[in]  timeout_ms 超时时间
+ * @return  有效数据长度，-1 表示超时
+ */
+static int stream_recv_frame(uint8_t *type, uint16_t *seq, uint8_t *payload, uint16_t max_len, int timeout_ms)
+{
+    double deadline = now_ms() + timeout_ms;
+    uint8_t frame[STREAM_HEADER_LEN + STREAM_REPLY_MAX_LEN + STREAM_CRC_LEN];
+    uint32_t crc, recv_crc;
+    uint16_t len;
+    int ch, i;
+
+    while (now_ms() < deadline) {
+        ch = port_read_byte((int)(deadline - now_ms()) + 1);
+        if (ch < 0)
+            return -1;
+        if (ch != STREAM_SYNC0) {
+            echo_byte(ch);
+            continue;
+        }
+        ch = port_read_byte(100);
+        if (ch != STREAM_SYNC1)
+            continue;
+
+        frame[0] = STREAM_SYNC0;
+        frame[1] = STREAM_SYNC1;
+        for (i = 2; i < STREAM_HEADER_LEN; i++) {
+            if ((ch = port_read_byte(100)) < 0)
+                break;
+            frame[i] = ch;
+        }
+        if (ch < 0)
+            continue;
+
+        len = frame[5] | (frame[6] << 8);
+        if (len > max_len || len > STREAM_REPLY_MAX_LEN)
+            continue;
+        for (i = STREAM_HEADER_LEN; i < STREAM_HEADER_LEN + len + STREAM_CRC_LEN; i++) {
+            if ((ch = port_read_byte(100)) < 0)
+                break;
+            frame[i] = ch;
+        }
+        if (ch < 0)
+            continue;
+
+        crc = crc32_mpeg2(0xFFFFFFFF, &frame[2], STREAM_HEADER_LEN - 2 + len);
+        recv_crc = frame[STREAM_HEADER_LEN + len] | (frame[STREAM_HEADER_LEN + len + 1] << 8) |
+                   (frame[STREAM_HEADER_LEN + len + 2] << 16) |
+                   ((uint32_t)frame[STREAM_HEADER_LEN + len + 3] << 24);
+        if (crc != recv_crc)
+            continue;
+
+        *type = frame[2];
+        *seq  = frame[3] | (frame[4] << 8);
+        memcpy(payload, &frame[STREAM_HEADER_LEN], len);
+        return len;
+    }
+    return -1;
+}
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_le32(uint8_t *p, uint32_t val)
+{
+    p[0] = val;
+    p[1] = val >> 8;
+    p[2] = val >> 16;
+    p[3] = val >> 24;
+}
+
+/**
+ * @brief   填写 START / RESUME / DELTA 的 payload：固件总字节数(4) + 整个固件的 CRC32(4)
+ */
+static void stream_put_image_info(uint8_t *payload, const uint8_t *data, uint32_t size)
+{
+    put_le32(payload, size);
+    put_le32(&payload[4], crc32_image(data, size));
+}
+
+/**
+ * @brief   发送 END，等待 BootLoader 写完剩余数据并回复 END_ACK
+ * @return  0 表示成功，负值表示失败
+ */
+static int stream_finish(void)
+{
+    uint8_t payload[8], type;
+    uint16_t ack_seq;
+    int32_t status;
+    double t = now_ms();
+    int retry, n;
+
+    for (retry = 0; retry < MAX_RETRY; retry++) {
+        if (stream_send_frame(STREAM_TYPE_END, 0, NULL, 0))
+            return -EIO;
+        n = stream_recv_frame(&type, &ack_seq, payload, sizeof(payload), FINISH_TIMEOUT_MS);
+        if (n == 4 && type == STREAM_TYPE_END_ACK)
+            break;
+        if (n < 0)
+            stats.timeouts++;
+    }
+    stats.finalize_ms += now_ms() - t;
+    if (retry == MAX_RETRY) {
+        fprintf(stderr, "no END_ACK from target\n");
+        return -ETIMEDOUT;
+    }
+
+    status = (int32_t)get_le32(payload);
+    if (status) {
+        fprintf(stderr, "target failed to finish (err=%d)\n", status);
+        return status;
+    }
+    return 0;
+}
+
+/**
+ * @brief   发送 RESUME，询问 BootLoader 中是否有本固件的下载断点
+ * @details BootLoader 回复已写入的块数和这些块的 CRC，与本地固件的前几块一致才从断点继续
+ * @param[out] payload RESUME_ACK 的前 8 字节（与 START_ACK 相同），成功时用来解析窗口参数
+ * @return  从断点继续时返回已写入的块数，0 表示没有可用的断点（改用 START），负值表示失败
+ */
+static int stream_resume(const uint8_t *data, uint32_t size, uint8_t *payload)
+{
+    uint8_t reply[16], type;
+    uint32_t chunk_cnt, crc;
+    uint16_t ack_seq;
+    int32_t status;
+    int retry, n;
+
+    stream_put_image_info(reply, data, size);
+    for (retry = 0; retry < MAX_RETRY; retry++) {
+        if (stream_send_frame(STREAM_TYPE_RESUME, 0, reply, 8))
+            return -EIO;
+        n = stream_recv_frame(&type, &ack_seq, reply, sizeof(reply), READY_TIMEOUT_MS / MAX_RETRY);
+        if (n == 16 && type == STREAM_TYPE_RESUME_ACK)
+            break;
+        if (n < 0)
+            stats.timeouts++;
+        stream_put_image_info(reply, data, size);
+    }
+    if (retry == MAX_RETRY) {
+        fprintf(stderr, "no RESUME_ACK from target\n");
+        return -ETIMEDOUT;
+    }
+
+    status = (int32_t)get_le32(&reply[4]);
+    chunk_cnt = get_le32(&reply[8]);
+    crc = get_le32(&reply[12]);
+    if (status) {
+        printf("  no resume point on target (err=%d), starting over\n", status);
+        return 0;
+    }
+    if ((uint64_t)chunk_cnt * STREAM_MAX_PAYLOAD >= size ||
+        crc32_mpeg2(0xFFFFFFFF, data, chunk_cnt * STREAM_MAX_PAYLOAD) != crc) {
+        printf("  resume point does not match this image, starting over\n");
+        return 0;
+    }
+
+    memcpy(payload, reply, 8);
+    printf("  resume from block %u of %u\n", chunk_cnt, (size + STREAM_MAX_PAYLOAD - 1) / STREAM_MAX_PAYLOAD);
+    return chunk_cnt;
+}
+
+/**
+ * @brief   流式传输协议下载一个文件
+ * @details 一个窗口的 DATA 帧一次写出，BootLoader 在串口空闲后对整段回复一个 ACK。
+ *          根据 ACK 的累计确认和 SACK 位图只重发缺失的帧，超时则重发窗口内所有未确认的帧。
+ *          resume 为 true 时先尝试从 BootLoader 记录的断点继续，没有可用的断点再发 START。
+ * @return  0 表示成功，负值表示失败
+ */
+static int upload_stream(const uint8_t *data, uint32_t size, bool resume, double t_start)
+{
+    static uint8_t batch[STREAM_MAX_WINDOW * (STREAM_HEADER_LEN + STREAM_MAX_PAYLOAD + STREAM_CRC_LEN)];
+    uint8_t payload[8], type;
+    uint32_t frame_cnt = (size + STREAM_MAX_PAYLOAD - 1) / STREAM_MAX_PAYLOAD;
+    uint32_t base = 0;          // 已累计确认的块数
+    uint32_t next_new = 0;      // 下一个从未发送过的块
+    uint32_t resumed = 0;       // 从断点继续时已写入的块数
+    uint32_t sack = 0;          // bit i 表示块 base + i 已收到
+    uint32_t window = 1;
+    uint32_t i, seq, len, batch_len;
+    uint16_t ack_seq;
+    int32_t status;
+    double t, t_batch;
+    int retry, n;
+
+    if (size == 0 || frame_cnt > 0x10000)
+        return -EINVAL;
+
+    /* RESUME：从断点继续时不再擦除，窗口从已写入的块开始 */
+    if (resume) {
+        n = stream_resume(data, size, payload);
+        if (n < 0)
+            return n;
+        base = next_new = resumed = n;
+    }
+
+    /* START：外部 Flash 在回复 START_ACK 前按固件大小擦除 */
+    for (retry = 0; base == 0 && retry < MAX_RETRY; retry++) {
+        stream_put_image_info(payload, data, size);
+        if (stream_send_frame(STREAM_TYPE_START, 0, payload, 8))
+            return -EIO;
+        n = stream_recv_frame(&type, &ack_seq, payload, sizeof(payload), READY_TIMEOUT_MS / MAX_RETRY);
+        if (n == 8 && type == STREAM_TYPE_START_ACK)
+            break;
+        if (n < 0)
+            stats.timeouts++;
+    }
+    if (retry == MAX_RETRY) {
+        fprintf(stderr, "no START_ACK from target\n");
+        return -ETIMEDOUT;
+    }
+    status = (int32_t)get_le32(&payload[4]);
+    if (status) {
+        fprintf(stderr, "target rejected START (err=%d)\n", status);
+        return status;
+    }
+    window = payload[0] | (payload[1] << 8);
+    if (window < 1 || window > STREAM_MAX_WINDOW)
+        window = 1;
+    if ((uint32_t)(payload[2] | (payload[3] << 8)) != STREAM_MAX_PAYLOAD) {
+        fprintf(stderr, "unsupported max payload %u\n", payload[2] | (payload[3] << 8));
+        return -EPROTO;
+    }
+
+    t = now_ms();
+    stats.erase_ms += t - t_start;
+    printf("  window %u frame(s) of %u bytes\n", window, STREAM_MAX_PAYLOAD);
+
+    retry = 0;
+    while (base < frame_cnt) {
+        /* 组帧：窗口内未确认的块，已发送过的算作重传 */
+        batch_len = 0;
+        for (i = 0; i < window && base + i < frame_cnt; i++) {
+            if (sack & (1UL << i))
+                continue;
+            seq = base + i;
+            if (seq >= next_new) {
+                next_new = seq + 1;
+                stats.packets++;
+            } else {
+                stats.retransmits++;
+            }
+            len = size - seq * STREAM_MAX_PAYLOAD;
+            if (len > STREAM_MAX_PAYLOAD)
+                len = STREAM_MAX_PAYLOAD;
+            batch_len += stream_build_frame(&batch[batch_len], STREAM_TYPE_DATA, seq,
+                                            &data[seq * STREAM_MAX_PAYLOAD], len);
+        }
+        t_batch = now_ms();
+        if (port_write(batch, batch_len))
+            return -EIO;
+
+        /* 等待本段的 ACK */
+        n = stream_recv_frame(&type, &ack_seq, payload, sizeof(payload), ACK_TIMEOUT_MS);
+        if (n < 0) {
+            stats.timeouts++;
+            if (++retry >= MAX_RETRY) {
+                fprintf(stderr, "\nno ACK from target at frame %u\n", base);
+                return -ETIMEDOUT;
+            }
+            continue;
+        }
+        if (type != STREAM_TYPE_ACK || n != 8)
+            continue;
+        retry = 0;
+
+        status = (int32_t)get_le32(&payload[4]);
+        if (status) {
+            fprintf(stderr, "\ntarget failed to program Flash (err=%d)\n", status);
+            return status;
+        }
+
+        /* 往返延时：一段 DATA 帧写出到收到推进窗口的 ACK */
+        if (ack_seq > base)
+            stats_add_rtt(now_ms() - t_batch);
+
+        if (ack_seq >= base && ack_seq <= frame_cnt) {
+            base = ack_seq;
+            sack = get_le32(payload);
+        }
+        show_progress((uint64_t)(base < frame_cnt ? base * STREAM_MAX_PAYLOAD : size), size);
+    }
+    stats.transfer_ms += now_ms() - t;
+
+    status = stream_finish();
+    if (status)
+        return status;
+    stats.bytes += size - resumed * STREAM_MAX_PAYLOAD;
+    return 0;
+}
+
+/**
+ * @brief   增量下载：读出 APP 区每块的 CRC，只发送与新固件不同的块
+ * @details 块大小与 DATA 帧相同。BootLoader 在第一次写入某个页/扇区时整体擦除，
+ *          所以一个块有变化时，同一页/扇区内新固件范围内的块全部重发。
+ *          最后一块不足 1KB 时 Flash 中的 CRC 覆盖整块，总是重发。
+ *          WRITE 帧停等发送，BootLoader 写入并回读校验后回复 WRITE_ACK。
+ * @return  0 表示成功，负值表示失败
+ */
+static int upload_delta(const uint8_t *data, uint32_t size, double t_start)
+{
+    uint8_t payload[STREAM_REPLY_MAX_LEN], type;
+    uint8_t frame[4 + STREAM_MAX_PAYLOAD];
+    uint32_t frame_cnt = (size + STREAM_MAX_PAYLOAD - 1) / STREAM_MAX_PAYLOAD;
+    uint32_t i, j, len, cnt, todo = 0, done = 0;
+    uint16_t *unit;
+    bool *dirty;
+    uint16_t ack_seq;
+    int32_t status;
+    double t, t_pkt;
+    int retry, n;
+
+    if (size == 0 || frame_cnt > 0x10000)
+        return -EINVAL;
+
+    /* DELTA：开始增量会话，不擦除 */
+    stream_put_image_info(payload, data, size);
+    for (retry = 0; retry < MAX_RETRY; retry++) {
+        if (stream_send_frame(STREAM_TYPE_DELTA, 0, payload, 8))
+            return -EIO;
+        n = stream_recv_frame(&type, &ack_seq, payload, sizeof(payload), ACK_TIMEOUT_MS);
+        if (n == 8 && type == STREAM_TYPE_START_ACK)
+            break;
+        if (n < 0)
+            stats.timeouts++;
+        stream_put_image_info(payload, data, size);
+    }
+    if (retry == MAX_RETRY) {
+        fprintf(stderr, "no START_ACK from target\n");
+        return -ETIMEDOUT;
+    }
+    status = (int32_t)get_le32(&payload[4]);
+    if (status) {
+        fprintf(stderr, "target rejected DELTA (err=%d)\n", status);
+        return status;
+    }
+    if ((uint32_t)(payload[2] | (payload[3] << 8)) != STREAM_MAX_PAYLOAD) {
+        fprintf(stderr, "unsupported max payload %u\n", payload[2] | (payload[3] << 8));
+        return -EPROTO;
+    }
+
+    /* PCRC：逐批读出 APP 区各块的 CRC 和所在页/扇区，与新固件比较 */
+    unit  = calloc(frame_cnt, sizeof(*unit));
+    dirty = calloc(frame_cnt, sizeof(*dirty));
+    if (!unit || !dirty) {
+        free(unit);
+        free(dirty);
+        return -ENOMEM;
+    }
+    for (i = 0; i < frame_cnt; i += cnt) {
+        cnt = frame_cnt - i;
+        if (cnt > STREAM_PCRC_MAX_BLOCKS)
+            cnt = STREAM_PCRC_MAX_BLOCKS;
+
+        for (retry = 0; retry < MAX_RETRY; retry++) {
+            payload[0] = i;
+            payload[1] = i >> 8;
+            payload[2] = cnt;
+            payload[3] = cnt >> 8;
+            if (stream_send_frame(STREAM_TYPE_PCRC, 0, payload, 4)) {
+                n = -EIO;
+                goto out;
+            }
+            n = stream_recv_frame(&type, &ack_seq, payload, sizeof(payload), ACK_TIMEOUT_MS);
+            if (n >= 4 && type == STREAM_TYPE_PCRC_ACK && ack_seq == i)
+                break;
+            if (n < 0)
+                stats.timeouts++;
+        }
+        if (retry == MAX_RETRY) {
+            fprintf(stderr, "no PCRC_ACK from target at block %u\n", i);
+            n = -ETIMEDOUT;
+            goto out;
+        }
+        status = (int32_t)get_le32(payload);
+        if (status || (uint32_t)n != 4 + cnt * STREAM_PCRC_ENTRY_LEN) {
+            fprintf(stderr, "target rejected PCRC at block %u (err=%d)\n", i, status);
+            n = status ? status : -EPROTO;
+            goto out;
+        }
+
+        for (j = 0; j < cnt; j++) {
+            const uint8_t *e = &payload[4 + j * STREAM_PCRC_ENTRY_LEN];
+
+            len = size - (i + j) * STREAM_MAX_PAYLOAD;
+            if (len > STREAM_MAX_PAYLOAD)
+                len = STREAM_MAX_PAYLOAD;
+            unit[i + j]  = e[4] | (e[5] << 8);
+            dirty[i + j] = len < STREAM_MAX_PAYLOAD ||
+                           crc32_mpeg2(0xFFFFFFFF, &data[(i + j) * STREAM_MAX_PAYLOAD], len) != get_le32(e);
+        }
+    }
+
+    /* 同一页/扇区内有块要写时，整个页/扇区的块都要重写（块按地址排列，同一页/扇区的块相邻） */
+    for (i = 0; i < frame_cnt; i = j) {
+        bool any = false;
+
+        for (j = i; j < frame_cnt && unit[j] == unit[i]; j++)
+            any |= dirty[j];
+        while (any && i < j)
+            dirty[i++] = true;
+    }
+    for (i = 0; i < frame_cnt; i++)
+        todo += dirty[i];
+    stats.unchanged += frame_cnt - todo;
+
+    t = now_ms();
+    stats.erase_ms += t - t_start;
+    printf("  delta: %u of %u block(s) to write\n", todo, frame_cnt);
+
+    /* WRITE：停等发送有变化的块 */
+    for (i = 0; i < frame_cnt; i++) {
+        if (!dirty[i])
+            continue;
+
+        len = size - i * STREAM_MAX_PAYLOAD;
+        if (len > STREAM_MAX_PAYLOAD)
+            len = STREAM_MAX_PAYLOAD;
+        put_le32(frame, crc32_mpeg2(0xFFFFFFFF, &data[i * STREAM_MAX_PAYLOAD], len));
+        memcpy(&frame[4], &data[i * STREAM_MAX_PAYLOAD], len);
+
+        for (retry = 0; retry < MAX_RETRY; retry++) {
+            if (retry)
+                stats.retransmits++;
+            else
+                stats.packets++;
+            t_pkt = now_ms();
+            if (stream_send_frame(STREAM_TYPE_WRITE, i, frame, 4 + len)) {
+                n = -EIO;
+                goto out;
+            }
+            n = stream_recv_frame(&type, &ack_seq, payload, sizeof(payload), ACK_TIMEOUT_MS);
+            if (n == 4 && type == STREAM_TYPE_WRITE_ACK && ack_seq == i)
+                break;
+            if (n < 0)
+                stats.timeouts++;
+        }
+        if (retry == MAX_RETRY) {
+            fprintf(stderr, "\nno WRITE_ACK from target at block %u\n", i);
+            n = -ETIMEDOUT;
+            goto out;
+        }
+        stats_add_rtt(now_ms() - t_pkt);
+
+        status = (int32_t)get_le32(payload);
+        if (status) {
+            fprintf(stderr, "\ntarget failed to program block %u (err=%d)\n", i, status);
+            n = status;
+            goto out;
+        }
+        stats.bytes += len;
+        show_progress(++done, todo);
+    }
+    stats.transfer_ms += now_ms() - t;
+
+    n = stream_finish();
+
+out:
+    free(unit);
+    free(dirty);
+    return n < 0 ? n : 0;
+}
+
+/**
+ * @brief   读取整个文件
+ * @return  文件数据，失败返回 NULL
+ */
+static uint8_t *load_file(const char *path, uint32_t *size)
+{
+    FILE *fp = fopen(path, "rb");
+    uint8_t *buf;
+    long len;
+
+    if (!fp) {
+        fprintf(stderr, "open %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (len <= 0) {
+        fprintf(stderr, "%s: empty file\n", path);
+        fclose(fp);
+        return NULL;
+    }
+
+    buf = malloc(len);
+    if (!buf || fread(buf, 1, len, fp) != (size_t)len) {
+        fprintf(stderr, "read %s failed\n", path);
+        free(buf);
+        fclose(fp);
+        return NULL;
+    }
+    fclose(fp);
+    *size = len;
+    return buf;
+}
+
+/**
+ * @brief   打印统计结果
+ */
+static void print_stats(void)
+{
+    double line_rate = stats.baudrate / 10.0;   // 8N1：每字节 10 位
+    double bps = stats.transfer_ms > 0 ? stats.bytes * 1000.0 / stats.transfer_ms : 0;
+    double total = stats.erase_ms + stats.transfer_ms + stats.finalize_ms;
+
+    printf("\n");
+    printf("  Erase     : %10.1f ms\n", stats.erase_ms);
+    printf("  Transfer  : %10.1f ms  %llu bytes, %.0f B/s (%.1f%% of %u baud line rate)\n",
+           stats.transfer_ms, (unsigned long long)stats.bytes, bps,
+           line_rate > 0 ? bps * 100.0 / line_rate : 0, stats.baudrate);
+    printf("  Finalize  : %10.1f ms\n", stats.finalize_ms);
+    printf("  Total     : %10.1f ms  %.0f B/s end to end\n", total,
+           total > 0 ? stats.bytes * 1000.0 / total : 0);
+    printf("  Packets   : %u sent, %u retransmitted, %u timeouts\n",
+           stats.packets, stats.retransmits, stats.timeouts);
+    if (stats.unchanged)
+        printf("  Unchanged : %u block(s) skipped by delta\n", stats.unchanged);
+    if (stats.rtt_cnt)
+        printf("  ACK RTT   : min %.2f / avg %.2f / max %.2f ms (%u samples)\n",
+               stats.rtt_min_ms, stats.rtt_sum_ms / stats.rtt_cnt, stats.rtt_max_ms, stats.rtt_cnt);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "usage: %s -p <port> [options] <firmware.bin> [more.bin ...]\n"
+        "  -p, --port <dev>       serial port or pseudo-terminal\n"
+        "  -b, --baud <rate>      console baudrate (default 115200)\n"
+        "  -B, --xfer-baud <rate> switch to this baudrate for the transfer, restored afterwards\n"
+        "  -m, --mode <proto>     xmodem | xmodem1k | ymodem | stream | delta (default xmodem1k)\n"
+        "  -s, --slot <n>         download to external Flash slot n (default: internal Flash)\n"
+        "  -r, --resume           stream: continue an interrupted download from the target's resume point\n"
+        "  -n, --no-menu          do not send the menu command, target is already waiting\n"
+        "  -v, --verbose          echo bootloader log output to stderr\n"
+        "Only ymodem accepts more than one file (written to consecutive external slots).\n"
+        "delta only writes the 1KB blocks that differ from the internal Flash APP.\n",
+        prog);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option long_opts[] = {
+        { "port",    required_argument, NULL, 'p' },
+        { "baud",    required_argument, NULL, 'b' },
+        { "xfer-baud", required_argument, NULL, 'B' },
+        { "mode",    required_argument, NULL, 'm' },
+        { "slot",    required_argument, NULL, 's' },
+        { "resume",  no_argument,       NULL, 'r' },
+        { "no-menu", no_argument,       NULL, 'n' },
+        { "verbose", no_argument,       NULL, 'v' },
+        { "help",    no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    const char *dev = NULL;
+    uint32_t baudrate = 115200;
+    uint32_t xfer_baudrate = 0;
+    proto_t proto = PROTO_XMODEM_1K;
+    int slot = 0;
+    bool use_menu = true;
+    bool resume = false;
+    uint8_t **images;
+    uint32_t *sizes;
+    char menu;
+    int file_num, i, opt, ret;
+    double t_start;
+
+    while ((opt = getopt_long(argc, argv, "p:b:B:m:s:rnvh", long_opts, NULL)) != -1) {
+        switch (opt) {
+        case 'p':
+            dev = optarg;
+            break;
+        case 'b':
+            baudrate = strtoul(optarg, NULL, 10);
+            break;
+        case 'B':
+            xfer_baudrate = strtoul(optarg, NULL, 10);
+            if (!baud_to_speed(xfer_baudrate)) {
+                fprintf(stderr, "unsupported baudrate %u\n", xfer_baudrate);
+                return 2;
+            }
+            break;
+        case 'm':
+            if (!strcmp(optarg, "xmodem"))
+                proto = PROTO_XMODEM;
+            else if (!strcmp(optarg, "xmodem1k"))
+                proto = PROTO_XMODEM_1K;
+            else if (!strcmp(optarg, "ymodem"))
+                proto = PROTO_YMODEM;
+            else if (!strcmp(optarg, "stream"))
+                proto = PROTO_STREAM;
+            else if (!strcmp(optarg, "delta"))
+                proto = PROTO_DELTA;
+            else {
+                usage(argv[0]);
+                return 2;
+            }
+            break;
+        case 's':
+            slot = atoi(optarg);
+            if (slot < 1 || slot > 9) {
+                fprintf(stderr, "slot must be 1-9\n");
+                return 2;
+            }
+            break;
+        case 'r':
+            resume = true;
+            break;
+        case 'n':
+            use_menu = false;
+            break;
+        case 'v':
+            port.verbose = true;
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    file_num = argc - optind;
+    if (!dev || file_num < 1 || (file_num > 1 && (proto != PROTO_YMODEM || !slot)) ||
+        (proto == PROTO_DELTA && slot)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    images = calloc(file_num, sizeof(*images));
+    sizes  = calloc(file_num, sizeof(*sizes));
+    for (i = 0; i < file_num; i++) {
+        images[i] = load_file(argv[optind + i], &sizes[i]);
+        if (!images[i])
+            return 1;
+    }
+
+    if (port_open(dev, baudrate))
+        return 1;
+
+    switch (proto) {
+    case PROTO_YMODEM: menu = slot ? MENU_YMODEM_EXT : MENU_YMODEM_INT; break;
+    case PROTO_STREAM: menu = slot ? MENU_STREAM_EXT : MENU_STREAM_INT; break;
+    case PROTO_DELTA:  menu = MENU_STREAM_INT; break;
+    default:           menu = slot ? MENU_XMODEM_EXT : MENU_XMODEM_INT; break;
+    }
+
+    if (xfer_baudrate && xfer_baudrate != baudrate) {
+        port_flush_input();
+        if (switch_baudrate(xfer_baudrate) == 0)
+            printf("transfer at %u baud\n", xfer_baudrate);
+    }
+    stats.baudrate = port.baudrate;
+
+    t_start = now_ms();
+    if (use_menu) {
+        port_flush_input();
+        printf("menu [%c]%s\n", menu, slot ? " -> external Flash" : " -> internal Flash");
+        if (send_menu(menu) || (slot && send_cmd(slot)))
+            return 1;
+    }
+
+    switch (proto) {
+    case PROTO_XMODEM:
+        ret = upload_xmodem(images[0], sizes[0], 128, t_start);
+        break;
+    case PROTO_XMODEM_1K:
+        ret = upload_xmodem(images[0], sizes[0], 1024, t_start);
+        break;
+    case PROTO_YMODEM:
+        ret = upload_ymodem(&argv[optind], images, sizes, file_num, t_start);
+        break;
+    case PROTO_DELTA:
+        ret = upload_delta(images[0], sizes[0], t_start);
+        break;
+    case PROTO_STREAM:
+    default:
+        ret = upload_stream(images[0], sizes[0], resume, t_start);
+        break;
+    }
+
+    if (ret) {
+        if (proto == PROTO_STREAM || proto == PROTO_DELTA)
+            stream_send_frame(STREAM_TYPE_ABORT, 0, NULL, 0);
+        else if (ret != -ECANCELED)
+            port_write("\x18\x18", 2);
+        fprintf(stderr, "download failed (%s)\n", strerror(ret < 0 ? -ret : EIO));
+    } else {
+        printf("download completed\n");
+    }
+
+    /* BootLoader 在会话结束（成功或失败）时恢复默认波特率 */
+    if (port.baudrate != baudrate)
+        port_set_baudrate(baudrate);
+
+    print_stats();
+    close(port.fd);
+    return ret ? 1 : 0;
+}
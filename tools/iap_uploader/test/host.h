@@ -0,0 +1,24 @@
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+
+/* 时间基准（CLOCK_MONOTONIC，微秒） */
+double host_now_us(void);
+void host_sleep_until_us(double t);
+void host_sleep_us(double us);
+
+/* 运行环境 */
+void host_fatal(const char *what);
+const char *host_state_path(const char *name);
+void *host_map_file(const char *name, uint32_t size, uint32_t base, uint8_t fill);
+void host_publish_tty(const char *name);
+void host_trace_tx(const uint8_t *data, uint32_t len);
+
+/* 模型统计 */
+uint32_t host_console_get_overrun(void);
+
+/* 命令行选项 */
+extern uint32_t host_flash_kb;     // 内部 Flash 容量（KB），F1 用于选择页大小
+
+#endif  /* HOST_H */
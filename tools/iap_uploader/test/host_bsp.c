@@ -0,0 +1,181 @@
+/*
+ * host_bsp - 主机上的 bsp_crc / bsp_delay / bsp_eeprom / bsp_common 实现
+ *
+ * CRC 按 STM32 CRC 单元的方式计算（每次复位为 0xFFFFFFFF，逐个 32 位字从最高位开始移入，多项式 0x04C11DB7）。
+ * EEPROM 为 256 字节的 AT24C02 模型（eeprom.bin），页写入 8 字节，每次写入等待 5ms 的写周期。
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include "bsp_common.h"
+#include "bsp_crc.h"
+#include "bsp_delay.h"
+#include "bsp_eeprom.h"
+#include "bsp_flash.h"
+#include "bsp_ext_flash.h"
+#include "host.h"
+#include "log.h"
+
+/* ------------------------------------- CRC ------------------------------------- */
+
+static int host_crc_init_impl(bsp_crc_t *self)
+{
+    (void)self;
+    return 0;
+}
+
+static uint32_t host_crc_calc_impl(bsp_crc_t *self, const uint32_t *data, uint32_t cnt)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    (void)self;
+
+    for (uint32_t i = 0; i < cnt / 4; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 32; b++)
+            crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+    }
+    return crc;
+}
+
+static const bsp_crc_ops_t host_crc_ops = {
+    .init = host_crc_init_impl,
+    .calc = host_crc_calc_impl
+};
+
+static bsp_crc_t bsp_crc = {
+    .ops = &host_crc_ops,
+};
+
+bsp_crc_t *bsp_crc_get(void)
+{
+    return &bsp_crc;
+}
+
+/* ------------------------------------ 延时 ------------------------------------ */
+
+static double host_delay_base;
+
+static int host_delay_init_impl(bsp_delay_t *self)
+{
+    (void)self;
+    host_delay_base = host_now_us();
+    return 0;
+}
+
+static void host_delay_deinit_impl(bsp_delay_t *self)
+{
+    (void)self;
+}
+
+static const bsp_delay_ops_t host_delay_ops = {
+    .init   = host_delay_init_impl,
+    .deinit = host_delay_deinit_impl
+};
+
+static bsp_delay_t bsp_delay = {
+    .ops = &host_delay_ops,
+};
+
+bsp_delay_t *bsp_delay_get(void)
+{
+    return &bsp_delay;
+}
+
+void bsp_delay_us(uint32_t us)
+{
+    host_sleep_us(us);
+}
+
+void bsp_delay_ms(uint32_t ms)
+{
+    host_sleep_us(ms * 1000.0);
+}
+
+uint32_t bsp_delay_get_tick_ms(void)
+{
+    return (uint32_t)((host_now_us() - host_delay_base) / 1000.0);
+}
+
+/* ----------------------------------- EEPROM ----------------------------------- */
+
+#define HOST_EEPROM_SIZE        256
+#define HOST_EEPROM_WRITE_MS    5
+
+static uint8_t *host_eeprom;
+
+static int host_eeprom_init_impl(bsp_eeprom_t *self)
+{
+    (void)self;
+    host_eeprom = host_map_file("eeprom.bin", HOST_EEPROM_SIZE, 0, 0xFF);
+    return 0;
+}
+
+static int host_eeprom_write_byte_impl(bsp_eeprom_t *self, uint8_t addr, uint8_t data)
+{
+    (void)self;
+    host_eeprom[addr] = data;
+    bsp_delay_ms(HOST_EEPROM_WRITE_MS);
+    return 0;
+}
+
+static int host_eeprom_write_page_impl(bsp_eeprom_t *self, uint8_t addr, uint8_t *data)
+{
+    (void)self;
+
+    /* 页写入在页内回卷，与器件一致 */
+    for (uint8_t i = 0; i < EEPROM_PAGE_SIZE; i++)
+        host_eeprom[(addr & ~(EEPROM_PAGE_SIZE - 1)) | ((addr + i) & (EEPROM_PAGE_SIZE - 1))] = data[i];
+    bsp_delay_ms(HOST_EEPROM_WRITE_MS);
+    return 0;
+}
+
+static int host_eeprom_read_data_impl(bsp_eeprom_t *self, uint8_t addr, uint16_t cnt, uint8_t *data)
+{
+    (void)self;
+
+    if (addr + cnt > HOST_EEPROM_SIZE)
+        return -EINVAL;
+    memcpy(data, host_eeprom + addr, cnt);
+    return 0;
+}
+
+static const bsp_eeprom_ops_t host_eeprom_ops = {
+    .init       = host_eeprom_init_impl,
+    .write_byte = host_eeprom_write_byte_impl,
+    .write_page = host_eeprom_write_page_impl,
+    .read_data  = host_eeprom_read_data_impl
+};
+
+static bsp_eeprom_t bsp_eeprom = {
+    .ops = &host_eeprom_ops,
+};
+
+bsp_eeprom_t *bsp_eeprom_get(void)
+{
+    return &bsp_eeprom;
+}
+
+/* ------------------------------------ 公共 ------------------------------------ */
+
+/**
+ * @brief   初始化各 BSP 模型，顺序与 bsp_common_init 一致（控制台由 log_init 初始化）
+ */
+int bsp_common_init(void)
+{
+    bsp_delay_t *delay = bsp_delay_get();
+    bsp_eeprom_t *eeprom = bsp_eeprom_get();
+    bsp_flash_t *flash = bsp_flash_get();
+    bsp_crc_t *crc = bsp_crc_get();
+    bsp_ext_flash_t *ext_flash = bsp_ext_flash_get();
+
+    delay->ops->init(delay);
+    eeprom->ops->init(eeprom);
+    flash->ops->init(flash);
+    crc->ops->init(crc);
+    ext_flash->ops->init(ext_flash);
+
+    log_info("Host BSP: flash %dKB, ext flash 16MB, eeprom 256B", host_flash_kb);
+    return 0;
+}
@@ -0,0 +1,298 @@
+/*
+ * host_console - 主机上的 bsp_console 实现
+ *
+ * 控制台串口用伪终端代替，上位机打开从端（路径写入 -t 指定的文件）。
+ * 接收线程按当前波特率（8N1，每字节 10 bit）把从端写入的字节排到一条虚拟串口线上，
+ * 模拟 drv_uart 的 DMA + 空闲中断接收：
+ *   - 每段最多 rx_single_max + 1 字节，DMA 计满后线上继续到达的字节丢失，直到空闲中断；
+ *   - 线路空闲一个字节时间后产生空闲中断，标记一段数据并重新配置 DMA；
+ *   - 段索引数组和环形缓冲区的回卷规则与 uart_idle_irq_handler 一致，recv_data 返回缓冲区内的原始指针。
+ * 发送按线路速率阻塞，与 uart_hw_send 逐字节查询发送的耗时相同。
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "bsp_console.h"
+#include "boot_config.h"
+#include "host.h"
+
+/* 与各板 bsp_console.c 中 uart_console_cfg 一致 */
+#if BOOT_PLATFORM_STM32F4
+#define HOST_RX_BUF_SIZE        16640
+#define HOST_RX_SINGLE_MAX      8300
+#else
+#define HOST_RX_BUF_SIZE        2304
+#define HOST_RX_SINGLE_MAX      1100
+#endif
+#define HOST_TX_BUF_SIZE        256
+#define HOST_BAUD_DEFAULT       115200
+#define IDX_BUF_NUM             10
+
+typedef struct {
+    uint8_t *start;
+    uint8_t *end;
+} host_rx_idx_t;
+
+typedef struct {
+    int      fd;                        // 伪终端主端
+    int      slave_fd;                  // 保持从端打开，上位机未连接时主端读写不出错
+    uint32_t baudrate;
+
+    uint8_t  rx_buf[HOST_RX_BUF_SIZE];
+    uint8_t  tx_buf[HOST_TX_BUF_SIZE];
+    uint16_t data_cnt;
+    host_rx_idx_t idx_buf[IDX_BUF_NUM];
+    host_rx_idx_t *volatile idx_in;     // 由接收线程（中断）推进
+    host_rx_idx_t *volatile idx_out;    // 由主循环推进
+    uint32_t dma_cnt;                   // 当前段 DMA 已写入的字节数
+
+    /* 虚拟串口线 */
+    uint8_t  line[4096];                // 已从伪终端读出、还在线上传输的字节
+    uint32_t line_head, line_tail;
+    double   line_busy_until;           // 线上最后一个字节接收完成的时刻（us）
+    double   last_rx_done;              // 上一个进入 DMA 的字节接收完成的时刻（us）
+    bool     seg_open;                  // 当前段已有数据，等待空闲中断
+
+    uint32_t overrun;                   // DMA 计满后丢失的字节数
+    pthread_t thread;
+} host_console_t;
+
+static host_console_t host_console;
+
+static double host_byte_us(void)
+{
+    return 10.0 * 1e6 / host_console.baudrate;
+}
+
+/**
+ * @brief   空闲中断：标记一段数据的结尾并为下一段重新配置 DMA，逻辑与 uart_idle_irq_handler 一致
+ */
+static void host_console_idle_irq(void)
+{
+    host_console_t *c = &host_console;
+    host_rx_idx_t *in = c->idx_in;
+
+    c->data_cnt += c->dma_cnt;
+    in->end = &c->rx_buf[c->data_cnt - 1];
+
+    in++;
+    if (in == &c->idx_buf[IDX_BUF_NUM - 1])
+        in = &c->idx_buf[0];
+
+    if (HOST_RX_BUF_SIZE - c->data_cnt >= HOST_RX_SINGLE_MAX) {
+        in->start = &c->rx_buf[c->data_cnt];
+    } else {
+        in->start = &c->rx_buf[0];
+        c->data_cnt = 0;
+    }
+    __atomic_store_n(&c->idx_in, in, __ATOMIC_RELEASE);
+
+    c->dma_cnt = 0;
+    c->seg_open = false;
+}
+
+/**
+ * @brief   线上一个字节接收完成，由 DMA 写入当前段
+ */
+static void host_console_dma_put(uint8_t byte)
+{
+    host_console_t *c = &host_console;
+
+    if (c->dma_cnt >= HOST_RX_SINGLE_MAX + 1) {
+        c->overrun++;
+        return;
+    }
+    c->idx_in->start[c->dma_cnt++] = byte;
+    c->seg_open = true;
+}
+
+/**
+ * @brief   接收线程：从伪终端读出上位机发送的字节，按线路速率送入 DMA 并产生空闲中断
+ */
+static void *host_console_rx_thread(void *arg)
+{
+    host_console_t *c = &host_console;
+    (void)arg;
+
+    while (1) {
+        double now = host_now_us();
+        double byte_us = host_byte_us();
+
+        /* 伪终端中新到的字节排到线上，线空闲时从当前时刻开始发送 */
+        uint32_t room = sizeof(c->line) - (c->line_tail - c->line_head);
+        if (room) {
+            uint8_t tmp[sizeof(c->line)];
+            ssize_t n = read(c->fd, tmp, room);
+            for (ssize_t i = 0; i < n; i++) {
+                if (c->line_busy_until < now)
+                    c->line_busy_until = now;
+                c->line_busy_until += byte_us;
+                c->line[c->line_tail++ % sizeof(c->line)] = tmp[i];
+            }
+        }
+
+        /* 已经在线上传输完成的字节：相邻字节间隔超过一个字节时间先产生空闲中断 */
+        uint32_t queued = c->line_tail - c->line_head;
+        double first_done = c->line_busy_until - (queued - 1) * byte_us;
+        while (c->line_head != c->line_tail && first_done <= now) {
+            if (c->seg_open && first_done - byte_us > c->last_rx_done + byte_us)
+                host_console_idle_irq();
+            host_console_dma_put(c->line[c->line_head++ % sizeof(c->line)]);
+            c->last_rx_done = first_done;
+            first_done += byte_us;
+        }
+
+        if (c->seg_open && c->line_head == c->line_tail && now >= c->last_rx_done + byte_us)
+            host_console_idle_irq();
+
+        struct pollfd pfd = { .fd = c->fd, .events = POLLIN };
+        struct timespec ts = { 0, 50 * 1000 };
+        ppoll(&pfd, c->line_head == c->line_tail ? 1 : 0, &ts, NULL);
+    }
+    return NULL;
+}
+
+/**
+ * @brief   把伪终端从端路径写入文件，供测试脚本找到串口
+ */
+static int host_console_init_impl(bsp_console_t *self)
+{
+    host_console_t *c = &host_console;
+    struct termios tio;
+    const char *name;
+    (void)self;
+
+    c->fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (c->fd < 0 || grantpt(c->fd) || unlockpt(c->fd))
+        host_fatal("posix_openpt");
+    name = ptsname(c->fd);
+
+    /* 上位机打开前从端默认为规范模式且回显，先设为原始模式 */
+    c->slave_fd = open(name, O_RDWR | O_NOCTTY);
+    if (c->slave_fd < 0 || tcgetattr(c->slave_fd, &tio))
+        host_fatal("open pty slave");
+    cfmakeraw(&tio);
+    tcsetattr(c->slave_fd, TCSANOW, &tio);
+    fcntl(c->fd, F_SETFL, fcntl(c->fd, F_GETFL) | O_NONBLOCK);
+
+    c->baudrate = HOST_BAUD_DEFAULT;
+    c->idx_in = c->idx_out = &c->idx_buf[0];
+    c->idx_in->start = c->rx_buf;
+    c->data_cnt = 0;
+
+    host_publish_tty(name);
+    if (pthread_create(&c->thread, NULL, host_console_rx_thread, NULL))
+        host_fatal("pthread_create");
+    return 0;
+}
+
+static int host_console_send_data_impl(bsp_console_t *self, uint8_t *data, uint32_t len)
+{
+    host_console_t *c = &host_console;
+    double done = host_now_us() + len * host_byte_us();
+    uint32_t off = 0;
+    (void)self;
+
+    host_trace_tx(data, len);
+    while (off < len) {
+        ssize_t n = write(c->fd, data + off, len - off);
+        if (n > 0) {
+            off += n;
+        } else if (n < 0 && errno == EAGAIN) {
+            /* 上位机没有读取时等待，超时丢弃，与串口线上没有接收方时一样 */
+            struct pollfd pfd = { .fd = c->fd, .events = POLLOUT };
+            if (poll(&pfd, 1, 200) <= 0)
+                break;
+        } else {
+            break;
+        }
+    }
+    host_sleep_until_us(done);
+    return 0;
+}
+
+static void host_console_vprintf_impl(bsp_console_t *self, const char *format, va_list args)
+{
+    host_console_t *c = &host_console;
+    int n = vsnprintf((char *)c->tx_buf, sizeof(c->tx_buf), format, args);
+
+    if (n > (int)sizeof(c->tx_buf) - 1)
+        n = sizeof(c->tx_buf) - 1;
+    if (n > 0)
+        host_console_send_data_impl(self, c->tx_buf, n);
+}
+
+static void host_console_printf_impl(bsp_console_t *self, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    host_console_vprintf_impl(self, format, args);
+    va_end(args);
+}
+
+static int host_console_recv_data_impl(bsp_console_t *self, uint8_t **data, uint32_t *len)
+{
+    host_console_t *c = &host_console;
+    host_rx_idx_t *out = c->idx_out;
+    (void)self;
+
+    if (__atomic_load_n(&c->idx_in, __ATOMIC_ACQUIRE) == out) {
+        *data = NULL;
+        *len = 0;
+        return -EAGAIN;
+    }
+
+    *data = out->start;
+    *len = out->end - out->start + 1;
+
+    out++;
+    if (out == &c->idx_buf[IDX_BUF_NUM - 1])
+        out = &c->idx_buf[0];
+    c->idx_out = out;
+    return 0;
+}
+
+static int host_console_set_baudrate_impl(bsp_console_t *self, uint32_t baudrate)
+{
+    (void)self;
+
+    host_console.baudrate = baudrate ? baudrate : HOST_BAUD_DEFAULT;
+    return 0;
+}
+
+/**
+ * @brief   DMA 计满后丢失的字节数，退出时打印
+ */
+uint32_t host_console_get_overrun(void)
+{
+    return host_console.overrun;
+}
+
+static const bsp_console_ops_t host_console_ops = {
+    .init         = host_console_init_impl,
+    .vprintf      = host_console_vprintf_impl,
+    .printf       = host_console_printf_impl,
+    .send_data    = host_console_send_data_impl,
+    .recv_data    = host_console_recv_data_impl,
+    .set_baudrate = host_console_set_baudrate_impl
+};
+
+static bsp_console_t bsp_console = {
+    .ops = &host_console_ops,
+    .drv = &host_console,
+};
+
+bsp_console_t *bsp_console_get(void)
+{
+    return &bsp_console;
+}
@@ -0,0 +1,421 @@
+/*
+ * host_flash - 主机上的 bsp_flash / bsp_ext_flash 实现
+ *
+ * 内部 Flash 映射到 0x08000000（状态目录下的 flash.bin），BootLoader 按绝对地址直接读取。
+ *   - F1：按页擦除，半字编程，目标半字未擦除时返回错误（对应 PGERR）；
+ *   - F4：按扇区擦除（扇区表与 boot_flash.c 一致），字编程；
+ *   擦除/编程按数据手册典型时间阻塞调用方，期间接收线程（中断）照常工作。
+ * 外部 Flash 为 16MB 的 W25Q128 模型（ext_flash.bin），页编程/擦除按典型时间计时：
+ *   - busy_poll 在编程和擦除都完成前返回 -EBUSY；
+ *   - 擦除进行中访问其他地址时相当于暂停擦除，擦除的完成时刻顺延访问耗时；
+ *   - 访问正在擦除的区域时等待擦除完成；
+ *   - 页编程不能跨页，只能把 1 写成 0。
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include "bsp_flash.h"
+#include "bsp_ext_flash.h"
+#include "boot_config.h"
+#include "host.h"
+
+/* ---------------------------------- 内部 Flash ---------------------------------- */
+
+#if BOOT_PLATFORM_STM32F4
+#define HOST_FLASH_SECTOR_COUNT     12
+#define HOST_FLASH_WORD_PROG_US     16.0        // x32 字编程典型时间
+#define HOST_FLASH_DEV_ID           0x413
+
+static const struct {
+    uint32_t offset;
+    uint32_t size;
+    uint32_t erase_ms;
+} host_flash_sector_tbl[HOST_FLASH_SECTOR_COUNT] = {
+    { 0x00000,  16 * 1024,  250 }, { 0x04000,  16 * 1024,  250 },
+    { 0x08000,  16 * 1024,  250 }, { 0x0C000,  16 * 1024,  250 },
+    { 0x10000,  64 * 1024,  550 }, { 0x20000, 128 * 1024, 1000 },
+    { 0x40000, 128 * 1024, 1000 }, { 0x60000, 128 * 1024, 1000 },
+    { 0x80000, 128 * 1024, 1000 }, { 0xA0000, 128 * 1024, 1000 },
+    { 0xC0000, 128 * 1024, 1000 }, { 0xE0000, 128 * 1024, 1000 },
+};
+#else
+#define HOST_FLASH_PAGE_ERASE_MS    20          // 页擦除典型时间
+#define HOST_FLASH_HALF_PROG_US     52.5        // 半字编程典型时间
+#define HOST_FLASH_DEV_ID           0x410
+#endif
+
+typedef struct {
+    uint8_t *mem;
+    uint32_t size;
+    uint32_t page_size;
+    double   write_done;    // 异步编程完成时刻
+    int      write_ret;
+} host_flash_t;
+
+static host_flash_t host_flash;
+
+static int host_flash_init_impl(bsp_flash_t *self)
+{
+    host_flash_t *f = (host_flash_t *)self->drv;
+
+    f->size = host_flash_kb * 1024;
+#if BOOT_PLATFORM_STM32F4
+    f->page_size = 0;
+#else
+    f->page_size = host_flash_kb > 128 ? 2048 : 1024;
+#endif
+    f->mem = host_map_file("flash.bin", f->size, BOOT_FLASH_BASE_ADDR, 0xFF);
+    return 0;
+}
+
+static int host_flash_erase_impl(bsp_flash_t *self, uint16_t cnt, uint16_t idx)
+{
+    host_flash_t *f = (host_flash_t *)self->drv;
+
+    for (uint16_t i = 0; i < cnt; i++) {
+#if BOOT_PLATFORM_STM32F4
+        if (idx + i >= HOST_FLASH_SECTOR_COUNT)
+            return -EINVAL;
+        memset(f->mem + host_flash_sector_tbl[idx + i].offset, 0xFF, host_flash_sector_tbl[idx + i].size);
+        host_sleep_us(host_flash_sector_tbl[idx + i].erase_ms * 1000.0);
+#else
+        if ((uint32_t)(idx + i + 1) * f->page_size > f->size)
+            return -EINVAL;
+        memset(f->mem + (idx + i) * f->page_size, 0xFF, f->page_size);
+        host_sleep_us(HOST_FLASH_PAGE_ERASE_MS * 1000.0);
+#endif
+    }
+    return 0;
+}
+
+/**
+ * @brief   按编程单元写入，返回写入耗时（us），失败返回负值
+ */
+static double host_flash_program(host_flash_t *f, uint32_t addr, uint32_t cnt, const uint32_t *data)
+{
+    uint32_t off = addr - BOOT_FLASH_BASE_ADDR;
+
+    if ((addr & 0x3) || (cnt & 0x3) || addr < BOOT_FLASH_BASE_ADDR || off + cnt > f->size)
+        return -1;
+
+#if BOOT_PLATFORM_STM32F4
+    const uint8_t *src = (const uint8_t *)data;
+    for (uint32_t i = 0; i < cnt; i++)
+        f->mem[off + i] &= src[i];
+    return cnt / 4 * HOST_FLASH_WORD_PROG_US;
+#else
+    const uint16_t *src = (const uint16_t *)data;
+    uint16_t *dst = (uint16_t *)(f->mem + off);
+    for (uint32_t i = 0; i < cnt / 2; i++) {
+        if (dst[i] != 0xFFFF && src[i] != 0)
+            return -1;      // PGERR：目标半字未擦除
+        dst[i] = src[i];
+    }
+    return cnt / 2 * HOST_FLASH_HALF_PROG_US;
+#endif
+}
+
+static int host_flash_write_impl(bsp_flash_t *self, uint32_t addr, uint32_t cnt, uint32_t *data)
+{
+    double us = host_flash_program((host_flash_t *)self->drv, addr, cnt, data);
+
+    if (us < 0)
+        return -EIO;
+    host_sleep_us(us);
+    return 0;
+}
+
+static int host_flash_write_start_impl(bsp_flash_t *self, uint32_t addr, uint32_t cnt, const uint32_t *data)
+{
+    host_flash_t *f = (host_flash_t *)self->drv;
+    double us = host_flash_program(f, addr, cnt, data);
+
+    f->write_ret = us < 0 ? -EIO : 0;
+    f->write_done = host_now_us() + (us < 0 ? 0 : us);
+    return 0;
+}
+
+static int host_flash_write_poll_impl(bsp_flash_t *self)
+{
+    host_flash_t *f = (host_flash_t *)self->drv;
+
+    if (host_now_us() < f->write_done)
+        return -EBUSY;
+    return f->write_ret;
+}
+
+static int host_flash_get_info_impl(bsp_flash_t *self, bsp_flash_info_t *info)
+{
+    host_flash_t *f = (host_flash_t *)self->drv;
+
+    info->size      = f->size;
+    info->page_size = f->page_size;
+    info->dev_id    = HOST_FLASH_DEV_ID;
+    return 0;
+}
+
+static const bsp_flash_ops_t host_flash_ops = {
+    .init        = host_flash_init_impl,
+    .erase       = host_flash_erase_impl,
+    .write       = host_flash_write_impl,
+    .write_start = host_flash_write_start_impl,
+    .write_poll  = host_flash_write_poll_impl,
+    .get_info    = host_flash_get_info_impl
+};
+
+static bsp_flash_t bsp_flash = {
+    .ops = &host_flash_ops,
+    .drv = &host_flash,
+};
+
+bsp_flash_t *bsp_flash_get(void)
+{
+    return &bsp_flash;
+}
+
+/* ---------------------------------- 外部 Flash ---------------------------------- */
+
+#define HOST_EXT_FLASH_SIZE         (16UL * 1024UL * 1024UL)
+#define HOST_EXT_FLASH_PAGE_US      700.0       // 页编程典型时间
+#define HOST_EXT_FLASH_SECTOR_MS    45          // 4KB 扇区擦除典型时间
+#define HOST_EXT_FLASH_BLOCK32_MS   120         // 32KB 半块擦除典型时间
+#define HOST_EXT_FLASH_BLOCK64_MS   150         // 64KB 块擦除典型时间
+#define HOST_EXT_FLASH_READ_US_PER_BYTE 0.45    // SPI 18MHz 读取
+
+typedef struct {
+    uint8_t *mem;
+    double   prog_done;     // 页编程完成时刻
+    bool     erasing;
+    uint32_t erase_addr;
+    uint32_t erase_len;
+    double   erase_done;    // 擦除完成时刻
+} host_ext_flash_t;
+
+static host_ext_flash_t host_ext_flash;
+
+/**
+ * @brief   擦除到时后把擦除区域置为 0xFF
+ */
+static void host_ext_flash_settle(host_ext_flash_t *e)
+{
+    if (e->erasing && host_now_us() >= e->erase_done) {
+        memset(e->mem + e->erase_addr, 0xFF, e->erase_len);
+        e->erasing = false;
+    }
+}
+
+/**
+ * @brief   同步访问前等待页编程完成；访问擦除区域时等待擦除完成，否则按暂停擦除处理
+ * @param[in] us 本次访问的耗时
+ */
+static void host_ext_flash_access(host_ext_flash_t *e, uint32_t addr, uint32_t cnt, double us)
+{
+    host_sleep_until_us(e->prog_done);
+    host_ext_flash_settle(e);
+    if (e->erasing) {
+        if (addr < e->erase_addr + e->erase_len && addr + cnt > e->erase_addr) {
+            host_sleep_until_us(e->erase_done);
+            host_ext_flash_settle(e);
+        } else {
+            e->erase_done += us;
+        }
+    }
+}
+
+static int host_ext_flash_program(host_ext_flash_t *e, uint32_t addr, uint32_t cnt, const uint8_t *data)
+{
+    if (cnt == 0 || cnt > EXT_FLASH_PAGE_SIZE || (addr % EXT_FLASH_PAGE_SIZE) + cnt > EXT_FLASH_PAGE_SIZE ||
+        addr + cnt > HOST_EXT_FLASH_SIZE)
+        return -EINVAL;
+
+    host_ext_flash_access(e, addr, cnt, HOST_EXT_FLASH_PAGE_US);
+    for (uint32_t i = 0; i < cnt; i++)
+        e->mem[addr + i] &= data[i];
+    return 0;
+}
+
+static int host_ext_flash_erase_start(host_ext_flash_t *e, uint32_t addr, uint32_t len, uint32_t ms)
+{
+    if (addr % len || addr + len > HOST_EXT_FLASH_SIZE)
+        return -EINVAL;
+
+    /* 新的擦除前等待之前的编程/擦除完成 */
+    host_sleep_until_us(e->prog_done);
+    if (e->erasing) {
+        host_sleep_until_us(e->erase_done);
+        host_ext_flash_settle(e);
+    }
+    e->erasing = true;
+    e->erase_addr = addr;
+    e->erase_len = len;
+    e->erase_done = host_now_us() + ms * 1000.0;
+    return 0;
+}
+
+static int host_ext_flash_busy_poll_impl(bsp_ext_flash_t *self)
+{
+    host_ext_flash_t *e = (host_ext_flash_t *)self->drv;
+
+    host_ext_flash_settle(e);
+    if (host_now_us() < e->prog_done || e->erasing)
+        return -EBUSY;
+    return 0;
+}
+
+static int host_ext_flash_erase_wait(bsp_ext_flash_t *self, int ret)
+{
+    while (ret == 0 && (ret = host_ext_flash_busy_poll_impl(self)) == -EBUSY)
+        host_sleep_us(100);
+    return ret;
+}
+
+static int host_ext_flash_init_impl(bsp_ext_flash_t *self)
+{
+    host_ext_flash_t *e = (host_ext_flash_t *)self->drv;
+
+    e->mem = host_map_file("ext_flash.bin", HOST_EXT_FLASH_SIZE, 0, 0xFF);
+    return 0;
+}
+
+static int host_ext_flash_read_id_impl(bsp_ext_flash_t *self, uint8_t *mid, uint16_t *did)
+{
+    (void)self;
+
+    *mid = 0xEF;
+    *did = 0x4018;
+    return 0;
+}
+
+static int host_ext_flash_write_page_impl(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data)
+{
+    host_ext_flash_t *e = (host_ext_flash_t *)self->drv;
+    int ret = host_ext_flash_program(e, addr, cnt, data);
+
+    if (ret == 0)
+        host_sleep_us(HOST_EXT_FLASH_PAGE_US);
+    return ret;
+}
+
+static int host_ext_flash_write_page_start_impl(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data)
+{
+    host_ext_flash_t *e = (host_ext_flash_t *)self->drv;
+    int ret = host_ext_flash_program(e, addr, cnt, data);
+
+    if (ret == 0)
+        e->prog_done = host_now_us() + HOST_EXT_FLASH_PAGE_US;
+    return ret;
+}
+
+static int host_ext_flash_write_data_impl(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data)
+{
+    while (cnt) {
+        uint32_t len = EXT_FLASH_PAGE_SIZE - addr % EXT_FLASH_PAGE_SIZE;
+        int ret;
+
+        if (len > cnt)
+            len = cnt;
+        ret = host_ext_flash_write_page_impl(self, addr, len, data);
+        if (ret)
+            return ret;
+        addr += len;
+        data += len;
+        cnt  -= len;
+    }
+    return 0;
+}
+
+static int host_ext_flash_erase_sector_start_impl(bsp_ext_flash_t *self, uint32_t addr)
+{
+    return host_ext_flash_erase_start((host_ext_flash_t *)self->drv, addr,
+                                      EXT_FLASH_SECTOR_4KB_PAGE_CNT * EXT_FLASH_PAGE_SIZE, HOST_EXT_FLASH_SECTOR_MS);
+}
+
+static int host_ext_flash_erase_sector_impl(bsp_ext_flash_t *self, uint32_t addr)
+{
+    return host_ext_flash_erase_wait(self, host_ext_flash_erase_sector_start_impl(self, addr));
+}
+
+static int host_ext_flash_erase_block_32k_start_impl(bsp_ext_flash_t *self, uint32_t addr)
+{
+    return host_ext_flash_erase_start((host_ext_flash_t *)self->drv, addr, 32 * 1024, HOST_EXT_FLASH_BLOCK32_MS);
+}
+
+static int host_ext_flash_erase_block_32k_impl(bsp_ext_flash_t *self, uint32_t addr)
+{
+    return host_ext_flash_erase_wait(self, host_ext_flash_erase_block_32k_start_impl(self, addr));
+}
+
+static int host_ext_flash_erase_block_start_impl(bsp_ext_flash_t *self, uint16_t idx)
+{
+    return host_ext_flash_erase_start((host_ext_flash_t *)self->drv,
+                                      (uint32_t)idx * EXT_FLASH_BLOCK_64KB_PAGE_CNT * EXT_FLASH_PAGE_SIZE,
+                                      EXT_FLASH_BLOCK_64KB_PAGE_CNT * EXT_FLASH_PAGE_SIZE, HOST_EXT_FLASH_BLOCK64_MS);
+}
+
+static int host_ext_flash_erase_block_impl(bsp_ext_flash_t *self, uint16_t idx)
+{
+    return host_ext_flash_erase_wait(self, host_ext_flash_erase_block_start_impl(self, idx));
+}
+
+static int host_ext_flash_read_data_impl(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data)
+{
+    host_ext_flash_t *e = (host_ext_flash_t *)self->drv;
+    double us = cnt * HOST_EXT_FLASH_READ_US_PER_BYTE;
+
+    if (addr + cnt > HOST_EXT_FLASH_SIZE)
+        return -EINVAL;
+
+    host_ext_flash_access(e, addr, cnt, us);
+    memcpy(data, e->mem + addr, cnt);
+    host_sleep_us(us);
+    return 0;
+}
+
+static int host_ext_flash_read_data_start_impl(bsp_ext_flash_t *self, uint32_t addr, uint32_t cnt, uint8_t *data)
+{
+    host_ext_flash_t *e = (host_ext_flash_t *)self->drv;
+
+    if (addr + cnt > HOST_EXT_FLASH_SIZE)
+        return -EINVAL;
+
+    host_ext_flash_access(e, addr, cnt, cnt * HOST_EXT_FLASH_READ_US_PER_BYTE);
+    memcpy(data, e->mem + addr, cnt);
+    return 0;
+}
+
+static int host_ext_flash_read_data_poll_impl(bsp_ext_flash_t *self)
+{
+    (void)self;
+    return 0;
+}
+
+static const bsp_ext_flash_ops_t host_ext_flash_ops = {
+    .init                  = host_ext_flash_init_impl,
+    .read_id               = host_ext_flash_read_id_impl,
+    .write_page            = host_ext_flash_write_page_impl,
+    .write_page_start      = host_ext_flash_write_page_start_impl,
+    .write_data            = host_ext_flash_write_data_impl,
+    .erase_sector          = host_ext_flash_erase_sector_impl,
+    .erase_sector_start    = host_ext_flash_erase_sector_start_impl,
+    .erase_block_32k       = host_ext_flash_erase_block_32k_impl,
+    .erase_block_32k_start = host_ext_flash_erase_block_32k_start_impl,
+    .erase_block           = host_ext_flash_erase_block_impl,
+    .erase_block_start     = host_ext_flash_erase_block_start_impl,
+    .busy_poll             = host_ext_flash_busy_poll_impl,
+    .read_data             = host_ext_flash_read_data_impl,
+    .read_data_start       = host_ext_flash_read_data_start_impl,
+    .read_data_poll        = host_ext_flash_read_data_poll_impl,
+};
+
+static bsp_ext_flash_t bsp_ext_flash = {
+    .ops = &host_ext_flash_ops,
+    .drv = &host_ext_flash,
+};
+
+bsp_ext_flash_t *bsp_ext_flash_get(void)
+{
+    return &bsp_ext_flash;
+}
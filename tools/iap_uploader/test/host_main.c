@@ -0,0 +1,320 @@
+/*
+ * host_main - 在主机上运行 BootLoader
+ *
+ * 代替 boot_core.c 和 app/main.c：标志位、乒乓更新块和主循环与目标板相同，
+ * 跳转 APP 和系统复位改为退出进程（状态目录中的 Flash/EEPROM 文件保留，重新启动即为复位后的状态）。
+ * 其余 app/bootloader 源码和 log.c 原样编译，BSP 由 host_console.c、host_flash.c、host_bsp.c 提供。
+ *
+ * 用法：boot_host [-d 状态目录] [-t 串口路径文件] [-c] [-l 发送日志] [-F Flash KB]
+ *   -d  保存 flash.bin、ext_flash.bin、eeprom.bin 的目录，默认当前目录
+ *   -t  启动后把伪终端从端路径写入该文件，测试脚本据此启动上位机
+ *   -c  直接进入命令行，相当于上电 2 秒内按下 'w'
+ *   -l  把 BootLoader 发送的所有数据追加写入该文件
+ *   -F  内部 Flash 容量（KB），仅 F1，默认 64
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "bsp_common.h"
+#include "bsp_delay.h"
+#include "log.h"
+#include "boot_core.h"
+#include "boot_config.h"
+#include "boot_comm.h"
+#include "boot_cmd.h"
+#include "boot_event.h"
+#include "boot_ota.h"
+#include "boot_ext_flash.h"
+#include "boot_flash.h"
+#include "host.h"
+
+#if BOOT_PLATFORM_STM32F4
+uint32_t host_flash_kb = 1024;
+#else
+uint32_t host_flash_kb = 64;
+#endif
+
+static const char *host_state_dir = ".";
+static const char *host_tty_file;
+static bool host_enter_cmd;
+static FILE *host_tx_log;
+static struct timespec host_t0;
+
+/* ---------------------------------- 运行环境 ---------------------------------- */
+
+double host_now_us(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (t.tv_sec - host_t0.tv_sec) * 1e6 + (t.tv_nsec - host_t0.tv_nsec) / 1e3;
+}
+
+void host_sleep_until_us(double t)
+{
+    double us = t - host_now_us();
+
+    if (us > 0)
+        host_sleep_us(us);
+}
+
+void host_sleep_us(double us)
+{
+    struct timespec ts;
+
+    if (us <= 0)
+        return;
+    ts.tv_sec = (time_t)(us / 1e6);
+    ts.tv_nsec = (long)((us - ts.tv_sec * 1e6) * 1e3);
+    nanosleep(&ts, NULL);
+}
+
+void host_fatal(const char *what)
+{
+    perror(what);
+    exit(2);
+}
+
+const char *host_state_path(const char *name)
+{
+    static char path[4096];
+
+    snprintf(path, sizeof(path), "%s/%s", host_state_dir, name);
+    return path;
+}
+
+/**
+ * @brief   把状态目录中的文件映射到内存，文件不存在时按 fill 填充创建
+ * @param[in] base 非 0 时映射到该固定地址（内部 Flash 按绝对地址访问）
+ */
+void *host_map_file(const char *name, uint32_t size, uint32_t base, uint8_t fill)
+{
+    const char *path = host_state_path(name);
+    int flags = MAP_SHARED;
+    void *mem;
+    int fd;
+
+    fd = open(path, O_RDWR);
+    if (fd < 0) {
+        uint8_t *buf = malloc(size);
+
+        fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0 || !buf)
+            host_fatal(path);
+        memset(buf, fill, size);
+        if (write(fd, buf, size) != (ssize_t)size)
+            host_fatal(path);
+        free(buf);
+    }
+    if (ftruncate(fd, size))
+        host_fatal(path);
+
+    if (base)
+        flags |= MAP_FIXED_NOREPLACE;
+    mem = mmap((void *)(uintptr_t)base, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (mem == MAP_FAILED || (base && mem != (void *)(uintptr_t)base))
+        host_fatal(path);
+    close(fd);
+    return mem;
+}
+
+void host_publish_tty(const char *name)
+{
+    char tmp[4096];
+    FILE *f;
+
+    fprintf(stderr, "boot_host: console on %s\n", name);
+    if (!host_tty_file)
+        return;
+
+    /* 先写临时文件再改名，脚本读到的总是完整路径 */
+    snprintf(tmp, sizeof(tmp), "%s.tmp", host_tty_file);
+    f = fopen(tmp, "w");
+    if (!f)
+        host_fatal(tmp);
+    fprintf(f, "%s\n", name);
+    fclose(f);
+    rename(tmp, host_tty_file);
+}
+
+void host_trace_tx(const uint8_t *data, uint32_t len)
+{
+    if (host_tx_log) {
+        fwrite(data, 1, len, host_tx_log);
+        fflush(host_tx_log);
+    }
+}
+
+static void host_exit_report(void)
+{
+    fprintf(stderr, "boot_host: exit, rx overrun %u bytes\n", host_console_get_overrun());
+}
+
+static void host_on_signal(int sig)
+{
+    /* 信号处理中只用异步信号安全的调用，Flash/EEPROM 为共享映射，不需要回写 */
+    char msg[64] = "boot_host: killed, rx overrun ";
+    char num[12];
+    uint32_t v = host_console_get_overrun();
+    int len = strlen(msg), n = 0;
+    (void)sig;
+
+    do {
+        num[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v);
+    while (n)
+        msg[len++] = num[--n];
+    memcpy(msg + len, " bytes\n", 7);
+    if (write(STDERR_FILENO, msg, len + 7) < 0)
+        _exit(1);
+    _exit(0);
+}
+
+/* ------------------------------- boot_core 替代 ------------------------------- */
+
+typedef struct {
+    uint8_t  update_chunk[BOOT_APP_UPDATE_CHUNK_NUM][BOOT_APP_UPDATE_CHUNK_SIZE];
+    uint32_t flag;
+} boot_ctx_t;
+
+static boot_ctx_t g_boot_ctx;
+
+static bool boot_check_enter_cmd(uint16_t timeout_ms)
+{
+    uint8_t *rx_data = NULL;
+    uint32_t rx_len = 0;
+
+    if (host_enter_cmd)
+        return true;
+
+    while (timeout_ms--) {
+        boot_recv_data(&rx_data, &rx_len);
+        if (rx_data && rx_len == 1)
+            if (rx_data[0] == 'w' || rx_data[0] == 'W')
+                return true;
+        bsp_delay_ms(1);
+    }
+
+    return false;
+}
+
+/**
+ * @brief   跳转 APP：与 boot_jump_to_app 相同地检查 MSP，有效时退出进程
+ */
+static void boot_jump_to_app(uint32_t addr)
+{
+    uint32_t msp = *(uint32_t *)(uintptr_t)addr;
+
+    if (msp < BOOT_RAM_BASE_ADDR || msp > BOOT_RAM_END_ADDR) {
+        log_warn("Invalid MSP: 0x%X, abort jump", msp);
+        return;
+    }
+    log_info("MSP: 0x%X", msp);
+    bsp_delay_ms(50);
+    exit(0);
+}
+
+void boot_process_entry(void)
+{
+    const uint16_t timeout_ms = 2000;
+
+    boot_flash_geometry_init();
+
+    log_info("Bootloader: Press 'w' within %d seconds to enter command line.", timeout_ms / 1000);
+
+    if (!boot_check_enter_cmd(timeout_ms)) {
+        if (boot_ota_should_upgrade()) {
+            boot_set_flag(BOOT_FLAG_EXT_LOAD);
+            boot_ext_flash_ota_init();
+        } else {
+            log_info("Bootloader: Jump to APP...");
+            boot_jump_to_app(BOOT_FLASH_APP_START_ADDR);
+        }
+    }
+
+    log_info("Bootloader: Enter command line.");
+}
+
+void boot_system_reset(void)
+{
+    bsp_delay_ms(200);
+    exit(0);
+}
+
+void boot_set_flag(boot_flag_t flag)
+{
+    g_boot_ctx.flag |= flag;
+}
+
+void boot_clear_flag(boot_flag_t flag)
+{
+    g_boot_ctx.flag &= ~flag;
+}
+
+bool boot_has_flag(boot_flag_t flag)
+{
+    return (g_boot_ctx.flag & flag) != 0;
+}
+
+uint32_t boot_get_flag(void)
+{
+    return g_boot_ctx.flag;
+}
+
+uint8_t* boot_get_update_chunk(uint32_t chunk_idx)
+{
+    return g_boot_ctx.update_chunk[chunk_idx % BOOT_APP_UPDATE_CHUNK_NUM];
+}
+
+/* ------------------------------------ 主循环 ------------------------------------ */
+
+int main(int argc, char **argv)
+{
+    uint8_t *rx_data = NULL;
+    uint32_t rx_len = 0;
+    int opt;
+
+    clock_gettime(CLOCK_MONOTONIC, &host_t0);
+
+    while ((opt = getopt(argc, argv, "d:t:cl:F:")) != -1) {
+        switch (opt) {
+        case 'd': host_state_dir = optarg; break;
+        case 't': host_tty_file = optarg; break;
+        case 'c': host_enter_cmd = true; break;
+        case 'l':
+            host_tx_log = fopen(optarg, "a");
+            if (!host_tx_log)
+                host_fatal(optarg);
+            break;
+        case 'F': host_flash_kb = strtoul(optarg, NULL, 0); break;
+        default:
+            fprintf(stderr, "usage: %s [-d dir] [-t tty_file] [-c] [-l tx_log] [-F flash_kb]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    signal(SIGTERM, host_on_signal);
+    signal(SIGINT, host_on_signal);
+    atexit(host_exit_report);
+
+    log_init();
+    bsp_common_init();
+
+    boot_process_entry();
+    boot_cmd_print_menu();
+
+    while (1) {
+        boot_recv_data(&rx_data, &rx_len);
+        boot_process_event(rx_data, rx_len);
+    }
+}
@@ -0,0 +1,194 @@
+#!/bin/sh
+#
+# run_tests.sh - 在主机上运行 BootLoader（boot_host_<board>），用 iap_uploader 经伪终端完成各种下载，
+# 比较 Flash 镜像文件中 APP 区 / 外部 Flash 槽位的内容与下载的固件是否一致。
+#
+# 用法：./run_tests.sh f103|f405
+# 每个用例前清空状态目录（work/<board>），用例之间不共享 Flash/EEPROM 状态，断点续传用例除外。
+#
+set -u
+
+BOARD=${1:?usage: $0 f103|f405}
+HOST=./boot_host_$BOARD
+UPLOADER=./iap_uploader
+W=work/$BOARD
+
+case $BOARD in
+f103)
+    APP_OFF=32768           # BOOT_FLASH_APP_START_ADDR - 0x08000000
+    RESET_VEC='\001\201\000\010'
+    FW_SIZE=30000
+    ;;
+f405)
+    APP_OFF=49152           # 扇区 0~2
+    RESET_VEC='\001\301\000\010'
+    FW_SIZE=200000
+    ;;
+*)
+    echo "unknown board: $BOARD" >&2
+    exit 2
+    ;;
+esac
+
+PASS=0
+FAIL=0
+HOST_PID=
+
+# 生成随机固件，向量表填入有效的 MSP 和复位向量
+make_fw() {
+    head -c "$2" /dev/urandom > "$1"
+    printf "\000\120\000\040$RESET_VEC" | dd of="$1" conv=notrunc 2>/dev/null
+}
+
+start_host() {
+    rm -f "$W/tty"
+    $HOST -c -d "$W" -t "$W/tty" -l "$W/tx.log" 2>>"$W/host.err" &
+    HOST_PID=$!
+    i=0
+    while [ ! -s "$W/tty" ]; do
+        i=$((i + 1))
+        if [ $i -gt 100 ]; then
+            echo "boot_host did not start" >&2
+            exit 2
+        fi
+        sleep 0.05
+    done
+    PORT=$(cat "$W/tty")
+}
+
+# 内部 Flash 下载完成后 BootLoader 复位（进程退出），外部 Flash 下载完成后回到菜单，结束进程
+stop_host() {
+    sleep 0.3
+    kill "$HOST_PID" 2>/dev/null
+    wait "$HOST_PID" 2>/dev/null
+    HOST_PID=
+}
+
+reset_state() {
+    rm -rf "$W"
+    mkdir -p "$W"
+}
+
+# upload <name> <uploader 参数...>：运行上位机，打印传输速率
+upload() {
+    name=$1
+    shift
+    if $UPLOADER -p "$PORT" "$@" > "$W/up.log" 2>&1; then
+        rate=$(grep 'Transfer' "$W/up.log" | sed 's/.*bytes, //')
+        printf '  %-28s %s\n' "$name" "$rate"
+        return 0
+    fi
+    printf '  %-28s FAILED\n' "$name"
+    sed 's/^/    /' "$W/up.log"
+    return 1
+}
+
+# check <name> <fw> <镜像文件> <偏移>
+check() {
+    if cmp -s -i "0:$4" -n "$(stat -c %s "$2")" "$2" "$W/$3"; then
+        PASS=$((PASS + 1))
+    else
+        echo "  $1: Flash content differs from firmware" >&2
+        FAIL=$((FAIL + 1))
+    fi
+}
+
+fail() {
+    echo "  $1: $2" >&2
+    FAIL=$((FAIL + 1))
+}
+
+# 单次下载到内部 Flash：run_int <name> <fw> <uploader 参数...>
+run_int() {
+    name=$1
+    fw=$2
+    shift 2
+    start_host
+    if upload "$name" "$@" "$fw"; then
+        stop_host
+        check "$name" "$fw" flash.bin $APP_OFF
+    else
+        stop_host
+        fail "$name" "upload failed"
+    fi
+}
+
+# 单次下载到外部 Flash 槽位：run_ext <name> <fw> <slot> <uploader 参数...>
+run_ext() {
+    name=$1
+    fw=$2
+    slot=$3
+    shift 3
+    start_host
+    if upload "$name" -s "$slot" "$@" "$fw"; then
+        stop_host
+        check "$name" "$fw" ext_flash.bin $((slot * 1048576))
+    else
+        stop_host
+        fail "$name" "upload failed"
+    fi
+}
+
+echo "== $BOARD =="
+reset_state
+FW=work/fw_$BOARD.bin
+FW2=work/fw2_$BOARD.bin
+make_fw "$FW" $FW_SIZE
+make_fw "$FW2" $((FW_SIZE / 2 + 333))
+
+run_int "xmodem1k internal" "$FW" -m xmodem1k
+reset_state
+run_int "ymodem internal" "$FW" -m ymodem
+reset_state
+run_ext "ymodem external slot 1" "$FW" 1 -m ymodem
+reset_state
+run_int "stream internal" "$FW" -m stream
+reset_state
+run_ext "stream external slot 2" "$FW" 2 -m stream
+reset_state
+run_int "xmodem1k internal 460800" "$FW" -m xmodem1k -B 460800
+reset_state
+run_int "stream internal 921600" "$FW" -m stream -B 921600
+
+# 增量更新：在上一个固件之上只修改几个块
+cp "$FW" "$W/delta.bin"
+printf 'delta' | dd of="$W/delta.bin" bs=1 seek=5000 conv=notrunc 2>/dev/null
+printf 'delta' | dd of="$W/delta.bin" bs=1 seek=$((FW_SIZE - 10)) conv=notrunc 2>/dev/null
+run_int "delta internal" "$W/delta.bin" -m delta
+
+# ymodem 一次下载两个文件到连续的槽位
+reset_state
+start_host
+if upload "ymodem external slots 3,4" -m ymodem -s 3 "$FW" "$FW2"; then
+    stop_host
+    check "ymodem slot 3" "$FW" ext_flash.bin $((3 * 1048576))
+    check "ymodem slot 4" "$FW2" ext_flash.bin $((4 * 1048576))
+else
+    stop_host
+    fail "ymodem external slots 3,4" "upload failed"
+fi
+
+# 断点续传：传输中途结束 BootLoader 进程（相当于掉电），重新启动后从断点继续
+reset_state
+start_host
+$UPLOADER -p "$PORT" -m stream "$FW" > "$W/up.log" 2>&1 &
+UP_PID=$!
+sleep "$(awk "BEGIN { print $FW_SIZE / 22000 }")"     # 约传输到一半
+kill -9 "$HOST_PID" 2>/dev/null
+wait "$HOST_PID" 2>/dev/null
+wait "$UP_PID" 2>/dev/null
+start_host
+if upload "stream resume" -m stream -r "$FW"; then
+    stop_host
+    if grep -q 'resume from block' "$W/up.log"; then
+        check "stream resume" "$FW" flash.bin $APP_OFF
+    else
+        fail "stream resume" "target did not resume"
+    fi
+else
+    stop_host
+    fail "stream resume" "upload failed"
+fi
+
+echo "  $PASS passed, $FAIL failed"
+[ $FAIL -eq 0 ]